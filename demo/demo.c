@@ -321,7 +321,8 @@ static int demo_init(anjay_demo_t *demo,
             || install_object(demo,
                               firmware_update_object_create(
                                       demo->iosched,
-                                      cmdline_args->fw_updated_marker_path),
+                                      cmdline_args->fw_updated_marker_path,
+                                      cmdline_args->fw_download_state_path),
                               NULL, firmware_update_object_release)
             || install_object(demo, geopoints_object_create(demo),
                               geopoints_notify_time_dependent,
@@ -343,6 +344,9 @@ static int demo_init(anjay_demo_t *demo,
 
     demo_reload_servers(demo);
 
+    firmware_update_resume_download(
+            demo->anjay, demo_find_object(demo, DEMO_OID_FIRMWARE_UPDATE));
+
     if (add_default_access_entries(demo)
             || add_access_entries(demo, cmdline_args)) {
         return -1;
@@ -468,7 +472,11 @@ static void serve(anjay_demo_t *demo) {
         // sub-millisecond delays
         iosched_run(demo->iosched, waitms + 1);
 
-        if (anjay_sched_run(demo->anjay)) {
+        // a bounded run keeps incoming packets from waiting behind a large
+        // backlog of jobs; any jobs left are run in the next iteration
+        if (anjay_sched_run_bounded(
+                    demo->anjay, 0,
+                    avs_time_duration_from_scalar(50, AVS_TIME_MS)) < 0) {
             demo->running = false;
         }
     }
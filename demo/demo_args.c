@@ -43,6 +43,7 @@ static const cmdline_args_t DEFAULT_CMDLINE_ARGS = {
     .outbuf_size = 4000,
     .msg_cache_size = 0,
     .fw_updated_marker_path = "/tmp/anjay-fw-updated",
+    .fw_download_state_path = "/tmp/anjay-fw-download-state",
 };
 
 static int parse_security_mode(const char *mode_string,
@@ -157,6 +158,9 @@ static void print_option_help(const struct option *opt) {
           "Send notifications as Confirmable messages by default" },
         { 1, "PATH", DEFAULT_CMDLINE_ARGS.fw_updated_marker_path,
           "File path to use as a marker for persisting firmware update state" },
+        { 2, "PATH", DEFAULT_CMDLINE_ARGS.fw_download_state_path,
+          "File path used to persist progress of firmware downloads, so that "
+          "they can be resumed after restart" },
     };
 
     int description_offset = 25;
@@ -342,6 +346,7 @@ int demo_parse_argv(cmdline_args_t *parsed_args, int argc, char *argv[]) {
         { "cache-size",                 required_argument, 0, '$' },
         { "confirmable-notifications",  no_argument,       0, 'N' },
         { "fw-updated-marker-path",     required_argument, 0, 1 },
+        { "fw-download-state-path",     required_argument, 0, 2 },
         { 0, 0, 0, 0 }
     };
     int num_servers = 0;
@@ -518,6 +523,9 @@ int demo_parse_argv(cmdline_args_t *parsed_args, int argc, char *argv[]) {
         case 1:
             parsed_args->fw_updated_marker_path = optarg;
             break;
+        case 2:
+            parsed_args->fw_download_state_path = optarg;
+            break;
         case 0:
             goto finish;
         }
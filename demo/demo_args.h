@@ -40,6 +40,7 @@ typedef struct cmdline_args {
     int32_t msg_cache_size;
     bool confirmable_notifications;
     const char *fw_updated_marker_path;
+    const char *fw_download_state_path;
 } cmdline_args_t;
 
 int demo_parse_argv(cmdline_args_t *parsed_args, int argc, char **argv);
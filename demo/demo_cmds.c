@@ -19,10 +19,12 @@
 #include "demo_utils.h"
 
 #include <ctype.h>
+#include <inttypes.h>
 #include <string.h>
 
 #include <anjay/attr_storage.h>
 #include <anjay/security.h>
+#include <anjay/stats.h>
 
 static int parse_ssid(const char *text,
                       anjay_ssid_t *out_ssid) {
@@ -189,6 +191,35 @@ static void cmd_get_port(anjay_demo_t *demo, const char *args_string) {
     printf("PORT==%s\n", port);
 }
 
+static void cmd_server_stats(anjay_demo_t *demo, const char *args_string) {
+    anjay_ssid_t ssid;
+    if (parse_ssid(args_string, &ssid)) {
+        return;
+    }
+
+    anjay_traffic_stats_t stats;
+    if (anjay_get_server_stats(demo->anjay, ssid, &stats)) {
+        demo_log(ERROR, "no active server with SSID %u", ssid);
+        return;
+    }
+    int64_t last_rtt_ms = 0;
+    int64_t smoothed_rtt_ms = 0;
+    avs_time_duration_to_scalar(&last_rtt_ms, AVS_TIME_MS, stats.last_rtt);
+    avs_time_duration_to_scalar(&smoothed_rtt_ms, AVS_TIME_MS,
+                                stats.smoothed_rtt);
+    printf("TX_BYTES==%" PRIu64 "\n"
+           "RX_BYTES==%" PRIu64 "\n"
+           "INCOMING_RETRANSMISSIONS==%" PRIu64 "\n"
+           "OUTGOING_RETRANSMISSIONS==%" PRIu64 "\n"
+           "RTT_SAMPLES==%" PRIu64 "\n"
+           "LAST_RTT_MS==%" PRId64 "\n"
+           "SMOOTHED_RTT_MS==%" PRId64 "\n",
+           stats.tx_bytes, stats.rx_bytes,
+           stats.num_incoming_retransmissions,
+           stats.num_outgoing_retransmissions,
+           stats.num_rtt_samples, last_rtt_ms, smoothed_rtt_ms);
+}
+
 static void cmd_enter_offline(anjay_demo_t *demo, const char *args_string) {
     (void) args_string;
     int result = anjay_enter_offline(demo->anjay);
@@ -394,6 +425,9 @@ static const struct cmd_handler_def COMMAND_HANDLERS[] = {
     CMD_HANDLER("get-port", "index", cmd_get_port,
                 "Display listening port number of a server socket with the "
                 "specified index (also supports Python-like negative indices)"),
+    CMD_HANDLER("server-stats", "ssid", cmd_server_stats,
+                "Display traffic counters of the connection to a LwM2M Server "
+                "with the specified Short Server ID"),
     CMD_HANDLER("enter-offline", "", cmd_enter_offline, "Enters Offline mode"),
     CMD_HANDLER("exit-offline", "", cmd_exit_offline, "Exits Offline mode"),
     CMD_HANDLER("notify", "", cmd_notify,
@@ -52,9 +52,13 @@ void device_object_release(const anjay_dm_object_def_t **def);
 
 const anjay_dm_object_def_t **
 firmware_update_object_create(iosched_t *iosched,
-                              const char *fw_updated_marker_path);
+                              const char *fw_updated_marker_path,
+                              const char *fw_download_state_path);
 void firmware_update_object_release(const anjay_dm_object_def_t **def);
 
+void firmware_update_resume_download(anjay_t *anjay,
+                                     const anjay_dm_object_def_t **fw_obj);
+
 void firmware_update_set_package_path(anjay_t *anjay,
                                       const anjay_dm_object_def_t **fw_obj,
                                       const char *path);
@@ -15,12 +15,12 @@
  */
 
 #include <assert.h>
-#include <inttypes.h>
-#include <string.h>
 
 #include "../objects.h"
 #include "../demo_utils.h"
 
+#include <anjay/stats.h>
+
 typedef enum {
     CS_SMS_TX_COUNTER       = 0,
     CS_SMS_RX_COUNTER       = 1,
@@ -46,55 +46,9 @@ static conn_stats_repr_t *get_cs(const anjay_dm_object_def_t *const *obj_ptr) {
     return container_of(obj_ptr, conn_stats_repr_t, def);
 }
 
-static int read_uint64_from_file(uint64_t *number, const char *filename) {
-    int result = 0;
-    FILE *rx_bytes_file = fopen(filename, "r");
-
-    if (!rx_bytes_file) {
-        return -1;
-    }
-    if (fscanf(rx_bytes_file, "%" SCNu64, number) != 1) {
-        result = -1;
-    }
-    fclose(rx_bytes_file);
-
-    return result;
-}
-
-static int ifname_for_first_socket(anjay_t *anjay,
-                                   avs_net_socket_interface_name_t *if_name) {
-    avs_net_abstract_socket_t *const *first = anjay_get_sockets(anjay);
-    if (!first) {
-        return -1;
-    }
-    return avs_net_socket_interface_name(*first, if_name);
-}
-
-static const char* RX_STATS = "rx_bytes";
-static const char* TX_STATS = "tx_bytes";
-
-static int stats_getter(avs_net_socket_interface_name_t *if_name,
-                        uint64_t *bytes,
-                        const char* stats) {
-    char file_name[128];
-    sprintf(file_name, "/sys/class/net/%s/statistics/%s", *if_name, stats);
-    return read_uint64_from_file(bytes, file_name);
-}
-
-static uint64_t first_socket_stats(anjay_t *anjay, const char* stats) {
-    avs_net_socket_interface_name_t if_name;
-    memset(&if_name, 0, sizeof(if_name));
-    if (ifname_for_first_socket(anjay, &if_name)) {
-        return 0;
-    }
-    uint64_t value = 0;
-    stats_getter(&if_name, &value, stats);
-    return value;
-}
-
 static uint64_t get_rx_stats(anjay_t *anjay, conn_stats_repr_t *repr) {
     if (repr->is_collecting) {
-        return first_socket_stats(anjay, RX_STATS) - repr->last_rx_bytes;
+        return anjay_get_rx_bytes(anjay) - repr->last_rx_bytes;
     } else {
         return repr->last_rx_bytes;
     }
@@ -102,7 +56,7 @@ static uint64_t get_rx_stats(anjay_t *anjay, conn_stats_repr_t *repr) {
 
 static uint64_t get_tx_stats(anjay_t *anjay, conn_stats_repr_t *repr) {
     if (repr->is_collecting) {
-        return first_socket_stats(anjay, TX_STATS) - repr->last_tx_bytes;
+        return anjay_get_tx_bytes(anjay) - repr->last_tx_bytes;
     } else {
         return repr->last_tx_bytes;
     }
@@ -128,8 +82,8 @@ static int cs_resource_execute(anjay_t *anjay,
     case CS_COLLECTION_DURATION:
         return ANJAY_ERR_METHOD_NOT_ALLOWED;
     case CS_START:
-        repr->last_tx_bytes = first_socket_stats(anjay, TX_STATS);
-        repr->last_rx_bytes = first_socket_stats(anjay, RX_STATS);
+        repr->last_tx_bytes = anjay_get_tx_bytes(anjay);
+        repr->last_rx_bytes = anjay_get_rx_bytes(anjay);
         repr->is_collecting = true;
         break;
     case CS_STOP:
@@ -137,9 +91,9 @@ static int cs_resource_execute(anjay_t *anjay,
             return ANJAY_ERR_BAD_REQUEST;
         }
         repr->last_tx_bytes =
-            first_socket_stats(anjay, TX_STATS) - repr->last_tx_bytes;
+            anjay_get_tx_bytes(anjay) - repr->last_tx_bytes;
         repr->last_rx_bytes =
-            first_socket_stats(anjay, RX_STATS) - repr->last_rx_bytes;
+            anjay_get_rx_bytes(anjay) - repr->last_rx_bytes;
         repr->is_collecting = false;
         break;
     default:
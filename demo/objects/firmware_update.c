@@ -14,7 +14,12 @@
  * limitations under the License.
  */
 
+#if !defined(_POSIX_C_SOURCE) && !defined(__APPLE__)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
 #include <assert.h>
+#include <inttypes.h>
 #include <stdio.h>
 #include <string.h>
 #include <strings.h>
@@ -69,6 +74,17 @@ typedef struct firmware_metadata {
 #define FORCE_ERROR_OUT_OF_MEMORY 1
 #define FORCE_ERROR_FAILED_UPDATE 2
 
+/**
+ * Progress of a pull-mode download, persisted after each received block so
+ * that the transfer may be resumed after connection loss or demo restart.
+ */
+typedef struct {
+    char package_uri[256];
+    char target_path[256];
+    anjay_etag_t etag;
+    uint64_t bytes_written;
+} fw_download_state_t;
+
 typedef struct fw_repr {
     const anjay_dm_object_def_t *def;
     iosched_t *iosched;
@@ -80,6 +96,9 @@ typedef struct fw_repr {
 
     char next_target_path[256];
     const char *fw_updated_marker;
+
+    const char *download_state_path;
+    fw_download_state_t download_state;
 } fw_repr_t;
 
 static inline fw_repr_t *get_fw(const anjay_dm_object_def_t *const *obj_ptr) {
@@ -143,10 +162,104 @@ static void maybe_delete_firmware_file(fw_repr_t *fw) {
     }
 }
 
+static bool is_resumable_protocol(const char *protocol) {
+    // HTTP downloader does not support start_offset
+    return !strncasecmp(protocol, "coap://", 7)
+           || !strncasecmp(protocol, "coaps://", 8);
+}
+
+static int save_download_state(const fw_repr_t *fw) {
+    char tmp_path[PATH_MAX];
+    ssize_t result = snprintf(tmp_path, sizeof(tmp_path), "%s.tmp",
+                              fw->download_state_path);
+    if (result < 0 || result >= (ssize_t) sizeof(tmp_path)) {
+        return -1;
+    }
+
+    FILE *f = fopen(tmp_path, "wb");
+    if (!f) {
+        demo_log(ERROR, "could not open %s", tmp_path);
+        return -1;
+    }
+    result = (fwrite(&fw->download_state, sizeof(fw->download_state), 1, f)
+              == 1) ? 0 : -1;
+    if (fclose(f)) {
+        result = -1;
+    }
+    // rename() is atomic, so a crash never leaves a torn state file behind
+    if (result || rename(tmp_path, fw->download_state_path)) {
+        demo_log(ERROR, "could not save download state to %s",
+                 fw->download_state_path);
+        unlink(tmp_path);
+        return -1;
+    }
+    return 0;
+}
+
+static int load_download_state(fw_repr_t *fw) {
+    FILE *f = fopen(fw->download_state_path, "rb");
+    if (!f) {
+        return -1;
+    }
+
+    fw_download_state_t state;
+    int result = (fread(&state, sizeof(state), 1, f) == 1) ? 0 : -1;
+    fclose(f);
+
+    if (result
+            || !memchr(state.package_uri, '\0', sizeof(state.package_uri))
+            || !memchr(state.target_path, '\0', sizeof(state.target_path))
+            || state.etag.size > sizeof(state.etag.value)) {
+        demo_log(WARNING, "ignoring invalid download state file %s",
+                 fw->download_state_path);
+        return -1;
+    }
+
+    fw->download_state = state;
+    return 0;
+}
+
+static void reset_download_state(fw_repr_t *fw) {
+    memset(&fw->download_state, 0, sizeof(fw->download_state));
+    unlink(fw->download_state_path);
+}
+
+/**
+ * Checks whether the persisted download state refers to @p fw->package_uri
+ * and the partially downloaded file is still there. If so, the file is
+ * truncated to the last persisted offset and becomes the download target.
+ */
+static bool restore_partial_download(fw_repr_t *fw) {
+    const fw_download_state_t *state = &fw->download_state;
+    if (!state->bytes_written
+            || !state->etag.size
+            || strcmp(state->package_uri, fw->package_uri)
+            || !is_resumable_protocol(fw->package_uri)) {
+        return false;
+    }
+
+    struct stat st;
+    if (stat(state->target_path, &st)
+            || (uint64_t) st.st_size < state->bytes_written
+            || truncate(state->target_path, (off_t) state->bytes_written)) {
+        demo_log(WARNING, "partial download %s unusable, starting over",
+                 state->target_path);
+        return false;
+    }
+
+    if (strcmp(fw->next_target_path, state->target_path)) {
+        maybe_delete_firmware_file(fw);
+        snprintf(fw->next_target_path, sizeof(fw->next_target_path), "%s",
+                 state->target_path);
+    }
+    return true;
+}
+
 static void reset(anjay_t *anjay,
                   fw_repr_t *fw) {
     set_state(anjay, fw, UPDATE_STATE_IDLE);
     set_update_result(anjay, fw, UPDATE_RESULT_INITIAL);
+    reset_download_state(fw);
     demo_log(INFO, "Firmware Object state reset");
 }
 
@@ -479,6 +592,7 @@ static void preprocess_firmware(anjay_t *anjay,
 typedef struct {
     FILE *file;
     fw_repr_t *fw;
+    bool persist;
 } download_args_t;
 
 static int download_write_block(anjay_t *anjay,
@@ -487,39 +601,74 @@ static int download_write_block(anjay_t *anjay,
                                 const anjay_etag_t *etag,
                                 void *args_) {
     (void) anjay;
-    (void) etag;
 
     download_args_t *args = (download_args_t *) args_;
-    if (fwrite(data, data_size, 1, args->file) != 1) {
+    if (fwrite(data, data_size, 1, args->file) != 1
+            || fflush(args->file)) {
         demo_log(ERROR, "could not write firmware");
         return -1;
     }
 
+    if (args->persist) {
+        fw_download_state_t *state = &args->fw->download_state;
+        if (etag) {
+            state->etag = *etag;
+        }
+        state->bytes_written += data_size;
+        // not fatal: the download itself may still succeed
+        save_download_state(args->fw);
+    }
     return 0;
 }
 
+static int schedule_background_anjay_download(anjay_t *anjay,
+                                              fw_repr_t *fw,
+                                              bool resume);
+
 static void download_finished(anjay_t *anjay,
                               int result,
                               void *args_) {
-    (void) anjay;
-
     download_args_t *args = (download_args_t *) args_;
+    fw_repr_t *fw = args->fw;
+    bool keep_partial_data = ((result == ANJAY_DOWNLOAD_ERR_FAILED
+                                   || result == ANJAY_DOWNLOAD_ERR_ABORTED)
+                              && args->persist
+                              && fw->download_state.bytes_written > 0);
     fclose(args->file);
+    free(args);
 
     if (!result) {
-        preprocess_firmware(anjay, args->fw);
+        reset_download_state(fw);
+        preprocess_firmware(anjay, fw);
+    } else if (result == ANJAY_DOWNLOAD_ERR_EXPIRED) {
+        // package changed on the server, the data we have is useless
+        demo_log(WARNING, "remote firmware package changed, restarting "
+                 "download from scratch");
+        reset_download_state(fw);
+        if (schedule_background_anjay_download(anjay, fw, false)) {
+            set_state(anjay, fw, UPDATE_STATE_IDLE);
+            maybe_delete_firmware_file(fw);
+        }
+    } else if (keep_partial_data) {
+        // connection lost or client shutting down; partial data is retained,
+        // so that writing the same Package URI again (or restarting the
+        // client) resumes the transfer
+        set_state(anjay, fw, UPDATE_STATE_IDLE);
+        set_update_result(anjay, fw, UPDATE_RESULT_CONNECTION_LOST);
+        demo_log(ERROR, "download interrupted after %" PRIu64 " B",
+                 fw->download_state.bytes_written);
     } else {
-        set_state(anjay, args->fw, UPDATE_STATE_IDLE);
-        set_update_result(anjay, args->fw, UPDATE_RESULT_INVALID_URI);
-        maybe_delete_firmware_file(args->fw);
+        set_state(anjay, fw, UPDATE_STATE_IDLE);
+        set_update_result(anjay, fw, UPDATE_RESULT_INVALID_URI);
+        reset_download_state(fw);
+        maybe_delete_firmware_file(fw);
         demo_log(ERROR, "download failed: result = %d", result);
     }
-
-    free(args);
 }
 
 static int schedule_background_anjay_download(anjay_t *anjay,
-                                              fw_repr_t *fw) {
+                                              fw_repr_t *fw,
+                                              bool resume) {
     download_args_t *args = (download_args_t *)
             calloc(1, sizeof(download_args_t));
     if (!args) {
@@ -527,7 +676,8 @@ static int schedule_background_anjay_download(anjay_t *anjay,
     }
 
     args->fw = fw;
-    args->file = fopen(fw->next_target_path, "wb");
+    args->persist = is_resumable_protocol(fw->package_uri);
+    args->file = fopen(fw->next_target_path, resume ? "ab" : "wb");
     if (!args->file) {
         goto error;
     }
@@ -539,6 +689,19 @@ static int schedule_background_anjay_download(anjay_t *anjay,
         .user_data = args
     };
 
+    if (resume) {
+        cfg.start_offset = (size_t) fw->download_state.bytes_written;
+        cfg.etag = fw->download_state.etag;
+    } else if (args->persist) {
+        memset(&fw->download_state, 0, sizeof(fw->download_state));
+        snprintf(fw->download_state.package_uri,
+                 sizeof(fw->download_state.package_uri), "%s",
+                 fw->package_uri);
+        snprintf(fw->download_state.target_path,
+                 sizeof(fw->download_state.target_path), "%s",
+                 fw->next_target_path);
+    }
+
     anjay_download_handle_t handle = anjay_download(anjay, &cfg);
     if (!handle) {
         goto error;
@@ -546,14 +709,20 @@ static int schedule_background_anjay_download(anjay_t *anjay,
 
     set_update_result(anjay, fw, UPDATE_RESULT_INITIAL);
     set_state(anjay, fw, UPDATE_STATE_DOWNLOADING);
-    demo_log(INFO, "download started: %s -> %s",
-             fw->package_uri, fw->next_target_path);
+    if (resume) {
+        demo_log(INFO, "download resumed at %zu B: %s -> %s",
+                 cfg.start_offset, fw->package_uri, fw->next_target_path);
+    } else {
+        demo_log(INFO, "download started: %s -> %s",
+                 fw->package_uri, fw->next_target_path);
+    }
     return 0;
 
 error:
     set_update_result(anjay, fw, UPDATE_RESULT_FAILED);
     if (args && args->file) {
         fclose(args->file);
+        reset_download_state(fw);
         maybe_delete_firmware_file(fw);
     }
     free(args);
@@ -563,11 +732,15 @@ error:
 static int
 schedule_download_in_background(anjay_t *anjay,
                                 fw_repr_t *fw) {
-    if (maybe_create_firmware_file(fw)) {
-        return -1;
+    bool resume = restore_partial_download(fw);
+    if (!resume) {
+        reset_download_state(fw);
+        if (maybe_create_firmware_file(fw)) {
+            return -1;
+        }
     }
 
-    if (schedule_background_anjay_download(anjay, fw)) {
+    if (schedule_background_anjay_download(anjay, fw, resume)) {
         maybe_delete_firmware_file(fw);
         return -1;
     }
@@ -872,13 +1045,15 @@ determine_update_result(const char *fw_updated_marker) {
 
 const anjay_dm_object_def_t **
 firmware_update_object_create(iosched_t *iosched,
-                              const char *fw_updated_marker_path) {
+                              const char *fw_updated_marker_path,
+                              const char *fw_download_state_path) {
     fw_repr_t *repr = (fw_repr_t*)calloc(1, sizeof(fw_repr_t));
     if (!repr) {
         return NULL;
     }
 
     repr->fw_updated_marker = fw_updated_marker_path;
+    repr->download_state_path = fw_download_state_path;
     repr->def = &FIRMWARE_UPDATE;
     repr->iosched = iosched;
     repr->result = determine_update_result(repr->fw_updated_marker);
@@ -886,15 +1061,38 @@ firmware_update_object_create(iosched_t *iosched,
 
     if (repr->result == UPDATE_RESULT_SUCCESS) {
         cleanup_after_upgrade(repr->fw_updated_marker);
+        reset_download_state(repr);
+    } else {
+        load_download_state(repr);
     }
 
     return &repr->def;
 }
 
+void firmware_update_resume_download(anjay_t *anjay,
+                                     const anjay_dm_object_def_t **fw_obj) {
+    fw_repr_t *fw = get_fw(fw_obj);
+    if (!fw->download_state.package_uri[0]
+            || fw->state != UPDATE_STATE_IDLE) {
+        return;
+    }
+
+    snprintf(fw->package_uri, sizeof(fw->package_uri), "%s",
+             fw->download_state.package_uri);
+    demo_log(INFO, "resuming interrupted download of %s", fw->package_uri);
+    if (schedule_download_in_background(anjay, fw)) {
+        demo_log(ERROR, "could not resume download of %s", fw->package_uri);
+        fw->package_uri[0] = '\0';
+    }
+}
+
 void firmware_update_object_release(const anjay_dm_object_def_t **def) {
     if (def) {
         fw_repr_t *fw = get_fw(def);
-        maybe_delete_firmware_file(fw);
+        if (!fw->download_state.bytes_written) {
+            // otherwise, keep the partial download for resumption on restart
+            maybe_delete_firmware_file(fw);
+        }
         free(fw);
     }
 }
@@ -21,7 +21,7 @@
 
 VISIBILITY_PRIVATE_HEADER_BEGIN
 
-#if defined(WITH_CON_ATTR) // || defined(...)
+#if defined(WITH_CON_ATTR) || defined(WITH_EVAL_PERIOD_ATTRS)
 #define WITH_CUSTOM_ATTRIBUTES
 #endif
 
@@ -36,12 +36,20 @@ typedef struct {
 #ifdef WITH_CON_ATTR
     anjay_dm_con_attr_t con;
 #endif
+#ifdef WITH_EVAL_PERIOD_ATTRS
+    time_t min_eval_period;
+    time_t max_eval_period;
+#endif
 } anjay_dm_custom_attrs_t;
 
 typedef struct {
 #ifdef WITH_CON_ATTR
     bool has_con;
 #endif
+#ifdef WITH_EVAL_PERIOD_ATTRS
+    bool has_min_eval_period;
+    bool has_max_eval_period;
+#endif
 } anjay_dm_custom_request_attribute_flags_t;
 
 /*
@@ -191,10 +199,19 @@ _anjay_dm_get_internal_res_attrs_const(
 #define _ANJAY_DM_CUSTOM_CON_ATTR_INITIALIZER
 #endif // WITH_CON_ATTR
 
+#ifdef WITH_EVAL_PERIOD_ATTRS
+#define _ANJAY_DM_CUSTOM_EVAL_PERIOD_ATTRS_INITIALIZER \
+    .min_eval_period = ANJAY_ATTRIB_PERIOD_NONE, \
+    .max_eval_period = ANJAY_ATTRIB_PERIOD_NONE,
+#else // WITH_EVAL_PERIOD_ATTRS
+#define _ANJAY_DM_CUSTOM_EVAL_PERIOD_ATTRS_INITIALIZER
+#endif // WITH_EVAL_PERIOD_ATTRS
+
 #define _ANJAY_DM_CUSTOM_ATTRS_INITIALIZER \
     .custom = { \
         .data = { \
             _ANJAY_DM_CUSTOM_CON_ATTR_INITIALIZER \
+            _ANJAY_DM_CUSTOM_EVAL_PERIOD_ATTRS_INITIALIZER \
         } \
     },
 
@@ -25,6 +25,27 @@ VISIBILITY_PRIVATE_HEADER_BEGIN
 
 typedef void anjay_dm_module_deleter_t(anjay_t *anjay, void *arg);
 
+/**
+ * Describes which data model changes a module's <c>notify_callback</c> is
+ * interested in. A zero-initialized structure means all changes.
+ */
+typedef struct {
+    /**
+     * Array of Object IDs, sorted in ascending order, that the module shall be
+     * notified about; NULL if it shall be notified about all Objects.
+     */
+    const anjay_oid_t *oids;
+
+    /** Number of elements in <c>oids</c>. */
+    size_t num_oids;
+
+    /**
+     * If true, only the Objects whose sets of Instances changed are of
+     * interest; changes of Resource values alone are not passed to the module.
+     */
+    bool instance_set_changes_only;
+} anjay_notify_interest_t;
+
 typedef struct {
     /**
      * Global overlay of handlers that may replace handlers natively declared
@@ -63,6 +84,13 @@ typedef struct {
      */
     anjay_notify_callback_t *notify_callback;
 
+    /**
+     * Subset of data model changes that <c>notify_callback</c> is called for.
+     * The callback is not called at all if the notification queue contains no
+     * matching Objects, and otherwise receives only the matching entries.
+     */
+    anjay_notify_interest_t notify_interest;
+
     /**
      * A function to be called when the module is uninstalled, that will clean
      * up any resources used by it.
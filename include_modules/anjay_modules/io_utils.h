@@ -30,6 +30,15 @@ uint64_t _anjay_htond(double d);
 float _anjay_ntohf(uint32_t v);
 double _anjay_ntohd(uint64_t v);
 
+/**
+ * Checks whether there is no more data to read from @p in .
+ *
+ * @returns 1 if the stream is at the end of the message, 0 if there is data
+ *          ahead (nothing is consumed in that case), or a negative value in
+ *          case of error.
+ */
+int _anjay_stream_at_end(avs_stream_abstract_t *in);
+
 typedef int anjay_input_ctx_constructor_t(anjay_input_ctx_t **out,
                                           avs_stream_abstract_t **stream_ptr,
                                           bool autoclose);
@@ -38,6 +47,16 @@ anjay_input_ctx_constructor_t _anjay_input_tlv_create;
 
 int _anjay_input_ctx_destroy(anjay_input_ctx_t **ctx_ptr);
 
+/**
+ * Determines the number of bytes of the current entry's value that have not
+ * been read yet. Supported only by input contexts that know the length of
+ * values in advance (i.e. TLV).
+ *
+ * @returns 0 on success, negative value if the length is not known or could
+ *          not be determined.
+ */
+int _anjay_input_remaining_length(anjay_input_ctx_t *ctx, size_t *out_length);
+
 VISIBILITY_PRIVATE_HEADER_END
 
 #endif /* ANJAY_INCLUDE_ANJAY_MODULES_IO_UTILS_H */
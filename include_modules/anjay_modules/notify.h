@@ -27,7 +27,9 @@ VISIBILITY_PRIVATE_HEADER_BEGIN
 
 typedef struct {
     bool instance_set_changed;
-    // NOTE: known_{added,removed}_iids lists may not be exhaustive
+    // NOTE: known_{added,removed}_iids lists are exhaustive unless
+    // unknown_change is set
+    bool unknown_change;
     AVS_LIST(anjay_iid_t) known_added_iids;
     AVS_LIST(anjay_iid_t) known_removed_iids;
 } anjay_notify_queue_instance_entry_t;
@@ -84,6 +86,14 @@ int _anjay_notify_queue_resource_change(anjay_notify_queue_t *out_queue,
                                         anjay_iid_t iid,
                                         anjay_rid_t rid);
 
+/**
+ * Adds all the changes recorded in <c>*src_queue_ptr</c> to <c>out_queue</c>
+ * and clears <c>*src_queue_ptr</c> afterwards (regardless of success or
+ * failure).
+ */
+int _anjay_notify_queue_merge(anjay_notify_queue_t *out_queue,
+                              anjay_notify_queue_t *src_queue_ptr);
+
 void _anjay_notify_clear_queue(anjay_notify_queue_t *out_queue);
 
 int _anjay_notify_instance_created(anjay_t *anjay,
@@ -72,6 +72,69 @@ void anjay_smsdrv_cleanup(anjay_smsdrv_t **smsdrv_ptr);
         /* .max_retransmit = */ 0          \
     }
 
+/** Randomization strategies for retry delays of LwM2M server jobs. */
+typedef enum {
+    /**
+     * Each delay is drawn uniformly from
+     * <c>[(1 - jitter_fraction) * d, d]</c>, where <c>d</c> is the nominal
+     * delay, growing exponentially from <c>initial_delay</c> up to
+     * <c>max_delay</c>. Setting <c>jitter_fraction</c> to 1.0 results in the
+     * "full jitter" strategy, and setting it to 0.0 disables randomization.
+     */
+    ANJAY_BACKOFF_JITTER_PROPORTIONAL,
+
+    /**
+     * "Decorrelated jitter": each delay is drawn uniformly from
+     * <c>[initial_delay, multiplier * previous_delay]</c> and capped at
+     * <c>max_delay</c>. <c>jitter_fraction</c> is ignored.
+     */
+    ANJAY_BACKOFF_JITTER_DECORRELATED
+} anjay_backoff_jitter_t;
+
+/**
+ * Retry policy for Register, Update and server reactivation attempts.
+ */
+typedef struct {
+    /** Delay between the first failed attempt and the first retry. */
+    avs_time_duration_t initial_delay;
+
+    /** Upper bound for the delay between consecutive attempts. */
+    avs_time_duration_t max_delay;
+
+    /** Factor by which the delay grows after each failed attempt. Must be at
+     * least 1.0. */
+    double multiplier;
+
+    /** Fraction of each delay that is randomized, in range [0.0, 1.0]. Only
+     * used by @ref ANJAY_BACKOFF_JITTER_PROPORTIONAL . */
+    double jitter_fraction;
+
+    /** Randomization strategy. */
+    anjay_backoff_jitter_t jitter;
+
+    /**
+     * Upper bound for a random delay, chosen separately for each server, after
+     * which the connection to that server is re-established when leaving the
+     * offline mode (see @ref anjay_exit_offline). If zero or invalid, all
+     * servers are reconnected at once.
+     */
+    avs_time_duration_t reactivation_stagger;
+} anjay_server_backoff_config_t;
+
+/**
+ * Default retry policy for LwM2M server jobs: 1 second, doubled after each
+ * failure up to 120 seconds, with no randomization.
+ */
+#define ANJAY_DEFAULT_SERVER_BACKOFF                                        \
+    {                                                                       \
+        /* .initial_delay = */ { 1, 0 },                                    \
+        /* .max_delay = */ { 120, 0 },                                      \
+        /* .multiplier = */ 2.0,                                            \
+        /* .jitter_fraction = */ 0.0,                                       \
+        /* .jitter = */ ANJAY_BACKOFF_JITTER_PROPORTIONAL,                  \
+        /* .reactivation_stagger = */ { 0, 0 }                              \
+    }
+
 typedef struct anjay_configuration {
     /** Endpoint name as presented to the LwM2M server. If not set, defaults
      * to ANJAY_DEFAULT_ENDPOINT_NAME. */
@@ -169,6 +232,58 @@ typedef struct anjay_configuration {
      * to false, Concatenated SMS may be used in cases when it is impossible to
      * split the message in another way, e.g. during DTLS handshake. */
     bool prefer_multipart_sms;
+
+    /**
+     * Wake-up alignment window for queue mode connections.
+     *
+     * Whenever a suspended queue mode connection needs to be brought back
+     * online, all pending jobs that would otherwise wake up any queue mode
+     * connection no later than this amount of time from now (Registration
+     * Updates and automatic Observe notifications) are executed immediately,
+     * within the same wake-up. The connections are then suspended once after
+     * the last exchange.
+     *
+     * Notifications are never sent earlier than allowed by the "pmin"
+     * attribute. A notification brought forward that way whose "pmax" period
+     * would expire within the window is sent even if the value has not
+     * changed; notifications triggered for any other reason are not affected.
+     *
+     * If zero (the default) or invalid, no alignment is performed. See also
+     * @ref anjay_get_num_queue_mode_wakeups .
+     */
+    avs_time_duration_t queue_mode_wakeup_slack;
+
+    /**
+     * Retry policy for Register, Update and server reactivation attempts.
+     *
+     * Enabling jitter and reactivation stagger is recommended for large
+     * deployments, so that clients recovering from a server outage do not
+     * reconnect in lockstep.
+     *
+     * If NULL, @ref ANJAY_DEFAULT_SERVER_BACKOFF will be used.
+     *
+     * NOTE: Parameters are copied during @ref anjay_new() and cannot be
+     * modified later on.
+     */
+    const anjay_server_backoff_config_t *server_backoff;
+
+    /**
+     * Default interval of CoAP ping keepalives for non-queue mode UDP
+     * connections.
+     *
+     * Whenever a connection to a regular (non-bootstrap) LwM2M Server has been
+     * idle for this amount of time and no Registration Update is due earlier,
+     * an empty Confirmable message (4 bytes) is sent to the server, which is
+     * expected to respond with Reset. This keeps NAT bindings open without the
+     * need to shorten the registration lifetime. If the server does not respond
+     * after all retransmissions, the connection is reestablished and
+     * a Registration Update is sent.
+     *
+     * If zero (the default) or invalid, no keepalives are sent. May be changed
+     * later, also for each server separately, using
+     * @ref anjay_set_server_keepalive_interval .
+     */
+    avs_time_duration_t keepalive_interval;
 } anjay_configuration_t;
 
 /**
@@ -362,6 +477,31 @@ int anjay_sched_calculate_wait_time_ms(anjay_t *anjay, int limit_ms);
  */
 int anjay_sched_run(anjay_t *anjay);
 
+/**
+ * Runs scheduled events which need to be invoked at or before the time of this
+ * function invocation, like @ref anjay_sched_run , but returns early once the
+ * specified budget is exhausted.
+ *
+ * This allows the application to interleave handling of incoming packets (see
+ * @ref anjay_serve) with processing a large backlog of scheduled jobs, e.g.
+ * after reconnecting to many servers at once.
+ *
+ * @param anjay        Anjay object to operate on.
+ * @param max_jobs     Maximum number of jobs to run, or 0 for no limit.
+ * @param max_duration Maximum time to spend running jobs, or
+ *                     <c>AVS_TIME_DURATION_INVALID</c> for no limit. The limit
+ *                     is checked between jobs, so it may be exceeded by the
+ *                     duration of a single job. At least one job is run if any
+ *                     is due.
+ *
+ * @returns 0 if all the due events have been run, 1 if some of them are still
+ *          pending and the function should be called again as soon as
+ *          possible, or a negative value in case of error.
+ */
+int anjay_sched_run_bounded(anjay_t *anjay,
+                            size_t max_jobs,
+                            avs_time_duration_t max_duration);
+
 /**
  * Schedules sending an Update message to the server identified by given
  * Short Server ID.
@@ -418,6 +558,25 @@ int anjay_schedule_reconnect(anjay_t *anjay);
  */
 int anjay_disable_server(anjay_t *anjay, anjay_ssid_t ssid);
 
+/**
+ * Changes the interval of CoAP ping keepalives sent to an LwM2M Server. See
+ * <c>keepalive_interval</c> in @ref anjay_configuration_t for details.
+ *
+ * The new interval is counted from the moment of the call.
+ *
+ * @param anjay    Anjay object to operate on.
+ * @param ssid     Short Server ID of the server to configure, or
+ *                 @ref ANJAY_SSID_ANY to change the default interval and drop
+ *                 all per-server settings. Keepalives are never sent to the
+ *                 Bootstrap Server, so @ref ANJAY_SSID_BOOTSTRAP is rejected.
+ * @param interval New keepalive interval, or zero to disable keepalives.
+ *
+ * @returns 0 on success, a negative value in case of error.
+ */
+int anjay_set_server_keepalive_interval(anjay_t *anjay,
+                                        anjay_ssid_t ssid,
+                                        avs_time_duration_t interval);
+
 
 /**
  * Checks whether anjay is currently in offline state.
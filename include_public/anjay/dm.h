@@ -753,6 +753,38 @@ struct anjay_dm_object_def_struct {
 
     /** Handler callbacks for this object. */
     anjay_dm_handlers_t handlers;
+
+    /**
+     * Set to true to declare that @ref anjay_notify_changed (or
+     * @ref anjay_notify_instances_changed) is called for every change of any
+     * Resource value in this Object that is not performed by an LwM2M server.
+     *
+     * In that case, when the Maximum Period of an observation expires and no
+     * change has been reported since the observed value was last read, the
+     * notification is sent with the previously read value instead of reading
+     * it from the data model again. A call to
+     * @ref anjay_notify_instances_changed counts as a change of every Resource
+     * in the Object.
+     */
+    bool all_changes_notified;
+
+    /**
+     * If set to a positive duration, values returned by the
+     * @ref anjay_dm_handlers_t::resource_read handler of this Object are cached
+     * for that long, and Read or Observe requests for the same Resource that
+     * arrive within that time are answered without calling the handler again.
+     *
+     * The cached value of a Resource is discarded when it is written by an
+     * LwM2M server, or when @ref anjay_notify_changed or
+     * @ref anjay_notify_instances_changed is called for it. This makes the
+     * cache suitable for Resources that are expensive to read (e.g. require
+     * sampling a sensor), as long as every change is reported that way, and
+     * as long as the value does not depend on which server is reading it.
+     *
+     * Values read internally by the library (e.g. Server Object Resources)
+     * are never cached. Zero (the default) disables caching.
+     */
+    avs_time_duration_t read_cache_ttl;
 };
 
 /**
@@ -812,6 +844,30 @@ int anjay_notify_instances_changed(anjay_t *anjay, anjay_oid_t oid);
 int anjay_register_object(anjay_t *anjay,
                           const anjay_dm_object_def_t *const *def_ptr);
 
+/**
+ * Registers multiple Objects in the data model at once. This is equivalent to
+ * calling @ref anjay_register_object for each of them, but the data model is
+ * updated in a single pass and the Registration Update is rescheduled only
+ * once, which makes a difference if there are many Objects to register.
+ *
+ * Either all of the Objects are registered or, in case of an error, none of
+ * them are.
+ *
+ * NOTE: All elements of <c>def_ptrs</c> MUST stay valid up to and including
+ * the corresponding @ref anjay_delete or @ref anjay_unregister_object call.
+ * The <c>def_ptrs</c> array itself does not need to outlive this call.
+ *
+ * @param anjay    Anjay object to operate on.
+ * @param def_ptrs Array of pointers to the Object definition structs, in any
+ *                 order. See @ref anjay_register_object for details.
+ * @param count    Number of elements in <c>def_ptrs</c>.
+ *
+ * @returns 0 on success, a negative value in case of error.
+ */
+int anjay_register_objects(anjay_t *anjay,
+                           const anjay_dm_object_def_t *const *const *def_ptrs,
+                           size_t count);
+
 /**
  * Unregisters an Object in the data model, so that it is no longer available
  * for RPC calls.
@@ -23,6 +23,7 @@
 #include <avsystem/commons/net.h>
 
 #include <anjay/core.h>
+#include <anjay/stats.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -154,6 +155,23 @@ anjay_download_handle_t anjay_download(anjay_t *anjay,
 void anjay_download_abort(anjay_t *anjay,
                           anjay_download_handle_t dl_handle);
 
+/**
+ * Retrieves traffic counters of a download identified by @p dl_handle. Only
+ * CoAP downloads are accounted for - counters of HTTP downloads are always
+ * zero.
+ *
+ * @param anjay     Anjay object managing the download process.
+ * @param dl_handle Download handle previously returned by
+ *                  @ref anjay_download.
+ * @param out_stats Structure to fill with the counters.
+ *
+ * @returns 0 on success, negative value if @p dl_handle does not represent
+ *          a download that is still in progress.
+ */
+int anjay_download_get_stats(anjay_t *anjay,
+                             anjay_download_handle_t dl_handle,
+                             anjay_traffic_stats_t *out_stats);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
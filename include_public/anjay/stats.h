@@ -16,6 +16,8 @@
 #ifndef ANJAY_INCLUDE_ANJAY_STATS_H
 #define ANJAY_INCLUDE_ANJAY_STATS_H
 
+#include <anjay/core.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -51,6 +53,89 @@ uint64_t anjay_get_num_incoming_retransmissions(anjay_t *anjay);
  */
 uint64_t anjay_get_num_outgoing_retransmissions(anjay_t *anjay);
 
+/**
+ * @returns the number of queue mode wake-ups, i.e. the number of times a
+ *          suspended queue mode connection had to be brought back online while
+ *          no other queue mode connection was online. May be used to tune the
+ *          <c>queue_mode_wakeup_slack</c> setting in
+ *          @ref anjay_configuration_t .
+ */
+uint64_t anjay_get_num_queue_mode_wakeups(anjay_t *anjay);
+
+/**
+ * @returns the number of requests that arrived while the client was waiting
+ *          for a response to its own request (e.g. Register, Update or
+ *          a confirmable notification) and were queued to be handled as soon
+ *          as that exchange finished, instead of being rejected.
+ */
+uint64_t anjay_get_num_deferred_requests(anjay_t *anjay);
+
+/**
+ * @returns the number of requests that arrived while the client was waiting
+ *          for a response to its own request, but could not be queued because
+ *          the queue was full. Such requests are rejected with 5.03 Service
+ *          Unavailable, and the server is expected to retry them later.
+ */
+uint64_t anjay_get_num_dropped_deferred_requests(anjay_t *anjay);
+
+/**
+ * Traffic counters kept separately for each server connection and each
+ * download.
+ *
+ * NOTE: Byte and retransmission counters are only maintained when
+ * WITH_NET_STATS is enabled, otherwise they are always 0. RTT samples are
+ * collected regardless of that setting.
+ */
+typedef struct {
+    /** Number of bytes sent, as in @ref anjay_get_tx_bytes . */
+    uint64_t tx_bytes;
+    /** Number of bytes received, as in @ref anjay_get_rx_bytes . */
+    uint64_t rx_bytes;
+    /**
+     * Number of duplicate packets received, as in
+     * @ref anjay_get_num_incoming_retransmissions .
+     */
+    uint64_t num_incoming_retransmissions;
+    /**
+     * Number of retransmitted packets, as in
+     * @ref anjay_get_num_outgoing_retransmissions .
+     */
+    uint64_t num_outgoing_retransmissions;
+    /**
+     * Number of round-trip time samples taken. A sample is taken whenever
+     * a response to a confirmable message sent by the client is received
+     * without any retransmission of that message.
+     */
+    uint64_t num_rtt_samples;
+    /** Most recent RTT sample. Zero if @ref num_rtt_samples is 0. */
+    avs_time_duration_t last_rtt;
+    /**
+     * Smoothed RTT, calculated from all samples as described in RFC 6298.
+     * Zero if @ref num_rtt_samples is 0.
+     */
+    avs_time_duration_t smoothed_rtt;
+} anjay_traffic_stats_t;
+
+/**
+ * Retrieves traffic counters of the connection to the server identified by
+ * @p ssid . The counters are kept for as long as the server stays active, i.e.
+ * they are reset if the server is disabled or removed from the data model.
+ *
+ * This function does not perform any I/O and is cheap enough to be called
+ * e.g. on every Read of a resource that exposes these counters.
+ *
+ * @param anjay     Anjay object to operate on.
+ * @param ssid      Short Server ID of the server to query. ANJAY_SSID_BOOTSTRAP
+ *                  may be used to query the Bootstrap Server connection.
+ * @param out_stats Structure to fill with the counters.
+ *
+ * @returns 0 on success, negative value if there is no active server with the
+ *          given @p ssid .
+ */
+int anjay_get_server_stats(anjay_t *anjay,
+                           anjay_ssid_t ssid,
+                           anjay_traffic_stats_t *out_stats);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -55,6 +55,16 @@ int anjay_access_control_persist(anjay_t *anjay,
 /**
  * Tries to restore Access Control Object Instances from given @p in_stream.
  *
+ * The stream may contain any number of journal segments, as written by
+ * @ref anjay_access_control_persist_changes, following the snapshot written by
+ * @ref anjay_access_control_persist. They are replayed in order. A segment that
+ * cannot be read completely (e.g. because the device lost power while it was
+ * being written) is ignored along with anything that follows it, and
+ * @ref anjay_access_control_journal_needs_compaction returns true afterwards,
+ * as segments appended later would never be replayed. Reading stops before
+ * the first byte that does not belong to the journal, so other data may be
+ * stored after it in the same stream.
+ *
  * @param anjay         ANJAY object with the Access Control module installed
  * @param in_stream     stream used for reading Access Control Object Instances
  * @return 0 in case of success, negative value in case of an error
@@ -62,6 +72,47 @@ int anjay_access_control_persist(anjay_t *anjay,
 int anjay_access_control_restore(anjay_t *anjay,
                                  avs_stream_abstract_t *in_stream);
 
+/**
+ * Appends a journal segment to the @p out_stream, describing Access Control
+ * Object Instances created, modified or removed since the last successful call
+ * to @ref anjay_access_control_persist, @ref anjay_access_control_restore or
+ * this function. Nothing is written if there were no such changes.
+ *
+ * The segment is meant to be written directly after the data persisted
+ * previously, so that the whole stream can later be passed to
+ * @ref anjay_access_control_restore. Writing it costs a few dozen bytes per
+ * changed Instance, instead of rewriting all of them.
+ *
+ * NOTE: To be able to determine what has changed, the module keeps a copy of
+ * the Access Control Object state as of the last persist/restore operation.
+ *
+ * @param anjay         ANJAY object with the Access Control module installed
+ * @param out_stream    stream to append the journal segment to
+ * @return 0 in case of success, negative value in case of an error, including
+ *         the case where neither @ref anjay_access_control_persist nor
+ *         @ref anjay_access_control_restore was successfully called before.
+ *         After a failure, the persisted data shall be rewritten from scratch
+ *         using @ref anjay_access_control_persist;
+ *         @ref anjay_access_control_journal_needs_compaction returns true
+ *         until that happens.
+ */
+int anjay_access_control_persist_changes(anjay_t *anjay,
+                                         avs_stream_abstract_t *out_stream);
+
+/**
+ * Checks whether the journal written by
+ * @ref anjay_access_control_persist_changes since the last full snapshot has
+ * grown large enough that the persisted data should be compacted, i.e.
+ * rewritten from scratch using @ref anjay_access_control_persist.
+ *
+ * This is the case when the journal contains more records than there are
+ * Access Control Object Instances, which keeps both the storage used and the
+ * time spent restoring within a small constant factor of a single snapshot.
+ * It is also the case when the persisted journal is known to end with a
+ * segment that cannot be replayed.
+ */
+bool anjay_access_control_journal_needs_compaction(anjay_t *anjay);
+
 /**
  * Assign permissions for Instance /OID/IID to a particular server.
  *
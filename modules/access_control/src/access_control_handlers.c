@@ -664,11 +664,17 @@ static void ac_delete(anjay_t *anjay, void *access_control_) {
             (access_control_t *) access_control_;
     _anjay_access_control_clear_state(&access_control->current);
     _anjay_access_control_clear_state(&access_control->saved_state);
+    _anjay_access_control_clear_state(&access_control->journal_base);
     free(access_control);
 }
 
 static const anjay_dm_module_t ACCESS_CONTROL_MODULE = {
     .notify_callback = sync_on_notify,
+    // what_changed() ignores Objects whose sets of Instances did not change,
+    // so there is no point in passing e.g. Resource value changes to it
+    .notify_interest = {
+        .instance_set_changes_only = true
+    },
     .deleter = ac_delete
 };
 
@@ -19,8 +19,14 @@
 #include <anjay/access_control.h>
 #include <anjay/persistence.h>
 
+#include <avsystem/commons/stream/stream_inbuf.h>
+#include <avsystem/commons/stream_v_table.h>
+
+#include <anjay_modules/io_utils.h>
+
 #include "mod_access_control.h"
 
+#include <stdlib.h>
 #include <string.h>
 
 VISIBILITY_SOURCE_BEGIN
@@ -125,6 +131,316 @@ static int restore_instances(anjay_t *anjay,
     return 0;
 }
 
+static const char JOURNAL_MAGIC[] = { 'A', 'C', 'J', '\1' };
+
+typedef struct {
+    bool deleted;
+    // if deleted is true, only iid is meaningful
+    access_control_instance_t instance;
+} journal_record_t;
+
+static void clear_journal_records(AVS_LIST(journal_record_t) *records) {
+    AVS_LIST_CLEAR(records) {
+        AVS_LIST_CLEAR(&(*records)->instance.acl);
+    }
+}
+
+static void reset_journal_base(access_control_t *ac) {
+    _anjay_access_control_clear_state(&ac->journal_base);
+    ac->journal_records = 0;
+    ac->journal_damaged = false;
+    ac->has_journal_base =
+            !_anjay_access_control_clone_state(&ac->journal_base, &ac->current);
+    if (!ac->has_journal_base) {
+        ac_log(WARNING, "out of memory, changes cannot be journaled until the "
+                        "next full persist");
+    }
+}
+
+static bool same_acl(AVS_LIST(acl_entry_t) a, AVS_LIST(acl_entry_t) b) {
+    while (a && b) {
+        if (a->mask != b->mask || a->ssid != b->ssid) {
+            return false;
+        }
+        a = AVS_LIST_NEXT(a);
+        b = AVS_LIST_NEXT(b);
+    }
+    return !a && !b;
+}
+
+static bool same_instance(const access_control_instance_t *a,
+                          const access_control_instance_t *b) {
+    return a->iid == b->iid
+            && a->target.oid == b->target.oid
+            && a->target.iid == b->target.iid
+            && a->owner == b->owner
+            && a->has_acl == b->has_acl
+            && same_acl(a->acl, b->acl);
+}
+
+static int persist_upsert_record(anjay_persistence_context_t *ctx,
+                                 access_control_instance_t *instance) {
+    bool deleted = false;
+    int retval = anjay_persistence_bool(ctx, &deleted);
+    return retval ? retval : persist_instance(ctx, instance, NULL);
+}
+
+static int persist_delete_record(anjay_persistence_context_t *ctx,
+                                 anjay_iid_t iid) {
+    bool deleted = true;
+    int retval;
+    (void) ((retval = anjay_persistence_bool(ctx, &deleted))
+            || (retval = anjay_persistence_u16(ctx, &iid)));
+    return retval;
+}
+
+/**
+ * Walks both instance lists (which are kept sorted by IID) in parallel,
+ * writing a journal record for each difference to @p ctx . The number of
+ * records is returned via @p out_count .
+ */
+static int
+persist_changes(anjay_persistence_context_t *ctx,
+                AVS_LIST(access_control_instance_t) old_instances,
+                AVS_LIST(access_control_instance_t) new_instances,
+                uint32_t *out_count) {
+    *out_count = 0;
+    while (old_instances || new_instances) {
+        int retval = 0;
+        if (!old_instances
+                || (new_instances && new_instances->iid < old_instances->iid)) {
+            retval = persist_upsert_record(ctx, new_instances);
+            new_instances = AVS_LIST_NEXT(new_instances);
+        } else if (!new_instances
+                || old_instances->iid < new_instances->iid) {
+            retval = persist_delete_record(ctx, old_instances->iid);
+            old_instances = AVS_LIST_NEXT(old_instances);
+        } else {
+            bool changed = !same_instance(old_instances, new_instances);
+            if (changed) {
+                retval = persist_upsert_record(ctx, new_instances);
+            }
+            old_instances = AVS_LIST_NEXT(old_instances);
+            new_instances = AVS_LIST_NEXT(new_instances);
+            if (!changed) {
+                continue;
+            }
+        }
+        if (retval) {
+            return retval;
+        }
+        ++*out_count;
+    }
+    return 0;
+}
+
+typedef struct {
+    const avs_stream_v_table_t *const vtable;
+    size_t bytes_written;
+} byte_counter_t;
+
+static int byte_counter_write(avs_stream_abstract_t *stream,
+                              const void *data,
+                              size_t *data_length) {
+    (void) data;
+    ((byte_counter_t *) stream)->bytes_written += *data_length;
+    return 0;
+}
+
+static int unimplemented() {
+    return -1;
+}
+
+/**
+ * Determines the number of journal records persist_changes() would write and
+ * their total size in bytes, without writing anything.
+ */
+static int
+measure_changes(AVS_LIST(access_control_instance_t) old_instances,
+                AVS_LIST(access_control_instance_t) new_instances,
+                uint32_t *out_count,
+                uint32_t *out_length) {
+    static const avs_stream_v_table_t VTABLE = {
+        byte_counter_write,
+        (avs_stream_finish_message_t) unimplemented,
+        (avs_stream_read_t) unimplemented,
+        (avs_stream_peek_t) unimplemented,
+        (avs_stream_reset_t) unimplemented,
+        (avs_stream_close_t) unimplemented,
+        (avs_stream_errno_t) unimplemented,
+        NULL
+    };
+    byte_counter_t counter = { &VTABLE, 0 };
+    anjay_persistence_context_t *ctx = anjay_persistence_store_context_new(
+            (avs_stream_abstract_t *) &counter);
+    if (!ctx) {
+        ac_log(ERROR, "Out of memory");
+        return -1;
+    }
+    int retval = persist_changes(ctx, old_instances, new_instances, out_count);
+    anjay_persistence_context_delete(ctx);
+    if (!retval && counter.bytes_written > UINT32_MAX) {
+        ac_log(ERROR, "journal segment too large");
+        retval = -1;
+    }
+    *out_length = (uint32_t) counter.bytes_written;
+    return retval;
+}
+
+static int read_journal_record(anjay_t *anjay,
+                               anjay_persistence_context_t *ctx,
+                               journal_record_t *out_record) {
+    int retval = anjay_persistence_bool(ctx, &out_record->deleted);
+    if (retval) {
+        return retval;
+    }
+    if (out_record->deleted) {
+        return anjay_persistence_u16(ctx, &out_record->instance.iid);
+    }
+    (void) ((retval = anjay_persistence_u16(ctx,
+                                            &out_record->instance.target.oid))
+            || (retval = restore_instance(&out_record->instance, ctx)));
+    if (!retval && !is_object_registered(anjay,
+                                         out_record->instance.target.oid)) {
+        // the target is gone, so is the Access Control Instance
+        out_record->deleted = true;
+        AVS_LIST_CLEAR(&out_record->instance.acl);
+    }
+    return retval;
+}
+
+static int read_journal_records(anjay_t *anjay,
+                                anjay_persistence_context_t *ctx,
+                                uint32_t count,
+                                AVS_LIST(journal_record_t) *out_records) {
+    AVS_LIST(journal_record_t) *tail = out_records;
+    while (count--) {
+        if (!(*tail = AVS_LIST_NEW_ELEMENT(journal_record_t))) {
+            ac_log(ERROR, "out of memory");
+            return -1;
+        }
+        int retval = read_journal_record(anjay, ctx, *tail);
+        if (retval) {
+            return retval;
+        }
+        tail = AVS_LIST_NEXT_PTR(tail);
+    }
+    return 0;
+}
+
+static bool journal_segment_ahead(avs_stream_abstract_t *in) {
+    for (size_t i = 0; i < sizeof(JOURNAL_MAGIC); ++i) {
+        if (avs_stream_peek(in, i) != JOURNAL_MAGIC[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Reads a single journal segment. Its header states the size of the records
+ * that follow, so they are parsed from a separate buffer and a corrupted
+ * segment can never cause more than that to be consumed from @p in .
+ */
+static int read_journal_segment(anjay_t *anjay,
+                                avs_stream_abstract_t *in,
+                                anjay_persistence_context_t *ctx,
+                                AVS_LIST(journal_record_t) *out_records) {
+    char magic[sizeof(JOURNAL_MAGIC)];
+    uint32_t count;
+    uint32_t length;
+    if (avs_stream_read_reliably(in, magic, sizeof(magic))
+            || anjay_persistence_u32(ctx, &count)
+            || anjay_persistence_u32(ctx, &length)
+            || !count || count > UINT16_MAX || !length) {
+        return -1;
+    }
+    char *buffer = (char *) malloc(length);
+    if (!buffer) {
+        ac_log(ERROR, "out of memory");
+        return -1;
+    }
+    avs_stream_inbuf_t records = AVS_STREAM_INBUF_STATIC_INITIALIZER;
+    avs_stream_inbuf_set_buffer(&records, buffer, length);
+    anjay_persistence_context_t *records_ctx = NULL;
+    int retval = -1;
+    if (!avs_stream_read_reliably(in, buffer, length)
+            && (records_ctx = anjay_persistence_restore_context_new(
+                        (avs_stream_abstract_t *) &records))
+            && !(retval = read_journal_records(anjay, records_ctx, count,
+                                               out_records))
+            && _anjay_stream_at_end((avs_stream_abstract_t *) &records) != 1) {
+        // the records do not add up to the size stated in the header
+        retval = -1;
+    }
+    anjay_persistence_context_delete(records_ctx);
+    free(buffer);
+    return retval;
+}
+
+static int apply_journal_record(access_control_state_t *state,
+                                journal_record_t *record) {
+    AVS_LIST(access_control_instance_t) *ptr;
+    AVS_LIST_FOREACH_PTR(ptr, &state->instances) {
+        if ((*ptr)->iid >= record->instance.iid) {
+            break;
+        }
+    }
+    if (*ptr && (*ptr)->iid == record->instance.iid) {
+        AVS_LIST_CLEAR(&(*ptr)->acl);
+        AVS_LIST_DELETE(ptr);
+    }
+    if (!record->deleted) {
+        AVS_LIST(access_control_instance_t) entry =
+                AVS_LIST_NEW_ELEMENT(access_control_instance_t);
+        if (!entry) {
+            ac_log(ERROR, "out of memory");
+            return -1;
+        }
+        *entry = record->instance;
+        record->instance.acl = NULL;
+        AVS_LIST_INSERT(ptr, entry);
+    }
+    return 0;
+}
+
+static int replay_journal(anjay_t *anjay,
+                          access_control_state_t *state,
+                          avs_stream_abstract_t *in,
+                          anjay_persistence_context_t *restore_ctx,
+                          size_t *out_records,
+                          bool *out_damaged) {
+    int retval;
+    while (!(retval = _anjay_stream_at_end(in))) {
+        if (!journal_segment_ahead(in)) {
+            // whatever the application stored after the journal; leave it
+            // unread
+            return 0;
+        }
+        AVS_LIST(journal_record_t) records = NULL;
+        if (read_journal_segment(anjay, in, restore_ctx, &records)) {
+            // most likely a write interrupted by a power loss; the segment
+            // was never complete, so drop it along with anything after it
+            ac_log(WARNING, "ignoring incomplete journal segment");
+            clear_journal_records(&records);
+            *out_damaged = true;
+            return 0;
+        }
+        *out_records += AVS_LIST_SIZE(records);
+        AVS_LIST(journal_record_t) record;
+        AVS_LIST_FOREACH(record, records) {
+            if ((retval = apply_journal_record(state, record))) {
+                break;
+            }
+        }
+        clear_journal_records(&records);
+        if (retval) {
+            return retval;
+        }
+    }
+    return retval < 0 ? retval : 0;
+}
+
 static int restore(anjay_t *anjay,
                    access_control_t *ac,
                    avs_stream_abstract_t *in) {
@@ -138,13 +454,21 @@ static int restore(anjay_t *anjay,
     }
 
     access_control_state_t state = { NULL };
+    size_t journal_records = 0;
+    bool journal_damaged = false;
     if ((retval = restore_instances(anjay, &state.instances,
-                                    restore_ctx, ignore_ctx))) {
+                                    restore_ctx, ignore_ctx))
+            || (retval = replay_journal(anjay, &state, in, restore_ctx,
+                                        &journal_records,
+                                        &journal_damaged))) {
         _anjay_access_control_clear_state(&state);
         goto finish;
     }
     _anjay_access_control_clear_state(&ac->current);
     ac->current = state;
+    reset_journal_base(ac);
+    ac->journal_records = journal_records;
+    ac->journal_damaged = journal_damaged;
 finish:
     anjay_persistence_context_delete(restore_ctx);
     anjay_persistence_context_delete(ignore_ctx);
@@ -175,9 +499,69 @@ int anjay_access_control_persist(anjay_t *anjay,
                                     sizeof(*ac->current.instances),
                                     persist_instance, NULL);
     anjay_persistence_context_delete(ctx);
+    if (!retval) {
+        reset_journal_base(ac);
+    }
     return retval;
 }
 
+int anjay_access_control_persist_changes(anjay_t *anjay,
+                                         avs_stream_abstract_t *out) {
+    access_control_t *ac = _anjay_access_control_get(anjay);
+    if (!ac) {
+        ac_log(ERROR, "Access Control not installed in this Anjay object");
+        return -1;
+    }
+    if (!ac->has_journal_base) {
+        ac_log(ERROR, "no persisted state to append changes to");
+        return -1;
+    }
+
+    uint32_t count;
+    uint32_t length;
+    int retval = measure_changes(ac->journal_base.instances,
+                                 ac->current.instances, &count, &length);
+    if (retval || !count) {
+        return retval;
+    }
+
+    access_control_state_t new_base = { NULL };
+    if (_anjay_access_control_clone_state(&new_base, &ac->current)) {
+        ac_log(ERROR, "Out of memory");
+        return -1;
+    }
+    anjay_persistence_context_t *ctx = anjay_persistence_store_context_new(out);
+    if (!ctx) {
+        ac_log(ERROR, "Out of memory");
+        _anjay_access_control_clear_state(&new_base);
+        return -1;
+    }
+    (void) ((retval = avs_stream_write(out, JOURNAL_MAGIC,
+                                       sizeof(JOURNAL_MAGIC)))
+            || (retval = anjay_persistence_u32(ctx, &count))
+            || (retval = anjay_persistence_u32(ctx, &length))
+            || (retval = persist_changes(ctx, ac->journal_base.instances,
+                                         ac->current.instances, &count)));
+    anjay_persistence_context_delete(ctx);
+    if (retval) {
+        // a partially written segment will not be replayed
+        ac->journal_damaged = true;
+        _anjay_access_control_clear_state(&new_base);
+        return retval;
+    }
+    _anjay_access_control_clear_state(&ac->journal_base);
+    ac->journal_base = new_base;
+    ac->journal_records += count;
+    return 0;
+}
+
+bool anjay_access_control_journal_needs_compaction(anjay_t *anjay) {
+    access_control_t *ac = _anjay_access_control_get(anjay);
+    return ac && (ac->journal_damaged
+                  || ac->journal_records
+                             > AVS_LIST_SIZE(ac->current.instances));
+}
+
 int anjay_access_control_restore(anjay_t *anjay, avs_stream_abstract_t *in) {
     access_control_t *ac = _anjay_access_control_get(anjay);
     if (!ac) {
@@ -59,6 +59,14 @@ typedef struct {
     access_control_state_t saved_state;
     bool needs_validation;
     bool sync_in_progress;
+    // state as of the last persisted snapshot or journal segment; changes
+    // against it are what anjay_access_control_persist_changes() writes
+    access_control_state_t journal_base;
+    bool has_journal_base;
+    size_t journal_records;
+    // set if the persisted journal is known to end with a segment that
+    // cannot be replayed
+    bool journal_damaged;
 } access_control_t;
 
 typedef const anjay_dm_object_def_t *const *obj_ptr_t;
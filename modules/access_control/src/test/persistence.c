@@ -239,3 +239,239 @@ AVS_UNIT_TEST(access_control_persistence, normal_usage) {
     free((anjay_dm_object_def_t *) (intptr_t) mock_obj1);
     free((anjay_dm_object_def_t *) (intptr_t) mock_obj2);
 }
+
+static AVS_LIST(access_control_instance_t)
+make_instance(anjay_iid_t iid, anjay_oid_t target_oid, anjay_iid_t target_iid) {
+    AVS_LIST(access_control_instance_t) instance =
+            AVS_LIST_NEW_ELEMENT(access_control_instance_t);
+    AVS_UNIT_ASSERT_NOT_NULL(instance);
+    *instance = (access_control_instance_t) {
+        .iid = iid,
+        .target = {
+            .oid = target_oid,
+            .iid = target_iid
+        },
+        .owner = 1,
+        .has_acl = true
+    };
+    AVS_LIST_APPEND(&instance->acl, AVS_LIST_NEW_ELEMENT(acl_entry_t));
+    AVS_UNIT_ASSERT_NOT_NULL(instance->acl);
+    *instance->acl = (acl_entry_t) { .mask = 0x0001, .ssid = ANJAY_SSID_ANY };
+    AVS_LIST_APPEND(&instance->acl, AVS_LIST_NEW_ELEMENT(acl_entry_t));
+    AVS_UNIT_ASSERT_NOT_NULL(AVS_LIST_NEXT(instance->acl));
+    *AVS_LIST_NEXT(instance->acl) =
+            (acl_entry_t) { .mask = 0x001F, .ssid = 1 };
+    return instance;
+}
+
+static void remove_instance(access_control_t *ac, anjay_iid_t iid) {
+    AVS_LIST(access_control_instance_t) *ptr;
+    AVS_LIST_FOREACH_PTR(ptr, &ac->current.instances) {
+        if ((*ptr)->iid == iid) {
+            AVS_LIST_CLEAR(&(*ptr)->acl);
+            AVS_LIST_DELETE(ptr);
+            return;
+        }
+    }
+    AVS_UNIT_ASSERT_TRUE(false);
+}
+
+AVS_UNIT_TEST(access_control_persistence, journal_replay) {
+    anjay_t *anjay1 = ac_test_create_fake_anjay();
+    anjay_t *anjay2 = ac_test_create_fake_anjay();
+
+    storage_ctx_t ctx = { .buffer = {} };
+    init_context(&ctx);
+
+    AVS_UNIT_ASSERT_SUCCESS(anjay_access_control_install(anjay1));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_access_control_install(anjay2));
+    access_control_t *ac1 = _anjay_access_control_get(anjay1);
+    access_control_t *ac2 = _anjay_access_control_get(anjay2);
+
+    const anjay_dm_object_def_t *mock_obj = make_mock_object(32);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_register_object(anjay1, &mock_obj));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_register_object(anjay2, &mock_obj));
+
+    // nothing to append changes to yet
+    AVS_UNIT_ASSERT_FAILED(anjay_access_control_persist_changes(
+            anjay1, (avs_stream_abstract_t *) &ctx.out));
+    AVS_UNIT_ASSERT_EQUAL(avs_stream_outbuf_offset(&ctx.out), 0);
+
+    for (anjay_iid_t iid = 0; iid < 4; ++iid) {
+        AVS_UNIT_ASSERT_SUCCESS(_anjay_access_control_add_instance(
+                ac1, make_instance(iid, 32, iid), NULL));
+    }
+    AVS_UNIT_ASSERT_SUCCESS(anjay_access_control_persist(
+            anjay1, (avs_stream_abstract_t *) &ctx.out));
+    size_t snapshot_size = avs_stream_outbuf_offset(&ctx.out);
+
+    // no changes - nothing is written
+    AVS_UNIT_ASSERT_SUCCESS(anjay_access_control_persist_changes(
+            anjay1, (avs_stream_abstract_t *) &ctx.out));
+    AVS_UNIT_ASSERT_EQUAL(avs_stream_outbuf_offset(&ctx.out), snapshot_size);
+
+    ac1->current.instances->owner = 2;
+    remove_instance(ac1, 2);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_access_control_persist_changes(
+            anjay1, (avs_stream_abstract_t *) &ctx.out));
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_access_control_add_instance(
+            ac1, make_instance(7, 32, 7), NULL));
+    AVS_LIST_CLEAR(&AVS_LIST_NEXT(ac1->current.instances)->acl);
+    AVS_LIST_NEXT(ac1->current.instances)->has_acl = false;
+    AVS_UNIT_ASSERT_SUCCESS(anjay_access_control_persist_changes(
+            anjay1, (avs_stream_abstract_t *) &ctx.out));
+    AVS_UNIT_ASSERT_EQUAL(ac1->journal_records, 4);
+    AVS_UNIT_ASSERT_FALSE(anjay_access_control_journal_needs_compaction(anjay1));
+
+    ctx.in.buffer_size = avs_stream_outbuf_offset(&ctx.out);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_access_control_restore(
+            anjay2, (avs_stream_abstract_t *) &ctx.in));
+    AVS_UNIT_ASSERT_EQUAL(AVS_LIST_SIZE(ac2->current.instances), 4);
+    AVS_UNIT_ASSERT_TRUE(aco_equal(ac1, ac2));
+    AVS_UNIT_ASSERT_EQUAL(ac2->journal_records, 4);
+
+    // a change that brings the journal over the compaction threshold
+    AVS_LIST_NTH(ac1->current.instances, 3)->owner = 3;
+    AVS_UNIT_ASSERT_SUCCESS(anjay_access_control_persist_changes(
+            anjay1, (avs_stream_abstract_t *) &ctx.out));
+    AVS_UNIT_ASSERT_TRUE(anjay_access_control_journal_needs_compaction(anjay1));
+    init_context(&ctx);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_access_control_persist(
+            anjay1, (avs_stream_abstract_t *) &ctx.out));
+    AVS_UNIT_ASSERT_FALSE(anjay_access_control_journal_needs_compaction(anjay1));
+
+    anjay_delete(anjay1);
+    anjay_delete(anjay2);
+
+    free((anjay_dm_object_def_t *) (intptr_t) mock_obj);
+}
+
+AVS_UNIT_TEST(access_control_persistence, journal_incomplete_segment) {
+    anjay_t *anjay1 = ac_test_create_fake_anjay();
+    anjay_t *anjay2 = ac_test_create_fake_anjay();
+
+    storage_ctx_t ctx = { .buffer = {} };
+    init_context(&ctx);
+
+    AVS_UNIT_ASSERT_SUCCESS(anjay_access_control_install(anjay1));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_access_control_install(anjay2));
+    access_control_t *ac1 = _anjay_access_control_get(anjay1);
+    access_control_t *ac2 = _anjay_access_control_get(anjay2);
+
+    const anjay_dm_object_def_t *mock_obj = make_mock_object(32);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_register_object(anjay1, &mock_obj));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_register_object(anjay2, &mock_obj));
+
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_access_control_add_instance(
+            ac1, make_instance(0, 32, 0), NULL));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_access_control_persist(
+            anjay1, (avs_stream_abstract_t *) &ctx.out));
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_access_control_add_instance(
+            ac1, make_instance(1, 32, 1), NULL));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_access_control_persist_changes(
+            anjay1, (avs_stream_abstract_t *) &ctx.out));
+    size_t complete_size = avs_stream_outbuf_offset(&ctx.out);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_access_control_add_instance(
+            ac1, make_instance(2, 32, 2), NULL));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_access_control_persist_changes(
+            anjay1, (avs_stream_abstract_t *) &ctx.out));
+
+    // the last segment was cut short; the ones before it are still applied
+    ctx.in.buffer_size = avs_stream_outbuf_offset(&ctx.out) - 1;
+    AVS_UNIT_ASSERT_SUCCESS(anjay_access_control_restore(
+            anjay2, (avs_stream_abstract_t *) &ctx.in));
+    remove_instance(ac1, 2);
+    AVS_UNIT_ASSERT_TRUE(aco_equal(ac1, ac2));
+    AVS_UNIT_ASSERT_TRUE(complete_size < ctx.in.buffer_size);
+
+    // anything appended after the broken segment would be lost
+    AVS_UNIT_ASSERT_EQUAL(ac2->journal_records, 1);
+    AVS_UNIT_ASSERT_TRUE(anjay_access_control_journal_needs_compaction(anjay2));
+    init_context(&ctx);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_access_control_persist(
+            anjay2, (avs_stream_abstract_t *) &ctx.out));
+    AVS_UNIT_ASSERT_FALSE(anjay_access_control_journal_needs_compaction(anjay2));
+
+    anjay_delete(anjay1);
+    anjay_delete(anjay2);
+
+    free((anjay_dm_object_def_t *) (intptr_t) mock_obj);
+}
+
+AVS_UNIT_TEST(access_control_persistence, journal_followed_by_other_data) {
+    static const char OTHER_DATA[] = "ACJ other data";
+    anjay_t *anjay1 = ac_test_create_fake_anjay();
+    anjay_t *anjay2 = ac_test_create_fake_anjay();
+
+    storage_ctx_t ctx = { .buffer = {} };
+    init_context(&ctx);
+
+    AVS_UNIT_ASSERT_SUCCESS(anjay_access_control_install(anjay1));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_access_control_install(anjay2));
+    access_control_t *ac1 = _anjay_access_control_get(anjay1);
+    access_control_t *ac2 = _anjay_access_control_get(anjay2);
+
+    const anjay_dm_object_def_t *mock_obj = make_mock_object(32);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_register_object(anjay1, &mock_obj));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_register_object(anjay2, &mock_obj));
+
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_access_control_add_instance(
+            ac1, make_instance(0, 32, 0), NULL));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_access_control_persist(
+            anjay1, (avs_stream_abstract_t *) &ctx.out));
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_access_control_add_instance(
+            ac1, make_instance(1, 32, 1), NULL));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_access_control_persist_changes(
+            anjay1, (avs_stream_abstract_t *) &ctx.out));
+    AVS_UNIT_ASSERT_SUCCESS(avs_stream_write((avs_stream_abstract_t *) &ctx.out,
+                                             OTHER_DATA, sizeof(OTHER_DATA)));
+
+    ctx.in.buffer_size = avs_stream_outbuf_offset(&ctx.out);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_access_control_restore(
+            anjay2, (avs_stream_abstract_t *) &ctx.in));
+    AVS_UNIT_ASSERT_TRUE(aco_equal(ac1, ac2));
+    AVS_UNIT_ASSERT_FALSE(anjay_access_control_journal_needs_compaction(anjay2));
+
+    // the data that follows is left for the application to read
+    char other_data[sizeof(OTHER_DATA)];
+    AVS_UNIT_ASSERT_SUCCESS(avs_stream_read_reliably(
+            (avs_stream_abstract_t *) &ctx.in, other_data, sizeof(other_data)));
+    AVS_UNIT_ASSERT_EQUAL_STRING(other_data, OTHER_DATA);
+
+    anjay_delete(anjay1);
+    anjay_delete(anjay2);
+
+    free((anjay_dm_object_def_t *) (intptr_t) mock_obj);
+}
+
+AVS_UNIT_TEST(access_control_persistence, journal_bytes_per_change) {
+    // Compares the amount of data that needs to be written after a single
+    // ACL change with and without the journal. Each instance takes a couple
+    // dozen bytes, so with 100 instances, a full snapshot is two orders of
+    // magnitude larger than a journal segment.
+    enum { NUM_INSTANCES = 100 };
+    anjay_t *anjay = ac_test_create_fake_anjay();
+
+    storage_ctx_t ctx = { .buffer = {} };
+    init_context(&ctx);
+
+    AVS_UNIT_ASSERT_SUCCESS(anjay_access_control_install(anjay));
+    access_control_t *ac = _anjay_access_control_get(anjay);
+    for (anjay_iid_t iid = 0; iid < NUM_INSTANCES; ++iid) {
+        AVS_UNIT_ASSERT_SUCCESS(_anjay_access_control_add_instance(
+                ac, make_instance(iid, 32, iid), NULL));
+    }
+    AVS_UNIT_ASSERT_SUCCESS(anjay_access_control_persist(
+            anjay, (avs_stream_abstract_t *) &ctx.out));
+    size_t snapshot_bytes = avs_stream_outbuf_offset(&ctx.out);
+
+    AVS_LIST_NTH(ac->current.instances, NUM_INSTANCES / 2)->acl->mask = 0x0003;
+    AVS_UNIT_ASSERT_SUCCESS(anjay_access_control_persist_changes(
+            anjay, (avs_stream_abstract_t *) &ctx.out));
+    size_t journal_bytes = avs_stream_outbuf_offset(&ctx.out) - snapshot_bytes;
+
+    AVS_UNIT_ASSERT_EQUAL(snapshot_bytes, 8 + NUM_INSTANCES * 21);
+    AVS_UNIT_ASSERT_EQUAL(journal_bytes, 34);
+
+    anjay_delete(anjay);
+}
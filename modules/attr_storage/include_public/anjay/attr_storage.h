@@ -60,16 +60,70 @@ int anjay_attr_storage_install(anjay_t *anjay);
 
 /**
  * Checks whether the attribute storage has been modified since last call to
- * @ref anjay_attr_storage_persist or @ref anjay_attr_storage_restore.
+ * @ref anjay_attr_storage_persist, @ref anjay_attr_storage_persist_changes or
+ * @ref anjay_attr_storage_restore.
  */
 bool anjay_attr_storage_is_modified(anjay_t *anjay);
 
 int anjay_attr_storage_persist(anjay_t *anjay,
                                avs_stream_abstract_t *out_stream);
 
+/**
+ * Tries to restore the attributes from given @p in_stream.
+ *
+ * The stream may contain any number of journal segments, as written by
+ * @ref anjay_attr_storage_persist_changes, following the snapshot written by
+ * @ref anjay_attr_storage_persist. They are replayed in order. A segment that
+ * cannot be read completely (e.g. because the device lost power while it was
+ * being written) is ignored along with anything that follows it, and
+ * @ref anjay_attr_storage_journal_needs_compaction returns true afterwards.
+ * Reading stops before the first byte that does not belong to the journal.
+ *
+ * @param anjay     Anjay object with the Attribute Storage installed.
+ * @param in_stream Stream to read the attributes from.
+ *
+ * @returns 0 on success, negative value in case of an error.
+ */
 int anjay_attr_storage_restore(anjay_t *anjay,
                                avs_stream_abstract_t *in_stream);
 
+/**
+ * Appends a journal segment to the @p out_stream, describing Object-level
+ * attributes and Instance entries (i.e. Instance-level and Resource-level
+ * attributes of a single Instance) changed since the last successful call to
+ * @ref anjay_attr_storage_persist, @ref anjay_attr_storage_restore or this
+ * function. Nothing is written if there were no such changes.
+ *
+ * The segment is meant to be written directly after the data persisted
+ * previously, so that the whole stream can later be passed to
+ * @ref anjay_attr_storage_restore.
+ *
+ * NOTE: To be able to determine what has changed, the module keeps a copy of
+ * the stored attributes as of the last persist/restore operation.
+ *
+ * @param anjay      Anjay object with the Attribute Storage installed.
+ * @param out_stream Stream to append the journal segment to.
+ *
+ * @returns 0 on success, negative value in case of an error, including the
+ *          case where no snapshot was previously persisted or restored. After
+ *          a failure, the persisted data shall be rewritten from scratch using
+ *          @ref anjay_attr_storage_persist.
+ */
+int anjay_attr_storage_persist_changes(anjay_t *anjay,
+                                       avs_stream_abstract_t *out_stream);
+
+/**
+ * Checks whether the journal written by
+ * @ref anjay_attr_storage_persist_changes since the last full snapshot should
+ * be compacted, i.e. rewritten from scratch using
+ * @ref anjay_attr_storage_persist.
+ *
+ * This is the case when the journal contains more records than a snapshot
+ * would contain Object and Instance entries, or when the persisted journal is
+ * known to end with a segment that cannot be replayed.
+ */
+bool anjay_attr_storage_journal_needs_compaction(anjay_t *anjay);
+
 /**
  * Sets Object level attributes for the specified @p ssid.
  *
@@ -16,9 +16,14 @@
 
 #include <config.h>
 
+#include <math.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
+#include <avsystem/commons/stream/stream_inbuf.h>
+#include <avsystem/commons/stream_v_table.h>
+
 #include <anjay_modules/dm_utils.h>
 #include <anjay_modules/io_utils.h>
 #include <anjay_modules/raw_buffer.h>
@@ -53,9 +58,9 @@ static int handle_resource_attributes(anjay_persistence_context_t *ctx,
     return retval;
 }
 
-static int handle_custom_attributes(anjay_persistence_context_t *ctx,
-                                    anjay_dm_internal_attrs_t *attrs,
-                                    int version) {
+static int handle_con_attribute(anjay_persistence_context_t *ctx,
+                                anjay_dm_internal_attrs_t *attrs,
+                                int version) {
     int retval = 0;
     int8_t con = ANJAY_DM_CON_ATTR_DEFAULT;
     if (version >= 2) {
@@ -81,6 +86,39 @@ static int handle_custom_attributes(anjay_persistence_context_t *ctx,
     return retval;
 }
 
+static int handle_eval_period_attributes(anjay_persistence_context_t *ctx,
+                                         anjay_dm_internal_attrs_t *attrs,
+                                         int version) {
+    int retval = 0;
+    time_t min_eval_period = ANJAY_ATTRIB_PERIOD_NONE;
+    time_t max_eval_period = ANJAY_ATTRIB_PERIOD_NONE;
+    if (version >= 3) {
+        (void) attrs;
+#ifdef WITH_EVAL_PERIOD_ATTRS
+        min_eval_period = attrs->custom.data.min_eval_period;
+        max_eval_period = attrs->custom.data.max_eval_period;
+#endif // WITH_EVAL_PERIOD_ATTRS
+        (void) ((retval = anjay_persistence_time(ctx, &min_eval_period))
+                || (retval = anjay_persistence_time(ctx, &max_eval_period)));
+    }
+#ifdef WITH_EVAL_PERIOD_ATTRS
+    if (!retval) {
+        attrs->custom.data.min_eval_period = min_eval_period;
+        attrs->custom.data.max_eval_period = max_eval_period;
+    }
+#endif // WITH_EVAL_PERIOD_ATTRS
+    return retval;
+}
+
+static int handle_custom_attributes(anjay_persistence_context_t *ctx,
+                                    anjay_dm_internal_attrs_t *attrs,
+                                    int version) {
+    int retval;
+    (void) ((retval = handle_con_attribute(ctx, attrs, version))
+            || (retval = handle_eval_period_attributes(ctx, attrs, version)));
+    return retval;
+}
+
 static int handle_internal_attrs(anjay_persistence_context_t *ctx,
                                  anjay_dm_internal_attrs_t *attrs,
                                  int version) {
@@ -162,22 +200,6 @@ static int handle_object(anjay_persistence_context_t *ctx,
 
 // HELPERS /////////////////////////////////////////////////////////////////////
 
-static int stream_at_end(avs_stream_abstract_t *in) {
-    if (avs_stream_peek(in, 0) != EOF) {
-        return 0; // data ahead
-    }
-
-    size_t bytes_read;
-    char message_finished;
-    char value;
-    int result = avs_stream_read(in, &bytes_read, &message_finished,
-                                 &value, sizeof(value));
-    if (!result && !bytes_read && message_finished) {
-        return 1;
-    }
-    return result < 0 ? result : -1;
-}
-
 static bool is_attrs_list_sane(AVS_LIST(void) attrs_list,
                                size_t attrs_field_offset,
                                is_empty_func_t *is_empty_func) {
@@ -342,6 +364,505 @@ static int clear_nonexistent_entries(anjay_t *anjay,
     return 0;
 }
 
+//// JOURNAL ///////////////////////////////////////////////////////////////////
+
+static const char JOURNAL_MAGIC[] = { 'F', 'A', 'J', '\1' };
+
+/**
+ * A single journal record replaces either the Object-level default attributes
+ * (if instance.iid is ANJAY_IID_INVALID) or a whole Instance entry. Empty lists
+ * denote removal.
+ */
+typedef struct {
+    anjay_oid_t oid;
+    fas_instance_entry_t instance;
+} journal_record_t;
+
+static void clear_instance_entry(fas_instance_entry_t *instance) {
+    AVS_LIST_CLEAR(&instance->default_attrs);
+    AVS_LIST_CLEAR(&instance->resources) {
+        AVS_LIST_CLEAR(&instance->resources->attrs);
+    }
+}
+
+static void clear_journal_records(AVS_LIST(journal_record_t) *records) {
+    AVS_LIST_CLEAR(records) {
+        clear_instance_entry(&(*records)->instance);
+    }
+}
+
+static int clone_instance(fas_instance_entry_t *dest,
+                          const fas_instance_entry_t *src) {
+    dest->iid = src->iid;
+    if (src->default_attrs
+            && !(dest->default_attrs =
+                         AVS_LIST_SIMPLE_CLONE(src->default_attrs))) {
+        return -1;
+    }
+    AVS_LIST(fas_resource_entry_t) *dest_tail = &dest->resources;
+    AVS_LIST(fas_resource_entry_t) src_resource;
+    AVS_LIST_FOREACH(src_resource, src->resources) {
+        if (!(*dest_tail = AVS_LIST_NEW_ELEMENT(fas_resource_entry_t))) {
+            return -1;
+        }
+        (*dest_tail)->rid = src_resource->rid;
+        if (src_resource->attrs
+                && !((*dest_tail)->attrs =
+                             AVS_LIST_SIMPLE_CLONE(src_resource->attrs))) {
+            return -1;
+        }
+        dest_tail = AVS_LIST_NEXT_PTR(dest_tail);
+    }
+    return 0;
+}
+
+static int clone_objects(AVS_LIST(fas_object_entry_t) *dest,
+                         AVS_LIST(fas_object_entry_t) src) {
+    assert(!*dest);
+    AVS_LIST(fas_object_entry_t) *dest_tail = dest;
+    AVS_LIST(fas_object_entry_t) src_object;
+    AVS_LIST_FOREACH(src_object, src) {
+        if (!(*dest_tail = AVS_LIST_NEW_ELEMENT(fas_object_entry_t))) {
+            goto error;
+        }
+        (*dest_tail)->oid = src_object->oid;
+        AVS_LIST(fas_default_attrs_t) src_attrs = src_object->default_attrs;
+        if (src_attrs
+                && !((*dest_tail)->default_attrs =
+                             AVS_LIST_SIMPLE_CLONE(src_attrs))) {
+            goto error;
+        }
+        AVS_LIST(fas_instance_entry_t) *dest_instance_tail =
+                &(*dest_tail)->instances;
+        AVS_LIST(fas_instance_entry_t) src_instance;
+        AVS_LIST_FOREACH(src_instance, src_object->instances) {
+            if (!(*dest_instance_tail =
+                          AVS_LIST_NEW_ELEMENT(fas_instance_entry_t))
+                    || clone_instance(*dest_instance_tail, src_instance)) {
+                goto error;
+            }
+            dest_instance_tail = AVS_LIST_NEXT_PTR(dest_instance_tail);
+        }
+        dest_tail = AVS_LIST_NEXT_PTR(dest_tail);
+    }
+    return 0;
+error:
+    _anjay_attr_storage_clear_objects(dest);
+    return -1;
+}
+
+static void reset_journal_base(anjay_attr_storage_t *fas) {
+    _anjay_attr_storage_clear_objects(&fas->journal.base);
+    fas->journal.records = 0;
+    fas->journal.damaged = false;
+    fas->journal.has_base = !clone_objects(&fas->journal.base, fas->objects);
+    if (!fas->journal.has_base) {
+        fas_log(WARNING, "out of memory, changes cannot be journaled until the "
+                         "next full persist");
+    }
+}
+
+static bool same_value(double a, double b) {
+    return a == b || (isnan(a) && isnan(b));
+}
+
+static bool same_internal_attrs(const anjay_dm_internal_attrs_t *a,
+                                const anjay_dm_internal_attrs_t *b) {
+    return a->standard.min_period == b->standard.min_period
+            && a->standard.max_period == b->standard.max_period
+#ifdef WITH_CON_ATTR
+            && a->custom.data.con == b->custom.data.con
+#endif
+#ifdef WITH_EVAL_PERIOD_ATTRS
+            && a->custom.data.min_eval_period == b->custom.data.min_eval_period
+            && a->custom.data.max_eval_period == b->custom.data.max_eval_period
+#endif
+            ;
+}
+
+static bool same_internal_res_attrs(const anjay_dm_internal_res_attrs_t *a,
+                                    const anjay_dm_internal_res_attrs_t *b) {
+    return same_internal_attrs(
+                    _anjay_dm_get_internal_attrs_const(&a->standard.common),
+                    _anjay_dm_get_internal_attrs_const(&b->standard.common))
+            && same_value(a->standard.greater_than, b->standard.greater_than)
+            && same_value(a->standard.less_than, b->standard.less_than)
+            && same_value(a->standard.step, b->standard.step);
+}
+
+static bool same_default_attrs(AVS_LIST(fas_default_attrs_t) a,
+                               AVS_LIST(fas_default_attrs_t) b) {
+    while (a && b) {
+        if (a->ssid != b->ssid || !same_internal_attrs(&a->attrs, &b->attrs)) {
+            return false;
+        }
+        a = AVS_LIST_NEXT(a);
+        b = AVS_LIST_NEXT(b);
+    }
+    return !a && !b;
+}
+
+static bool same_resource_attrs(AVS_LIST(fas_resource_attrs_t) a,
+                                AVS_LIST(fas_resource_attrs_t) b) {
+    while (a && b) {
+        if (a->ssid != b->ssid
+                || !same_internal_res_attrs(&a->attrs, &b->attrs)) {
+            return false;
+        }
+        a = AVS_LIST_NEXT(a);
+        b = AVS_LIST_NEXT(b);
+    }
+    return !a && !b;
+}
+
+static bool same_instance(const fas_instance_entry_t *a,
+                          const fas_instance_entry_t *b) {
+    if (!same_default_attrs(a->default_attrs, b->default_attrs)) {
+        return false;
+    }
+    AVS_LIST(fas_resource_entry_t) a_resource = a->resources;
+    AVS_LIST(fas_resource_entry_t) b_resource = b->resources;
+    while (a_resource && b_resource) {
+        if (a_resource->rid != b_resource->rid
+                || !same_resource_attrs(a_resource->attrs, b_resource->attrs)) {
+            return false;
+        }
+        a_resource = AVS_LIST_NEXT(a_resource);
+        b_resource = AVS_LIST_NEXT(b_resource);
+    }
+    return !a_resource && !b_resource;
+}
+
+static int handle_journal_record(anjay_persistence_context_t *ctx,
+                                 journal_record_t *record) {
+    int retval;
+    (void) ((retval = anjay_persistence_u16(ctx, &record->oid))
+            || (retval = anjay_persistence_u16(ctx, &record->instance.iid))
+            || (retval = HANDLE_LIST(default_attrs, ctx,
+                                     &record->instance.default_attrs,
+                                     (void *) 3)));
+    if (!retval && record->instance.iid != ANJAY_IID_INVALID) {
+        retval = HANDLE_LIST(resource_entry, ctx, &record->instance.resources,
+                             (void *) 3);
+    }
+    return retval;
+}
+
+static int
+persist_instance_changes(anjay_persistence_context_t *ctx,
+                         anjay_oid_t oid,
+                         AVS_LIST(fas_instance_entry_t) old_instances,
+                         AVS_LIST(fas_instance_entry_t) new_instances,
+                         uint32_t *inout_count) {
+    while (old_instances || new_instances) {
+        journal_record_t record = {
+            .oid = oid
+        };
+        bool changed = true;
+        if (!old_instances
+                || (new_instances && new_instances->iid < old_instances->iid)) {
+            record.instance = *new_instances;
+            new_instances = AVS_LIST_NEXT(new_instances);
+        } else if (!new_instances
+                || old_instances->iid < new_instances->iid) {
+            record.instance.iid = old_instances->iid;
+            old_instances = AVS_LIST_NEXT(old_instances);
+        } else {
+            changed = !same_instance(old_instances, new_instances);
+            record.instance = *new_instances;
+            old_instances = AVS_LIST_NEXT(old_instances);
+            new_instances = AVS_LIST_NEXT(new_instances);
+        }
+        if (changed) {
+            int retval = handle_journal_record(ctx, &record);
+            if (retval) {
+                return retval;
+            }
+            ++*inout_count;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Walks both object lists (which are kept sorted by OID, with Instance lists
+ * sorted by IID) in parallel, writing a journal record for each difference to
+ * @p ctx . The number of records is returned via @p out_count .
+ */
+static int persist_changes(anjay_persistence_context_t *ctx,
+                           AVS_LIST(fas_object_entry_t) old_objects,
+                           AVS_LIST(fas_object_entry_t) new_objects,
+                           uint32_t *out_count) {
+    static const fas_object_entry_t EMPTY_OBJECT = { 0 };
+    *out_count = 0;
+    while (old_objects || new_objects) {
+        const fas_object_entry_t *old_object = &EMPTY_OBJECT;
+        const fas_object_entry_t *new_object = &EMPTY_OBJECT;
+        anjay_oid_t oid;
+        if (!old_objects
+                || (new_objects && new_objects->oid < old_objects->oid)) {
+            oid = new_objects->oid;
+            new_object = new_objects;
+            new_objects = AVS_LIST_NEXT(new_objects);
+        } else if (!new_objects || old_objects->oid < new_objects->oid) {
+            oid = old_objects->oid;
+            old_object = old_objects;
+            old_objects = AVS_LIST_NEXT(old_objects);
+        } else {
+            oid = new_objects->oid;
+            old_object = old_objects;
+            new_object = new_objects;
+            old_objects = AVS_LIST_NEXT(old_objects);
+            new_objects = AVS_LIST_NEXT(new_objects);
+        }
+        int retval;
+        if (!same_default_attrs(old_object->default_attrs,
+                                new_object->default_attrs)) {
+            journal_record_t record = {
+                .oid = oid,
+                .instance = {
+                    .iid = ANJAY_IID_INVALID,
+                    .default_attrs = new_object->default_attrs
+                }
+            };
+            if ((retval = handle_journal_record(ctx, &record))) {
+                return retval;
+            }
+            ++*out_count;
+        }
+        if ((retval = persist_instance_changes(ctx, oid,
+                                               old_object->instances,
+                                               new_object->instances,
+                                               out_count))) {
+            return retval;
+        }
+    }
+    return 0;
+}
+
+typedef struct {
+    const avs_stream_v_table_t *const vtable;
+    size_t bytes_written;
+} byte_counter_t;
+
+static int byte_counter_write(avs_stream_abstract_t *stream,
+                              const void *data,
+                              size_t *data_length) {
+    (void) data;
+    ((byte_counter_t *) stream)->bytes_written += *data_length;
+    return 0;
+}
+
+static int unimplemented() {
+    return -1;
+}
+
+/**
+ * Determines the number of journal records persist_changes() would write and
+ * their total size in bytes, without writing anything.
+ */
+static int measure_changes(AVS_LIST(fas_object_entry_t) old_objects,
+                           AVS_LIST(fas_object_entry_t) new_objects,
+                           uint32_t *out_count,
+                           uint32_t *out_length) {
+    static const avs_stream_v_table_t VTABLE = {
+        byte_counter_write,
+        (avs_stream_finish_message_t) unimplemented,
+        (avs_stream_read_t) unimplemented,
+        (avs_stream_peek_t) unimplemented,
+        (avs_stream_reset_t) unimplemented,
+        (avs_stream_close_t) unimplemented,
+        (avs_stream_errno_t) unimplemented,
+        NULL
+    };
+    byte_counter_t counter = { &VTABLE, 0 };
+    anjay_persistence_context_t *ctx = anjay_persistence_store_context_new(
+            (avs_stream_abstract_t *) &counter);
+    if (!ctx) {
+        fas_log(ERROR, "Out of memory");
+        return -1;
+    }
+    int retval = persist_changes(ctx, old_objects, new_objects, out_count);
+    anjay_persistence_context_delete(ctx);
+    if (!retval && counter.bytes_written > UINT32_MAX) {
+        fas_log(ERROR, "journal segment too large");
+        retval = -1;
+    }
+    *out_length = (uint32_t) counter.bytes_written;
+    return retval;
+}
+
+static int read_journal_records(anjay_persistence_context_t *ctx,
+                                uint32_t count,
+                                AVS_LIST(journal_record_t) *out_records) {
+    AVS_LIST(journal_record_t) *tail = out_records;
+    while (count--) {
+        if (!(*tail = AVS_LIST_NEW_ELEMENT(journal_record_t))) {
+            fas_log(ERROR, "Out of memory");
+            return -1;
+        }
+        int retval = handle_journal_record(ctx, *tail);
+        if (retval) {
+            return retval;
+        }
+        if (!is_attrs_list_sane((*tail)->instance.default_attrs,
+                                offsetof(fas_default_attrs_t, attrs),
+                                default_attrs_empty)
+                || !is_resources_list_sane((*tail)->instance.resources)) {
+            return -1;
+        }
+        tail = AVS_LIST_NEXT_PTR(tail);
+    }
+    return 0;
+}
+
+static bool journal_segment_ahead(avs_stream_abstract_t *in) {
+    for (size_t i = 0; i < sizeof(JOURNAL_MAGIC); ++i) {
+        if (avs_stream_peek(in, i) != JOURNAL_MAGIC[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Reads a single journal segment. Its header states the size of the records
+ * that follow, so they are parsed from a separate buffer and a corrupted
+ * segment can never cause more than that to be consumed from @p in .
+ */
+static int read_journal_segment(avs_stream_abstract_t *in,
+                                anjay_persistence_context_t *ctx,
+                                AVS_LIST(journal_record_t) *out_records) {
+    char magic[sizeof(JOURNAL_MAGIC)];
+    uint32_t count;
+    uint32_t length;
+    if (avs_stream_read_reliably(in, magic, sizeof(magic))
+            || anjay_persistence_u32(ctx, &count)
+            || anjay_persistence_u32(ctx, &length)
+            || !count || !length) {
+        return -1;
+    }
+    char *buffer = (char *) malloc(length);
+    if (!buffer) {
+        fas_log(ERROR, "Out of memory");
+        return -1;
+    }
+    avs_stream_inbuf_t records = AVS_STREAM_INBUF_STATIC_INITIALIZER;
+    avs_stream_inbuf_set_buffer(&records, buffer, length);
+    anjay_persistence_context_t *records_ctx = NULL;
+    int retval = -1;
+    if (!avs_stream_read_reliably(in, buffer, length)
+            && (records_ctx = anjay_persistence_restore_context_new(
+                        (avs_stream_abstract_t *) &records))
+            && !(retval = read_journal_records(records_ctx, count,
+                                               out_records))
+            && _anjay_stream_at_end((avs_stream_abstract_t *) &records) != 1) {
+        // the records do not add up to the size stated in the header
+        retval = -1;
+    }
+    anjay_persistence_context_delete(records_ctx);
+    free(buffer);
+    return retval;
+}
+
+static int apply_journal_record(anjay_attr_storage_t *fas,
+                                journal_record_t *record) {
+    AVS_LIST(fas_object_entry_t) *object_ptr;
+    AVS_LIST_FOREACH_PTR(object_ptr, &fas->objects) {
+        if ((*object_ptr)->oid >= record->oid) {
+            break;
+        }
+    }
+    if (!*object_ptr || (*object_ptr)->oid != record->oid) {
+        AVS_LIST(fas_object_entry_t) object =
+                AVS_LIST_NEW_ELEMENT(fas_object_entry_t);
+        if (!object) {
+            fas_log(ERROR, "Out of memory");
+            return -1;
+        }
+        object->oid = record->oid;
+        AVS_LIST_INSERT(object_ptr, object);
+    }
+
+    int retval = 0;
+    if (record->instance.iid == ANJAY_IID_INVALID) {
+        AVS_LIST_CLEAR(&(*object_ptr)->default_attrs);
+        (*object_ptr)->default_attrs = record->instance.default_attrs;
+        record->instance.default_attrs = NULL;
+    } else {
+        AVS_LIST(fas_instance_entry_t) *instance_ptr;
+        AVS_LIST_FOREACH_PTR(instance_ptr, &(*object_ptr)->instances) {
+            if ((*instance_ptr)->iid >= record->instance.iid) {
+                break;
+            }
+        }
+        if (*instance_ptr && (*instance_ptr)->iid == record->instance.iid) {
+            clear_instance_entry(*instance_ptr);
+            AVS_LIST_DELETE(instance_ptr);
+        }
+        if (record->instance.default_attrs || record->instance.resources) {
+            AVS_LIST(fas_instance_entry_t) instance =
+                    AVS_LIST_NEW_ELEMENT(fas_instance_entry_t);
+            if (!instance) {
+                fas_log(ERROR, "Out of memory");
+                retval = -1;
+            } else {
+                *instance = record->instance;
+                record->instance.default_attrs = NULL;
+                record->instance.resources = NULL;
+                AVS_LIST_INSERT(instance_ptr, instance);
+            }
+        }
+    }
+    remove_object_if_empty(object_ptr);
+    return retval;
+}
+
+static int replay_journal(anjay_attr_storage_t *fas,
+                          avs_stream_abstract_t *in,
+                          anjay_persistence_context_t *ctx,
+                          fas_journal_t *out_journal) {
+    int retval;
+    while (!(retval = _anjay_stream_at_end(in))) {
+        if (!journal_segment_ahead(in)) {
+            // whatever the application stored after the journal; leave it
+            // unread
+            return 0;
+        }
+        AVS_LIST(journal_record_t) records = NULL;
+        if (read_journal_segment(in, ctx, &records)) {
+            // most likely a write interrupted by a power loss; the segment
+            // was never complete, so drop it along with anything after it
+            fas_log(WARNING, "ignoring incomplete journal segment");
+            clear_journal_records(&records);
+            out_journal->damaged = true;
+            return 0;
+        }
+        out_journal->records += AVS_LIST_SIZE(records);
+        AVS_LIST(journal_record_t) record;
+        AVS_LIST_FOREACH(record, records) {
+            if ((retval = apply_journal_record(fas, record))) {
+                break;
+            }
+        }
+        clear_journal_records(&records);
+        if (retval) {
+            return retval;
+        }
+    }
+    return retval < 0 ? retval : 0;
+}
+
+static size_t count_snapshot_entries(AVS_LIST(fas_object_entry_t) objects) {
+    size_t result = 0;
+    AVS_LIST(fas_object_entry_t) object;
+    AVS_LIST_FOREACH(object, objects) {
+        result += (object->default_attrs ? 1 : 0)
+                + AVS_LIST_SIZE(object->instances);
+    }
+    return result;
+}
+
 //// PUBLIC FUNCTIONS //////////////////////////////////////////////////////////
 
 /**
@@ -351,14 +872,17 @@ static int clear_nonexistent_entries(anjay_t *anjay,
  * - 0: used in development versions and up to Anjay 1.3.1
  * - 1: briefly used and released as part of Anjay 1.0.0, when the attributes
  *   were temporarily unified (i.e., Objects could have lt/gt/st attributes)
- * - 2: current version
+ * - 2: used up to the introduction of epmin/epmax attributes; contains the
+ *   "con" attribute
+ * - 3: current version; additionally contains epmin/epmax attributes
  */
 static const char MAGIC_V0[] = { 'F', 'A', 'S', '\0' };
 static const char MAGIC_V2[] = { 'F', 'A', 'S', '\2' };
+static const char MAGIC_V3[] = { 'F', 'A', 'S', '\3' };
 
 int _anjay_attr_storage_persist_inner(anjay_attr_storage_t *attr_storage,
                                       avs_stream_abstract_t *out) {
-    int retval = avs_stream_write(out, MAGIC_V2, sizeof(MAGIC_V2));
+    int retval = avs_stream_write(out, MAGIC_V3, sizeof(MAGIC_V3));
     if (retval) {
         return retval;
     }
@@ -367,22 +891,30 @@ int _anjay_attr_storage_persist_inner(anjay_attr_storage_t *attr_storage,
         fas_log(ERROR, "Out of memory");
         return -1;
     }
-    retval = HANDLE_LIST(object, ctx, &attr_storage->objects, (void *) 2);
+    retval = HANDLE_LIST(object, ctx, &attr_storage->objects, (void *) 3);
     anjay_persistence_context_delete(ctx);
     return retval;
 }
 
-int _anjay_attr_storage_restore_inner(anjay_t *anjay,
-                                      anjay_attr_storage_t *attr_storage,
-                                      avs_stream_abstract_t *in) {
+/**
+ * Reads a snapshot followed by any journal segments. @p out_journal is filled
+ * with the number of replayed records and whether the journal was damaged;
+ * has_base is set if a snapshot was actually present in the stream.
+ */
+static int restore(anjay_t *anjay,
+                   anjay_attr_storage_t *attr_storage,
+                   avs_stream_abstract_t *in,
+                   fas_journal_t *out_journal) {
     _anjay_attr_storage_clear(attr_storage);
-    int retval = stream_at_end(in);
+    int retval = _anjay_stream_at_end(in);
     if (retval) {
         return (retval < 0) ? retval : 0;
     }
 
-    AVS_STATIC_ASSERT(sizeof(MAGIC_V0) == sizeof(MAGIC_V2), magic_size);
-    char magic_buffer[sizeof(MAGIC_V2)];
+    AVS_STATIC_ASSERT(sizeof(MAGIC_V0) == sizeof(MAGIC_V2)
+                              && sizeof(MAGIC_V2) == sizeof(MAGIC_V3),
+                      magic_size);
+    char magic_buffer[sizeof(MAGIC_V3)];
     retval = avs_stream_read_reliably(in, magic_buffer, sizeof(magic_buffer));
     if (retval) {
         return retval;
@@ -393,6 +925,8 @@ int _anjay_attr_storage_restore_inner(anjay_t *anjay,
         version = 0;
     } else if (!memcmp(magic_buffer, MAGIC_V2, sizeof(MAGIC_V2))) {
         version = 2;
+    } else if (!memcmp(magic_buffer, MAGIC_V3, sizeof(MAGIC_V3))) {
+        version = 3;
     } else {
         fas_log(ERROR, "Magic value mismatch");
         return -1;
@@ -407,16 +941,27 @@ int _anjay_attr_storage_restore_inner(anjay_t *anjay,
         (void) ((retval = HANDLE_LIST(object, ctx, &attr_storage->objects,
                                       (void *) version))
                 || (retval = (is_attr_storage_sane(attr_storage) ? 0 : -1))
+                || (retval = replay_journal(attr_storage, in, ctx,
+                                            out_journal))
                 || (retval = clear_nonexistent_entries(anjay,
                                                        attr_storage)));
         anjay_persistence_context_delete(ctx);
     }
     if (retval) {
         _anjay_attr_storage_clear(attr_storage);
+    } else {
+        out_journal->has_base = true;
     }
     return retval;
 }
 
+int _anjay_attr_storage_restore_inner(anjay_t *anjay,
+                                      anjay_attr_storage_t *attr_storage,
+                                      avs_stream_abstract_t *in) {
+    fas_journal_t journal = { NULL };
+    return restore(anjay, attr_storage, in, &journal);
+}
+
 int anjay_attr_storage_persist(anjay_t *anjay, avs_stream_abstract_t *out) {
     anjay_attr_storage_t *fas = _anjay_attr_storage_get(anjay);
     if (!fas) {
@@ -427,10 +972,73 @@ int anjay_attr_storage_persist(anjay_t *anjay, avs_stream_abstract_t *out) {
     int retval = _anjay_attr_storage_persist_inner(fas, out);
     if (!retval) {
         fas->modified_since_persist = false;
+        reset_journal_base(fas);
     }
     return retval;
 }
 
+int anjay_attr_storage_persist_changes(anjay_t *anjay,
+                                       avs_stream_abstract_t *out) {
+    anjay_attr_storage_t *fas = _anjay_attr_storage_get(anjay);
+    if (!fas) {
+        fas_log(ERROR,
+                "Attribute Storage is not installed on this Anjay object");
+        return -1;
+    }
+    if (!fas->journal.has_base) {
+        fas_log(ERROR, "no persisted state to append changes to");
+        return -1;
+    }
+
+    uint32_t count;
+    uint32_t length;
+    int retval = measure_changes(fas->journal.base, fas->objects,
+                                 &count, &length);
+    if (retval || !count) {
+        if (!retval) {
+            fas->modified_since_persist = false;
+        }
+        return retval;
+    }
+
+    AVS_LIST(fas_object_entry_t) new_base = NULL;
+    if (clone_objects(&new_base, fas->objects)) {
+        fas_log(ERROR, "Out of memory");
+        return -1;
+    }
+    anjay_persistence_context_t *ctx = anjay_persistence_store_context_new(out);
+    if (!ctx) {
+        fas_log(ERROR, "Out of memory");
+        _anjay_attr_storage_clear_objects(&new_base);
+        return -1;
+    }
+    (void) ((retval = avs_stream_write(out, JOURNAL_MAGIC,
+                                       sizeof(JOURNAL_MAGIC)))
+            || (retval = anjay_persistence_u32(ctx, &count))
+            || (retval = anjay_persistence_u32(ctx, &length))
+            || (retval = persist_changes(ctx, fas->journal.base, fas->objects,
+                                         &count)));
+    anjay_persistence_context_delete(ctx);
+    if (retval) {
+        // a partially written segment will not be replayed
+        fas->journal.damaged = true;
+        _anjay_attr_storage_clear_objects(&new_base);
+        return retval;
+    }
+    _anjay_attr_storage_clear_objects(&fas->journal.base);
+    fas->journal.base = new_base;
+    fas->journal.records += count;
+    fas->modified_since_persist = false;
+    return 0;
+}
+
+bool anjay_attr_storage_journal_needs_compaction(anjay_t *anjay) {
+    anjay_attr_storage_t *fas = _anjay_attr_storage_get(anjay);
+    return fas && (fas->journal.damaged
+                   || fas->journal.records
+                              > count_snapshot_entries(fas->objects));
+}
+
 int anjay_attr_storage_restore(anjay_t *anjay, avs_stream_abstract_t *in) {
     anjay_attr_storage_t *fas = _anjay_attr_storage_get(anjay);
     if (!fas) {
@@ -438,8 +1046,18 @@ int anjay_attr_storage_restore(anjay_t *anjay, avs_stream_abstract_t *in) {
                 "Attribute Storage is not installed on this Anjay object");
         return -1;
     }
-    int retval = _anjay_attr_storage_restore_inner(anjay, fas, in);
+    fas_journal_t journal = { NULL };
+    int retval = restore(anjay, fas, in, &journal);
     fas->modified_since_persist = (retval != 0);
+    if (!retval && journal.has_base) {
+        reset_journal_base(fas);
+        fas->journal.records = journal.records;
+        fas->journal.damaged = journal.damaged;
+    } else {
+        // there is nothing that changes could be appended to
+        _anjay_attr_storage_clear_objects(&fas->journal.base);
+        fas->journal = (fas_journal_t) { NULL };
+    }
     return retval;
 }
 
@@ -51,6 +51,7 @@ static void fas_delete(anjay_t *anjay, void *fas_) {
     anjay_attr_storage_t *fas = (anjay_attr_storage_t *) fas_;
     assert(fas);
     _anjay_attr_storage_clear(fas);
+    _anjay_attr_storage_clear_objects(&fas->journal.base);
     avs_stream_cleanup(&fas->saved_state.persist_data);
     free(fas);
 }
@@ -117,6 +118,18 @@ void _anjay_attr_storage_clear(anjay_attr_storage_t *fas) {
     }
 }
 
+void _anjay_attr_storage_clear_objects(AVS_LIST(fas_object_entry_t) *objects) {
+    AVS_LIST_CLEAR(objects) {
+        AVS_LIST_CLEAR(&(*objects)->default_attrs);
+        AVS_LIST_CLEAR(&(*objects)->instances) {
+            AVS_LIST_CLEAR(&(*objects)->instances->default_attrs);
+            AVS_LIST_CLEAR(&(*objects)->instances->resources) {
+                AVS_LIST_CLEAR(&(*objects)->instances->resources->attrs);
+            }
+        }
+    }
+}
+
 //// HELPERS ///////////////////////////////////////////////////////////////////
 
 static bool implements_any_object_default_attrs_handlers(
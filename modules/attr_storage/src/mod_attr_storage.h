@@ -65,17 +65,35 @@ typedef struct {
     bool modified_since_persist;
 } fas_saved_state_t;
 
+typedef struct {
+    // state as of the last persisted snapshot or journal segment; changes
+    // against it are what anjay_attr_storage_persist_changes() writes
+    AVS_LIST(fas_object_entry_t) base;
+    bool has_base;
+    size_t records;
+    // set if the persisted journal is known to end with a segment that
+    // cannot be replayed
+    bool damaged;
+} fas_journal_t;
+
 typedef struct {
     AVS_LIST(fas_object_entry_t) objects;
     bool modified_since_persist;
     fas_iteration_state_t iteration;
     fas_saved_state_t saved_state;
+    fas_journal_t journal;
 } anjay_attr_storage_t;
 
 extern const anjay_dm_module_t _anjay_attr_storage_MODULE;
 
 void _anjay_attr_storage_clear(anjay_attr_storage_t *fas);
 
+/**
+ * Frees @p objects along with all the attributes stored in them, without
+ * marking anything as modified.
+ */
+void _anjay_attr_storage_clear_objects(AVS_LIST(fas_object_entry_t) *objects);
+
 anjay_attr_storage_t *_anjay_attr_storage_get(anjay_t *anjay);
 
 void _anjay_attr_storage_remove_instances_not_on_sorted_list(
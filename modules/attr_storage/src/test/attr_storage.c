@@ -23,6 +23,9 @@
 
 #include <anjay_test/dm.h>
 
+#include "../../../../src/anjay_core.h"
+#include "../../../../src/coap/content_format.h"
+
 #include "attr_storage_test.h"
 
 #include <string.h>
@@ -2107,3 +2110,103 @@ AVS_UNIT_TEST(set_attribs, fail_on_invalid_rid) {
 
     DM_TEST_FINISH;
 }
+
+#ifdef WITH_OBSERVE
+static time_t time_to_next_job_s(anjay_t *anjay) {
+    avs_time_duration_t delay;
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_sched_time_to_next(anjay->sched, &delay));
+    return delay.seconds;
+}
+
+static void expect_stored_attrs_read(anjay_t *anjay) {
+    _anjay_mock_dm_expect_instance_present(anjay, &OBJ_NOATTRS, 69, 1);
+    _anjay_mock_dm_expect_resource_present(anjay, &OBJ_NOATTRS, 69, 4, 1);
+}
+
+static void set_stored_periods(anjay_t *anjay,
+                               int32_t min_period,
+                               int32_t max_period) {
+    // presence checks made by anjay_attr_storage_set_resource_attrs()
+    expect_stored_attrs_read(anjay);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_attr_storage_set_resource_attrs(
+            anjay, 14, OBJ_NOATTRS->oid, 69, 4,
+            &(const anjay_dm_resource_attributes_t) {
+                .common = {
+                    .min_period = min_period,
+                    .max_period = max_period
+                },
+                .greater_than = ANJAY_ATTRIB_VALUE_NONE,
+                .less_than = ANJAY_ATTRIB_VALUE_NONE,
+                .step = ANJAY_ATTRIB_VALUE_NONE
+            }));
+}
+
+static void expect_unchanged_value_evaluated(anjay_t *anjay) {
+    _anjay_mock_dm_expect_instance_it(anjay, &FAKE_SERVER, 0, 0, 14);
+    _anjay_mock_dm_expect_resource_present(anjay, &FAKE_SERVER, 14,
+                                           ANJAY_DM_RID_SERVER_SSID, 1);
+    _anjay_mock_dm_expect_resource_read(anjay, &FAKE_SERVER, 14,
+                                        ANJAY_DM_RID_SERVER_SSID, 0,
+                                        ANJAY_MOCK_DM_INT(0, 14));
+    _anjay_mock_dm_expect_resource_present(
+            anjay, &FAKE_SERVER, 14, ANJAY_DM_RID_SERVER_NOTIFICATION_STORING,
+            1);
+    _anjay_mock_dm_expect_resource_read(
+            anjay, &FAKE_SERVER, 14, ANJAY_DM_RID_SERVER_NOTIFICATION_STORING,
+            0, ANJAY_MOCK_DM_BOOL(0, true));
+    expect_stored_attrs_read(anjay);
+    _anjay_mock_dm_expect_instance_present(anjay, &OBJ_NOATTRS, 69, 1);
+    _anjay_mock_dm_expect_resource_present(anjay, &OBJ_NOATTRS, 69, 4, 1);
+    _anjay_mock_dm_expect_resource_read(anjay, &OBJ_NOATTRS, 69, 4, 0,
+                                        ANJAY_MOCK_DM_STRING(0, "514"));
+}
+
+AVS_UNIT_TEST(set_attribs, observation_rescheduled) {
+    DM_TEST_INIT_GENERIC((&OBJ_NOATTRS, &FAKE_SECURITY, &FAKE_SERVER), (14),
+                         ());
+    AVS_UNIT_ASSERT_SUCCESS(anjay_attr_storage_install(anjay));
+    set_stored_periods(anjay, 1, 60);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+
+    expect_stored_attrs_read(anjay);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_observe_put_entry(
+            anjay, &(const anjay_observe_key_t) {
+                { 14, ANJAY_CONNECTION_UDP }, OBJ_NOATTRS->oid, 69, 4,
+                AVS_COAP_FORMAT_NONE
+            }, &(const anjay_msg_details_t) {
+                .msg_type = AVS_COAP_MSG_ACKNOWLEDGEMENT,
+                .msg_code = AVS_COAP_CODE_CONTENT,
+                .format = ANJAY_COAP_FORMAT_PLAINTEXT,
+                .observe_serial = true
+            }, &(const avs_coap_msg_identity_t) { 0 }, 514.0, "514", 3));
+    _anjay_mock_dm_expect_clean();
+    AVS_UNIT_ASSERT_EQUAL(time_to_next_job_s(anjay), 60);
+
+    ////// FIRST CHANGE: VALUE RE-EVALUATED, NEW PMAX APPLIED //////
+    set_stored_periods(anjay, 1, 30);
+    expect_stored_attrs_read(anjay);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+    _anjay_mock_dm_expect_clean();
+    AVS_UNIT_ASSERT_EQUAL(time_to_next_job_s(anjay), 1);
+
+    _anjay_mock_clock_advance(avs_time_duration_from_scalar(1, AVS_TIME_S));
+    expect_unchanged_value_evaluated(anjay);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+    _anjay_mock_dm_expect_clean();
+    AVS_UNIT_ASSERT_EQUAL(time_to_next_job_s(anjay), 29);
+
+    ////// SECOND CHANGE: RESCHEDULED AGAIN //////
+    set_stored_periods(anjay, 1, 20);
+    expect_stored_attrs_read(anjay);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+    _anjay_mock_dm_expect_clean();
+    AVS_UNIT_ASSERT_EQUAL(time_to_next_job_s(anjay), 0);
+
+    expect_unchanged_value_evaluated(anjay);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+    _anjay_mock_dm_expect_clean();
+    AVS_UNIT_ASSERT_EQUAL(time_to_next_job_s(anjay), 19);
+
+    DM_TEST_FINISH;
+}
+#endif // WITH_OBSERVE
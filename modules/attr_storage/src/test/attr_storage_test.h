@@ -125,6 +125,10 @@ test_object_entry(anjay_oid_t oid,
 static void assert_attrs_equal(const anjay_dm_internal_attrs_t *actual,
                                const anjay_dm_internal_attrs_t *expected) {
     AVS_UNIT_ASSERT_EQUAL(actual->custom.data.con, expected->custom.data.con);
+    AVS_UNIT_ASSERT_EQUAL(actual->custom.data.min_eval_period,
+                          expected->custom.data.min_eval_period);
+    AVS_UNIT_ASSERT_EQUAL(actual->custom.data.max_eval_period,
+                          expected->custom.data.max_eval_period);
     AVS_UNIT_ASSERT_EQUAL(actual->standard.min_period,
                           expected->standard.min_period);
     AVS_UNIT_ASSERT_EQUAL(actual->standard.max_period,
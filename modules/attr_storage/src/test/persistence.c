@@ -52,12 +52,13 @@
 
 #define MAGIC_HEADER_V0 "FAS\0"
 #define MAGIC_HEADER_V2 "FAS\2"
+#define MAGIC_HEADER_V3 "FAS\3"
 
 AVS_UNIT_TEST(attr_storage_persistence, persist_empty) {
     PERSIST_TEST_INIT(256);
     AVS_UNIT_ASSERT_SUCCESS(anjay_attr_storage_persist(
             anjay, (avs_stream_abstract_t *) &outbuf));
-    PERSIST_TEST_CHECK(MAGIC_HEADER_V2 "\x00\x00\x00\x00");
+    PERSIST_TEST_CHECK(MAGIC_HEADER_V3 "\x00\x00\x00\x00");
 }
 
 #define INSTALL_FAKE_OBJECT(Oid, ...) \
@@ -112,7 +113,9 @@ static void persist_test_fill(anjay_t *anjay) {
                     &(const anjay_dm_internal_attrs_t) {
                         .custom = {
                             .data = {
-                                .con = ANJAY_DM_CON_ATTR_NON
+                                .con = ANJAY_DM_CON_ATTR_NON,
+                                .min_eval_period = 5,
+                                .max_eval_period = 60
                             }
                         },
                         .standard = {
@@ -140,7 +143,9 @@ static void persist_test_fill(anjay_t *anjay) {
                     &(const anjay_dm_internal_res_attrs_t) {
                         .custom = {
                             .data = {
-                                .con = ANJAY_DM_CON_ATTR_CON
+                                .con = ANJAY_DM_CON_ATTR_CON,
+                                .min_eval_period = ANJAY_ATTRIB_PERIOD_NONE,
+                                .max_eval_period = ANJAY_ATTRIB_PERIOD_NONE
                             }
                         },
                         .standard = {
@@ -181,8 +186,16 @@ static void persist_test_fill(anjay_t *anjay) {
                     });
 }
 
+static fas_default_attrs_t *with_eval_periods(fas_default_attrs_t *attrs,
+                                              time_t min_eval_period,
+                                              time_t max_eval_period) {
+    attrs->attrs.custom.data.min_eval_period = min_eval_period;
+    attrs->attrs.custom.data.max_eval_period = max_eval_period;
+    return attrs;
+}
+
 static const char PERSIST_TEST_DATA[] =
-        MAGIC_HEADER_V2
+        MAGIC_HEADER_V3
         "\x00\x00\x00\x03" // 3 objects
             "\x00\x04" // OID 4
                 "\x00\x00\x00\x02" // 2 object-level default attrs
@@ -190,10 +203,14 @@ static const char PERSIST_TEST_DATA[] =
                         "\xFF\xFF\xFF\xFF" // min period
                         "\x00\x00\x00\x03" // max period
                         "\xFF" // confirmable
+                        "\xFF\xFF\xFF\xFF" // min eval period
+                        "\xFF\xFF\xFF\xFF" // max eval period
                     "\x00\x21" // SSID 33
                         "\x00\x00\x00\x2A" // min period
                         "\xFF\xFF\xFF\xFF" // max period
                         "\x00" // confirmable
+                        "\x00\x00\x00\x05" // min eval period
+                        "\x00\x00\x00\x3C" // max eval period
                 "\x00\x00\x00\x00" // 0 instance entries
             "\x00\x2A" // OID 42
                 "\x00\x00\x00\x00" // 0 object-level default attrs
@@ -204,6 +221,8 @@ static const char PERSIST_TEST_DATA[] =
                                 "\x00\x00\x00\x07" // min period
                                 "\x00\x00\x00\x0D" // max period
                                 "\xFF" // confirmable
+                                "\xFF\xFF\xFF\xFF" // min eval period
+                                "\xFF\xFF\xFF\xFF" // max eval period
                         "\x00\x00\x00\x01" // 1 resource entry
                             "\x00\x03" // RID 3
                                 "\x00\x00\x00\x02" // 2 attr entries
@@ -214,6 +233,8 @@ static const char PERSIST_TEST_DATA[] =
                     /* less than */     "\xBF\xF0\x00\x00\x00\x00\x00\x00"
                     /* step */          "\x7F\xF8\x00\x00\x00\x00\x00\x00"
                                         "\x01" // confirmable
+                                        "\xFF\xFF\xFF\xFF" // min eval period
+                                        "\xFF\xFF\xFF\xFF" // max eval period
                                     "\x00\x07" // SSID 7
                                         "\x00\x00\x00\x01" // min period
                                         "\x00\x00\x00\x0E" // max period
@@ -221,6 +242,8 @@ static const char PERSIST_TEST_DATA[] =
                     /* less than */     "\x7f\xf8\x00\x00\x00\x00\x00\x00"
                     /* step */          "\x7f\xf8\x00\x00\x00\x00\x00\x00"
                                         "\xFF" // confirmable
+                                        "\xFF\xFF\xFF\xFF" // min eval period
+                                        "\xFF\xFF\xFF\xFF" // max eval period
             "\x02\x05" // OID 517
                 "\x00\x00\x00\x00" // 0 object-level default attrs
                 "\x00\x00\x00\x01" // 1 instance entry
@@ -235,7 +258,9 @@ static const char PERSIST_TEST_DATA[] =
                     /* greater than */  "\x7f\xf8\x00\x00\x00\x00\x00\x00"
                     /* less than */     "\x7f\xf8\x00\x00\x00\x00\x00\x00"
                     /* step */          "\x40\x45\x00\x00\x00\x00\x00\x00"
-                                        "\xFF"; // confirmable
+                                        "\xFF" // confirmable
+                                        "\xFF\xFF\xFF\xFF" // min eval period
+                                        "\xFF\xFF\xFF\xFF"; // max eval period
 
 AVS_UNIT_TEST(attr_storage_persistence, persist_full) {
     PERSIST_TEST_INIT(512);
@@ -369,8 +394,11 @@ AVS_UNIT_TEST(attr_storage_persistence, restore_all_objects) {
                     test_default_attrlist(
                             test_default_attrs(14, ANJAY_ATTRIB_PERIOD_NONE, 3,
                                                ANJAY_DM_CON_ATTR_DEFAULT),
-                            test_default_attrs(33, 42, ANJAY_ATTRIB_PERIOD_NONE,
-                                               ANJAY_DM_CON_ATTR_NON),
+                            with_eval_periods(
+                                    test_default_attrs(
+                                            33, 42, ANJAY_ATTRIB_PERIOD_NONE,
+                                            ANJAY_DM_CON_ATTR_NON),
+                                    5, 60),
                             NULL),
                     NULL));
 
@@ -431,6 +459,38 @@ AVS_UNIT_TEST(attr_storage_persistence, restore_all_objects) {
     PERSISTENCE_TEST_FINISH;
 }
 
+static const char V2_TEST_DATA[] =
+        MAGIC_HEADER_V2
+        "\x00\x00\x00\x01" // 1 object
+            "\x00\x04" // OID 4
+                "\x00\x00\x00\x01" // 1 object-level default attr
+                    "\x00\x21" // SSID 33
+                        "\x00\x00\x00\x2A" // min period
+                        "\xFF\xFF\xFF\xFF" // max period
+                        "\x00" // confirmable
+                "\x00\x00\x00\x00"; // 0 instance entries
+
+AVS_UNIT_TEST(attr_storage_persistence, restore_v2_data) {
+    RESTORE_TEST_INIT(V2_TEST_DATA);
+    INSTALL_FAKE_OBJECT(4, 3);
+
+    _anjay_mock_dm_expect_instance_it(anjay, &OBJ4, 0, 0,
+                                      ANJAY_IID_INVALID);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_attr_storage_restore(
+            anjay, (avs_stream_abstract_t *) &inbuf));
+
+    // data from before epmin/epmax were introduced has them unset
+    assert_object_equal(_anjay_attr_storage_get(anjay)->objects,
+            test_object_entry(
+                    4,
+                    test_default_attrlist(
+                            test_default_attrs(33, 42, ANJAY_ATTRIB_PERIOD_NONE,
+                                               ANJAY_DM_CON_ATTR_NON),
+                            NULL),
+                    NULL));
+    PERSISTENCE_TEST_FINISH;
+}
+
 static const char CLEARING_TEST_DATA[] =
         MAGIC_HEADER_V0
         "\x00\x00\x00\x02" // 2 objects
@@ -786,4 +846,126 @@ AVS_UNIT_TEST(attr_storage_persistence, restore_duplicate_oid) {
     PERSISTENCE_TEST_FINISH;
 }
 
+static size_t persist_to_buffer(anjay_t *anjay, char *out_buf, size_t size) {
+    avs_stream_outbuf_t outbuf = AVS_STREAM_OUTBUF_STATIC_INITIALIZER;
+    avs_stream_outbuf_set_buffer(&outbuf, out_buf, size);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_attr_storage_persist(
+            anjay, (avs_stream_abstract_t *) &outbuf));
+    return avs_stream_outbuf_offset(&outbuf);
+}
+
+static void write_inst_periods(anjay_t *anjay,
+                               anjay_oid_t oid,
+                               anjay_iid_t iid,
+                               time_t min_period,
+                               time_t max_period) {
+    write_inst_attrs(anjay, oid, iid, 2,
+                     &(const anjay_dm_internal_attrs_t) {
+                         _ANJAY_DM_CUSTOM_ATTRS_INITIALIZER
+                         .standard = {
+                             .min_period = min_period,
+                             .max_period = max_period
+                         }
+                     });
+}
+
+AVS_UNIT_TEST(attr_storage_persistence, journal_replay) {
+    PERSIST_TEST_INIT(1024);
+    INSTALL_FAKE_OBJECT(4, 3);
+    INSTALL_FAKE_OBJECT(42, 3);
+    INSTALL_FAKE_OBJECT(517, 3, 515);
+    persist_test_fill(anjay);
+    anjay_attr_storage_t *fas = _anjay_attr_storage_get(anjay);
+
+    // nothing to append changes to yet
+    AVS_UNIT_ASSERT_FAILED(anjay_attr_storage_persist_changes(
+            anjay, (avs_stream_abstract_t *) &outbuf));
+    AVS_UNIT_ASSERT_EQUAL(avs_stream_outbuf_offset(&outbuf), 0);
+
+    AVS_UNIT_ASSERT_SUCCESS(anjay_attr_storage_persist(
+            anjay, (avs_stream_abstract_t *) &outbuf));
+    size_t snapshot_size = avs_stream_outbuf_offset(&outbuf);
+
+    // no changes - nothing is written
+    AVS_UNIT_ASSERT_SUCCESS(anjay_attr_storage_persist_changes(
+            anjay, (avs_stream_abstract_t *) &outbuf));
+    AVS_UNIT_ASSERT_EQUAL(avs_stream_outbuf_offset(&outbuf), snapshot_size);
+
+    write_obj_attrs(anjay, 4, 14, &ANJAY_DM_INTERNAL_ATTRS_EMPTY);
+    write_inst_periods(anjay, 42, 1, 7, 14);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_attr_storage_persist_changes(
+            anjay, (avs_stream_abstract_t *) &outbuf));
+    AVS_UNIT_ASSERT_EQUAL(fas->journal.records, 2);
+    AVS_UNIT_ASSERT_FALSE(anjay_attr_storage_is_modified(anjay));
+    AVS_UNIT_ASSERT_FALSE(anjay_attr_storage_journal_needs_compaction(anjay));
+
+    // removes Instance /517/516 along with Object 517
+    write_res_attrs(anjay, 517, 516, 515, 514,
+                    &ANJAY_DM_INTERNAL_RES_ATTRS_EMPTY);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_attr_storage_persist_changes(
+            anjay, (avs_stream_abstract_t *) &outbuf));
+    AVS_UNIT_ASSERT_EQUAL(fas->journal.records, 3);
+    // only Object 4 and Instance /42/1 are left
+    AVS_UNIT_ASSERT_TRUE(anjay_attr_storage_journal_needs_compaction(anjay));
+
+    char expected[512];
+    size_t expected_size = persist_to_buffer(anjay, expected, sizeof(expected));
+
+    avs_stream_inbuf_t inbuf = AVS_STREAM_INBUF_STATIC_INITIALIZER;
+    avs_stream_inbuf_set_buffer(&inbuf, buf,
+                                avs_stream_outbuf_offset(&outbuf));
+    _anjay_mock_dm_expect_instance_it(anjay, &OBJ4, 0, 0, ANJAY_IID_INVALID);
+    _anjay_mock_dm_expect_instance_it(anjay, &OBJ42, 0, 0, 1);
+    _anjay_mock_dm_expect_instance_it(anjay, &OBJ42, 1, 0, ANJAY_IID_INVALID);
+    _anjay_mock_dm_expect_resource_present(anjay, &OBJ42, 1, 3, 1);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_attr_storage_restore(
+            anjay, (avs_stream_abstract_t *) &inbuf));
+    AVS_UNIT_ASSERT_EQUAL(fas->journal.records, 3);
+
+    char actual[512];
+    AVS_UNIT_ASSERT_EQUAL(persist_to_buffer(anjay, actual, sizeof(actual)),
+                          expected_size);
+    AVS_UNIT_ASSERT_EQUAL_BYTES_SIZED(actual, expected, expected_size);
+    PERSISTENCE_TEST_FINISH;
+}
+
+AVS_UNIT_TEST(attr_storage_persistence, journal_incomplete_segment) {
+    PERSIST_TEST_INIT(512);
+    INSTALL_FAKE_OBJECT(42, 3);
+    write_inst_periods(anjay, 42, 1, 7, 13);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_attr_storage_persist(
+            anjay, (avs_stream_abstract_t *) &outbuf));
+    write_inst_periods(anjay, 42, 2, 7, 13);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_attr_storage_persist_changes(
+            anjay, (avs_stream_abstract_t *) &outbuf));
+
+    char expected[256];
+    size_t expected_size = persist_to_buffer(anjay, expected, sizeof(expected));
+
+    write_inst_periods(anjay, 42, 3, 7, 13);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_attr_storage_persist_changes(
+            anjay, (avs_stream_abstract_t *) &outbuf));
+
+    // the last segment was cut short; the ones before it are still applied
+    avs_stream_inbuf_t inbuf = AVS_STREAM_INBUF_STATIC_INITIALIZER;
+    avs_stream_inbuf_set_buffer(&inbuf, buf,
+                                avs_stream_outbuf_offset(&outbuf) - 1);
+    _anjay_mock_dm_expect_instance_it(anjay, &OBJ42, 0, 0, 1);
+    _anjay_mock_dm_expect_instance_it(anjay, &OBJ42, 1, 0, 2);
+    _anjay_mock_dm_expect_instance_it(anjay, &OBJ42, 2, 0, ANJAY_IID_INVALID);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_attr_storage_restore(
+            anjay, (avs_stream_abstract_t *) &inbuf));
+
+    // anything appended after the broken segment would be lost
+    AVS_UNIT_ASSERT_EQUAL(_anjay_attr_storage_get(anjay)->journal.records, 1);
+    AVS_UNIT_ASSERT_TRUE(anjay_attr_storage_journal_needs_compaction(anjay));
+
+    char actual[256];
+    AVS_UNIT_ASSERT_EQUAL(persist_to_buffer(anjay, actual, sizeof(actual)),
+                          expected_size);
+    AVS_UNIT_ASSERT_EQUAL_BYTES_SIZED(actual, expected, expected_size);
+    AVS_UNIT_ASSERT_FALSE(anjay_attr_storage_journal_needs_compaction(anjay));
+    PERSISTENCE_TEST_FINISH;
+}
+
 // TODO: Actually test removing nonexistent IIDs and RIDs
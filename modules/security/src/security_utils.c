@@ -20,6 +20,8 @@
 
 #include <avsystem/commons/utils.h>
 
+#include <anjay_modules/io_utils.h>
+
 #include "security_utils.h"
 
 VISIBILITY_SOURCE_BEGIN
@@ -61,33 +63,45 @@ static int _anjay_sec_string_getter(anjay_input_ctx_t *ctx,
     return 0;
 }
 
+#define FALLBACK_INITIAL_CAPACITY 128
+#define MAX_INITIAL_CAPACITY 1024
+
 static int _anjay_sec_generic_getter(anjay_input_ctx_t *ctx,
                                      char **out,
                                      size_t *out_bytes_read,
+                                     size_t initial_capacity,
                                      chunk_getter_t *getter) {
-    char tmp[128];
     bool finished = false;
-    char *buffer = NULL;
+    size_t capacity = AVS_MAX(initial_capacity, 1);
     size_t buffer_size = 0;
+    char *buffer = (char *) malloc(capacity);
+    if (!buffer) {
+        return ANJAY_ERR_INTERNAL;
+    }
     int result;
     do {
         size_t chunk_bytes_read = 0;
-        if ((result = getter(ctx, tmp, sizeof(tmp), &finished,
-                             &chunk_bytes_read))) {
+        if ((result = getter(ctx, buffer + buffer_size, capacity - buffer_size,
+                             &finished, &chunk_bytes_read))) {
             goto error;
         }
-        if (chunk_bytes_read > 0) {
-            char *bigger_buffer =
-                    (char *) realloc(buffer, buffer_size + chunk_bytes_read);
+        buffer_size += chunk_bytes_read;
+        // the string getter needs space for at least one character and the
+        // terminator to make any progress
+        if (!finished && capacity - buffer_size < 2) {
+            char *bigger_buffer = (char *) realloc(buffer, 2 * capacity);
             if (!bigger_buffer) {
                 result = ANJAY_ERR_INTERNAL;
                 goto error;
             }
-            memcpy(bigger_buffer + buffer_size, tmp, chunk_bytes_read);
             buffer = bigger_buffer;
-            buffer_size += chunk_bytes_read;
+            capacity *= 2;
         }
     } while (!finished);
+    if (!buffer_size) {
+        free(buffer);
+        buffer = NULL;
+    }
     *out = buffer;
     *out_bytes_read = buffer_size;
     return 0;
@@ -96,11 +110,33 @@ error:
     return result;
 }
 
+/**
+ * Returns the buffer size that will most likely fit the whole value: its exact
+ * length if the input context knows it (plus @p extra for the terminator),
+ * or some reasonable starting point otherwise.
+ *
+ * The length comes from the payload, so it is only trusted up to
+ * MAX_INITIAL_CAPACITY. Longer values are read into a buffer that grows as
+ * the data actually arrives.
+ */
+static size_t expected_value_size(anjay_input_ctx_t *ctx, size_t extra) {
+    size_t length;
+    if (_anjay_input_remaining_length(ctx, &length)) {
+        return FALLBACK_INITIAL_CAPACITY;
+    }
+    if (length > MAX_INITIAL_CAPACITY - extra) {
+        return MAX_INITIAL_CAPACITY;
+    }
+    return length + extra;
+}
+
 int _anjay_sec_fetch_bytes(anjay_input_ctx_t *ctx, anjay_raw_buffer_t *buffer) {
     _anjay_raw_buffer_clear(buffer);
     int retval =
             _anjay_sec_generic_getter(ctx, (char **) &buffer->data,
-                                      &buffer->size, _anjay_sec_bytes_getter);
+                                      &buffer->size,
+                                      expected_value_size(ctx, 0),
+                                      _anjay_sec_bytes_getter);
     buffer->capacity = buffer->size;
     return retval;
 }
@@ -110,6 +146,7 @@ int _anjay_sec_fetch_string(anjay_input_ctx_t *ctx, char **out) {
     *out = NULL;
     size_t bytes_read = 0;
     return _anjay_sec_generic_getter(ctx, out, &bytes_read,
+                                     expected_value_size(ctx, 1),
                                      _anjay_sec_string_getter);
 }
 
@@ -271,3 +308,7 @@ AVS_LIST(sec_instance_t) _anjay_sec_clone_instances(const sec_repr_t *repr) {
     }
     return retval;
 }
+
+#ifdef ANJAY_TEST
+#include "test/utils.c"
+#endif // ANJAY_TEST
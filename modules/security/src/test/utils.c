@@ -0,0 +1,100 @@
+/*
+ * Copyright 2017 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <avsystem/commons/unit/memstream.h>
+#include <avsystem/commons/unit/test.h>
+
+#define VALUE_SIZE 4096
+
+typedef struct {
+    avs_stream_abstract_t *stream;
+    anjay_input_ctx_t *in;
+} tlv_env_t;
+
+static tlv_env_t tlv_env_create(const char *header,
+                                size_t header_size,
+                                const char *value,
+                                size_t value_size) {
+    tlv_env_t env = { NULL, NULL };
+    AVS_UNIT_ASSERT_SUCCESS(avs_unit_memstream_alloc(
+            &env.stream, header_size + value_size + 1));
+    AVS_UNIT_ASSERT_SUCCESS(avs_stream_write(env.stream, header, header_size));
+    AVS_UNIT_ASSERT_SUCCESS(avs_stream_write(env.stream, value, value_size));
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_tlv_create(&env.in, &env.stream,
+                                                    false));
+    return env;
+}
+
+static void tlv_env_destroy(tlv_env_t *env) {
+    _anjay_input_ctx_destroy(&env->in);
+    avs_stream_cleanup(&env->stream);
+}
+
+static void fill_value(char *value) {
+    for (size_t i = 0; i < VALUE_SIZE; ++i) {
+        value[i] = (char) ('a' + i % 26);
+    }
+}
+
+// TLV header: RID 0, 16-bit length equal to VALUE_SIZE
+static const char LARGE_HEADER[] = "\xD0\x00\x10\x00";
+
+AVS_UNIT_TEST(security_utils, fetch_large_bytes) {
+    char value[VALUE_SIZE];
+    fill_value(value);
+    tlv_env_t env = tlv_env_create(LARGE_HEADER, sizeof(LARGE_HEADER) - 1,
+                                   value, sizeof(value));
+
+    anjay_raw_buffer_t buffer = ANJAY_RAW_BUFFER_EMPTY;
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_sec_fetch_bytes(env.in, &buffer));
+    AVS_UNIT_ASSERT_EQUAL(buffer.size, VALUE_SIZE);
+    AVS_UNIT_ASSERT_EQUAL_BYTES_SIZED(buffer.data, value, VALUE_SIZE);
+
+    _anjay_raw_buffer_clear(&buffer);
+    tlv_env_destroy(&env);
+}
+
+AVS_UNIT_TEST(security_utils, fetch_large_string) {
+    char value[VALUE_SIZE];
+    fill_value(value);
+    tlv_env_t env = tlv_env_create(LARGE_HEADER, sizeof(LARGE_HEADER) - 1,
+                                   value, sizeof(value));
+
+    char *string = NULL;
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_sec_fetch_string(env.in, &string));
+    AVS_UNIT_ASSERT_NOT_NULL(string);
+    AVS_UNIT_ASSERT_EQUAL(strlen(string), VALUE_SIZE);
+    AVS_UNIT_ASSERT_EQUAL_BYTES_SIZED(string, value, VALUE_SIZE);
+
+    free(string);
+    tlv_env_destroy(&env);
+}
+
+AVS_UNIT_TEST(security_utils, fetch_empty_values) {
+    tlv_env_t env = tlv_env_create("\xC0\x00", 2, "", 0);
+    anjay_raw_buffer_t buffer = ANJAY_RAW_BUFFER_EMPTY;
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_sec_fetch_bytes(env.in, &buffer));
+    AVS_UNIT_ASSERT_NULL(buffer.data);
+    AVS_UNIT_ASSERT_EQUAL(buffer.size, 0);
+    tlv_env_destroy(&env);
+
+    env = tlv_env_create("\xC0\x00", 2, "", 0);
+    char *string = NULL;
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_sec_fetch_string(env.in, &string));
+    AVS_UNIT_ASSERT_EQUAL_STRING(string, "");
+    free(string);
+    tlv_env_destroy(&env);
+}
@@ -45,6 +45,65 @@
 
 VISIBILITY_SOURCE_BEGIN
 
+static int init_server_backoff(anjay_t *anjay,
+                               const anjay_server_backoff_config_t *config) {
+    static const anjay_server_backoff_config_t DEFAULT_CONFIG =
+            ANJAY_DEFAULT_SERVER_BACKOFF;
+    if (!config) {
+        config = &DEFAULT_CONFIG;
+    }
+
+    if (!avs_time_duration_less(AVS_TIME_DURATION_ZERO, config->initial_delay)
+            || !avs_time_duration_valid(config->max_delay)
+            || avs_time_duration_less(config->max_delay,
+                                      config->initial_delay)) {
+        anjay_log(ERROR, "server backoff delays must be positive, with "
+                         "max_delay no lower than initial_delay");
+        return -1;
+    }
+    if (!(config->multiplier >= 1.0)) {
+        anjay_log(ERROR, "server backoff multiplier must be at least 1.0");
+        return -1;
+    }
+    if (!(config->jitter_fraction >= 0.0 && config->jitter_fraction <= 1.0)) {
+        anjay_log(ERROR, "server backoff jitter_fraction must be in range "
+                         "[0.0, 1.0]");
+        return -1;
+    }
+    if (config->jitter != ANJAY_BACKOFF_JITTER_PROPORTIONAL
+            && config->jitter != ANJAY_BACKOFF_JITTER_DECORRELATED) {
+        anjay_log(ERROR, "invalid server backoff jitter strategy");
+        return -1;
+    }
+
+    anjay->server_backoff = (anjay_sched_retryable_backoff_t) {
+        .delay = config->initial_delay,
+        .max_delay = config->max_delay,
+        .multiplier = config->multiplier,
+        .jitter_fraction = config->jitter_fraction,
+        .jitter = config->jitter,
+        .min_delay = config->initial_delay
+    };
+    if (avs_time_duration_less(AVS_TIME_DURATION_ZERO,
+                               config->reactivation_stagger)) {
+        anjay->server_reactivation_stagger = config->reactivation_stagger;
+    }
+    return 0;
+}
+
+static anjay_rand_seed_t make_rand_seed(const anjay_t *anjay) {
+    // clients started at the same time must not draw the same delays, so
+    // the seed is mixed with the endpoint name, which is unique per device
+    uint32_t hash = 2166136261u;
+    for (const char *ch = anjay->endpoint_name; *ch; ++ch) {
+        hash = (hash ^ (uint8_t) *ch) * 16777619u;
+    }
+    avs_time_real_t now = avs_time_real_now();
+    return (anjay_rand_seed_t) (hash
+                                ^ (uint32_t) now.since_real_epoch.seconds
+                                ^ (uint32_t) now.since_real_epoch.nanoseconds);
+}
+
 static int init(anjay_t *anjay,
                 const anjay_configuration_t *config) {
     anjay->dtls_version = config->dtls_version;
@@ -74,6 +133,19 @@ static int init(anjay_t *anjay,
                 (avs_coap_tx_params_t) ANJAY_COAP_DEFAULT_UDP_TX_PARAMS;
     }
 
+    if (avs_time_duration_less(AVS_TIME_DURATION_ZERO,
+                               config->queue_mode_wakeup_slack)) {
+        anjay->queue_mode_wakeup_slack = config->queue_mode_wakeup_slack;
+    }
+
+    if (init_server_backoff(anjay, config->server_backoff)) {
+        return -1;
+    }
+
+    if (avs_time_duration_less(AVS_TIME_DURATION_ZERO,
+                               config->keepalive_interval)) {
+        anjay->keepalive_interval = config->keepalive_interval;
+    }
 
     anjay->servers = _anjay_servers_create();
 
@@ -97,10 +169,12 @@ static int init(anjay_t *anjay,
         return -1;
     }
 
+    anjay->rand_seed = make_rand_seed(anjay);
     anjay->sched = _anjay_sched_new(anjay);
     if (!anjay->sched) {
         return -1;
     }
+    _anjay_sched_seed(anjay->sched, _anjay_rand32(&anjay->rand_seed));
 
     if (_anjay_observe_init(anjay, config->confirmable_notifications)) {
         return -1;
@@ -147,6 +221,15 @@ anjay_t *anjay_new(const anjay_configuration_t *config) {
 }
 
 void _anjay_release_server_stream_without_scheduling_queue(anjay_t *anjay) {
+    if (anjay->current_connection.server) {
+        anjay_server_connection_t *connection =
+                _anjay_get_server_connection(anjay->current_connection);
+        assert(connection);
+        _anjay_traffic_stats_add_since(
+                anjay, &connection->stats,
+                &anjay->current_connection_stats_snapshot);
+    }
+    _anjay_coap_stream_set_traffic_stats(anjay->comm_stream, NULL);
     memset(&anjay->current_connection, 0, sizeof(anjay->current_connection));
     if (avs_stream_net_setsock(anjay->comm_stream, NULL)) {
         anjay_log(ERROR, "could not set stream socket to NULL");
@@ -162,7 +245,10 @@ void anjay_delete(anjay_t *anjay) {
 
     _anjay_bootstrap_cleanup(anjay);
     _anjay_servers_cleanup(anjay);
+    _anjay_socket_map_cleanup(&anjay->server_sockets);
     _anjay_sched_del(anjay->sched, &anjay->reload_servers_sched_job_handle);
+    _anjay_sched_del(anjay->sched,
+                     &anjay->serve_deferred_requests_job_handle);
 
     _anjay_sched_delete(&anjay->sched);
 
@@ -172,7 +258,9 @@ void anjay_delete(anjay_t *anjay) {
     _anjay_dm_cleanup(anjay);
     _anjay_observe_cleanup(anjay);
     _anjay_notify_clear_queue(&anjay->scheduled_notify.queue);
+    _anjay_notify_clear_queue(&anjay->request_notify_queue);
 
+    AVS_LIST_CLEAR(&anjay->keepalive_overrides);
     free(anjay->in_buffer);
     free(anjay->out_buffer);
     free(anjay);
@@ -284,6 +372,16 @@ static int parse_attribute(anjay_request_attributes_t *out_attrs,
         return parse_con(value, &out_attrs->custom.has_con,
                          &out_attrs->values.custom.data.con);
 #endif // WITH_CON_ATTR
+#ifdef WITH_EVAL_PERIOD_ATTRS
+    } else if (!strcmp(key, ANJAY_CUSTOM_ATTR_EPMIN)) {
+        return parse_nullable_time(
+                key, value, &out_attrs->custom.has_min_eval_period,
+                &out_attrs->values.custom.data.min_eval_period);
+    } else if (!strcmp(key, ANJAY_CUSTOM_ATTR_EPMAX)) {
+        return parse_nullable_time(
+                key, value, &out_attrs->custom.has_max_eval_period,
+                &out_attrs->values.custom.data.max_eval_period);
+#endif // WITH_EVAL_PERIOD_ATTRS
     } else {
         anjay_log(ERROR, "unrecognized query string: %s = %s", key, value);
         return -1;
@@ -620,6 +718,16 @@ static int block_request_equality_validator(const avs_coap_msg_t *msg,
     return 0;
 }
 
+static void flush_request_notify_queue(anjay_t *anjay) {
+    // performed while the originating server connection is still bound, so
+    // that _anjay_dm_current_ssid() identifies the server that made the changes
+    if (anjay->request_notify_queue
+            && _anjay_notify_flush(anjay, &anjay->request_notify_queue)) {
+        anjay_log(WARNING, "could not perform notifications about changes "
+                           "made by the request");
+    }
+}
+
 static int handle_request(anjay_t *anjay,
                           const avs_coap_msg_identity_t *request_identity,
                           const anjay_request_t *request) {
@@ -646,6 +754,7 @@ static int handle_request(anjay_t *anjay,
 
         if (_anjay_coap_stream_set_error(anjay->comm_stream, error_code)) {
             anjay_log(ERROR, "could not setup error response");
+            _anjay_notify_clear_queue(&anjay->request_notify_queue);
             return -1;
         }
     }
@@ -655,6 +764,10 @@ static int handle_request(anjay_t *anjay,
         finish_result = avs_stream_finish_message(anjay->comm_stream);
     }
 
+    // the response is already on its way, so the server does not need to wait
+    // for Observe re-evaluation and module notifications caused by the request
+    flush_request_notify_queue(anjay);
+
     if (_anjay_dm_current_ssid(anjay) != ANJAY_SSID_BOOTSTRAP) {
         _anjay_observe_sched_flush_current_connection(anjay);
     }
@@ -721,6 +834,65 @@ _anjay_get_server_connection(anjay_connection_ref_t ref) {
     }
 }
 
+avs_time_duration_t _anjay_queue_mode_wakeup_slack(anjay_t *anjay,
+                                                   anjay_connection_key_t key) {
+    anjay_connection_ref_t ref = {
+        .server = _anjay_servers_find_active(&anjay->servers, key.ssid),
+        .conn_type = key.type
+    };
+    anjay_server_connection_t *connection =
+            ref.server ? _anjay_get_server_connection(ref) : NULL;
+    if (connection && connection->queue_mode) {
+        return anjay->queue_mode_wakeup_slack;
+    }
+    return AVS_TIME_DURATION_ZERO;
+}
+
+static bool any_queue_mode_connection_online(anjay_t *anjay) {
+    AVS_LIST(anjay_active_server_info_t) server;
+    AVS_LIST_FOREACH(server, anjay->servers.active) {
+        if (server->udp_connection.queue_mode
+                && server->udp_connection.queue_mode_close_socket_clb_handle) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Called whenever a suspended queue mode connection is brought back online.
+ * Pulls forward all jobs that would wake up any queue mode connection within
+ * the configured slack window, so that they are all handled during the current
+ * wake-up instead of each one waking the radio separately.
+ */
+static void queue_mode_align_jobs(anjay_t *anjay) {
+    if (!avs_time_duration_less(AVS_TIME_DURATION_ZERO,
+                                anjay->queue_mode_wakeup_slack)) {
+        return;
+    }
+
+    AVS_LIST(anjay_active_server_info_t) server;
+    AVS_LIST_FOREACH(server, anjay->servers.active) {
+        if (!server->udp_connection.queue_mode) {
+            continue;
+        }
+        if (server->sched_update_handle
+                && !_anjay_sched_pull_forward(anjay->sched,
+                                              &server->sched_update_handle,
+                                              anjay->queue_mode_wakeup_slack)) {
+            anjay_log(DEBUG, "Update for SSID %u aligned with queue mode "
+                             "wake-up", server->ssid);
+        }
+        _anjay_observe_pull_forward_triggers(
+                anjay,
+                (anjay_connection_key_t) {
+                    .ssid = server->ssid,
+                    .type = ANJAY_CONNECTION_UDP
+                },
+                anjay->queue_mode_wakeup_slack);
+    }
+}
+
 int _anjay_bind_server_stream(anjay_t *anjay, anjay_connection_ref_t ref) {
     const avs_coap_tx_params_t *tx_params;
     switch (ref.conn_type) {
@@ -738,6 +910,12 @@ int _anjay_bind_server_stream(anjay_t *anjay, anjay_connection_ref_t ref) {
         return -1;
     }
 
+    // see comment on queue_mode_close_socket_clb_handle declaration
+    bool is_queue_mode_resume = (connection->queue_mode
+            && !connection->queue_mode_close_socket_clb_handle);
+    bool is_queue_mode_wakeup = (is_queue_mode_resume
+            && !any_queue_mode_connection_online(anjay));
+
     avs_net_abstract_socket_t *socket = _anjay_connection_get_prepared_socket(
             anjay, ref.server, connection);
     if (!socket
@@ -750,6 +928,17 @@ int _anjay_bind_server_stream(anjay_t *anjay, anjay_connection_ref_t ref) {
 
     assert(!anjay->current_connection.server);
     anjay->current_connection = ref;
+    _anjay_traffic_stats_snapshot(anjay,
+                                  &anjay->current_connection_stats_snapshot);
+    _anjay_coap_stream_set_traffic_stats(anjay->comm_stream,
+                                         &connection->stats);
+
+    if (is_queue_mode_wakeup) {
+        ++anjay->queue_mode_wakeups;
+    }
+    if (is_queue_mode_resume) {
+        queue_mode_align_jobs(anjay);
+    }
     return 0;
 }
 
@@ -819,6 +1008,19 @@ static void queue_mode_activate_socket(anjay_t *anjay) {
     }
 }
 
+static int serve_deferred_requests_job(anjay_t *anjay, void *dummy);
+
+static void schedule_serve_deferred_requests(anjay_t *anjay) {
+    if (!anjay->serve_deferred_requests_job_handle
+            && _anjay_coap_stream_get_deferred_request_socket(
+                    anjay->comm_stream)
+            && _anjay_sched_now(anjay->sched,
+                                &anjay->serve_deferred_requests_job_handle,
+                                serve_deferred_requests_job, NULL)) {
+        anjay_log(ERROR, "could not schedule handling of deferred requests");
+    }
+}
+
 void _anjay_release_server_stream(anjay_t *anjay) {
     anjay_server_connection_t *connection =
             _anjay_get_server_connection(anjay->current_connection);
@@ -829,8 +1031,10 @@ void _anjay_release_server_stream(anjay_t *anjay) {
     if (connection->queue_mode) {
         queue_mode_activate_socket(anjay);
     }
+    _anjay_connection_schedule_keepalive(anjay, anjay->current_connection);
 
     _anjay_release_server_stream_without_scheduling_queue(anjay);
+    schedule_serve_deferred_requests(anjay);
 }
 
 size_t _anjay_num_non_bootstrap_servers(anjay_t *anjay) {
@@ -854,15 +1058,8 @@ size_t _anjay_num_non_bootstrap_servers(anjay_t *anjay) {
     return num_servers;
 }
 
-static int udp_serve(anjay_t *anjay,
-                     avs_net_abstract_socket_t *ready_socket) {
-    anjay_connection_ref_t connection = {
-        .server = _anjay_servers_find_by_udp_socket(&anjay->servers,
-                                                    ready_socket),
-        .conn_type = ANJAY_CONNECTION_UDP
-    };
-    if (!connection.server
-            || _anjay_bind_server_stream(anjay, connection)) {
+static int udp_serve(anjay_t *anjay, anjay_connection_ref_t connection) {
+    if (_anjay_bind_server_stream(anjay, connection)) {
         return -1;
     }
 
@@ -871,6 +1068,40 @@ static int udp_serve(anjay_t *anjay,
     return result;
 }
 
+static int serve_deferred_requests_job(anjay_t *anjay, void *dummy) {
+    (void) dummy;
+    // requests deferred while handling these ones are left for the next run of
+    // this job, scheduled by _anjay_release_server_stream()
+    size_t remaining =
+            _anjay_coap_stream_num_deferred_requests(anjay->comm_stream);
+    avs_net_abstract_socket_t *socket;
+    while (remaining > 0
+            && (socket = _anjay_coap_stream_get_deferred_request_socket(
+                        anjay->comm_stream))) {
+        anjay_connection_ref_t connection =
+                _anjay_servers_find_by_socket(anjay, socket);
+        if (!connection.server
+                || _anjay_bind_server_stream(anjay, connection)) {
+            anjay_log(WARNING, "dropping requests deferred on an unusable "
+                      "socket");
+            _anjay_coap_stream_drop_deferred_requests(anjay->comm_stream,
+                                                      socket);
+            continue;
+        }
+
+        // each replayed request is removed from the queue before it is
+        // handled, whether handling it succeeds or not
+        while (remaining > 0
+                && !_anjay_coap_stream_replay_deferred_request(
+                        anjay->comm_stream)) {
+            --remaining;
+            handle_incoming_message(anjay);
+        }
+        _anjay_release_server_stream(anjay);
+    }
+    return 0;
+}
+
 static int sms_serve(anjay_t *anjay) {
     (void) anjay;
     assert(0 && "SMS not supported in this version of Anjay");
@@ -879,6 +1110,13 @@ static int sms_serve(anjay_t *anjay) {
 
 int anjay_serve(anjay_t *anjay,
                 avs_net_abstract_socket_t *ready_socket) {
+    anjay_connection_ref_t connection =
+            _anjay_servers_find_by_socket(anjay, ready_socket);
+    if (connection.server) {
+        assert(connection.conn_type == ANJAY_CONNECTION_UDP);
+        return udp_serve(anjay, connection);
+    }
+
 #ifdef WITH_BLOCK_DOWNLOAD
     if (!_anjay_downloader_handle_packet(&anjay->downloader, ready_socket)) {
         return 0;
@@ -889,7 +1127,7 @@ int anjay_serve(anjay_t *anjay,
             && ready_socket == _anjay_sms_poll_socket(anjay)) {
         return sms_serve(anjay);
     }
-    return udp_serve(anjay, ready_socket);
+    return -1;
 }
 
 int anjay_sched_time_to_next(anjay_t *anjay,
@@ -930,6 +1168,20 @@ int anjay_sched_run(anjay_t *anjay) {
     return 0;
 }
 
+int anjay_sched_run_bounded(anjay_t *anjay,
+                            size_t max_jobs,
+                            avs_time_duration_t max_duration) {
+    bool work_remaining = false;
+    ssize_t tasks_executed = _anjay_sched_run_bounded(
+            anjay->sched, max_jobs, max_duration, &work_remaining);
+    if (tasks_executed < 0) {
+        anjay_log(ERROR, "sched_run failed");
+        return -1;
+    }
+
+    return work_remaining ? 1 : 0;
+}
+
 anjay_download_handle_t anjay_download(anjay_t *anjay,
                                        const anjay_download_config_t *config) {
 #ifdef WITH_BLOCK_DOWNLOAD
@@ -953,6 +1205,20 @@ void anjay_download_abort(anjay_t *anjay,
 #endif // WITH_BLOCK_DOWNLOAD
 }
 
+int anjay_download_get_stats(anjay_t *anjay,
+                             anjay_download_handle_t handle,
+                             anjay_traffic_stats_t *out_stats) {
+#ifdef WITH_BLOCK_DOWNLOAD
+    return _anjay_downloader_get_stats(&anjay->downloader, handle, out_stats);
+#else // WITH_BLOCK_DOWNLOAD
+    (void) anjay;
+    (void) handle;
+    (void) out_stats;
+    anjay_log(ERROR, "CoAP download support disabled");
+    return -1;
+#endif // WITH_BLOCK_DOWNLOAD
+}
+
 void anjay_smsdrv_cleanup(anjay_smsdrv_t **smsdrv_ptr) {
     if (*smsdrv_ptr) {
         assert(0 && "SMS drivers not supported by this version of Anjay");
@@ -995,6 +1261,67 @@ uint64_t anjay_get_num_outgoing_retransmissions(anjay_t *anjay) {
 #endif
 }
 
+uint64_t anjay_get_num_queue_mode_wakeups(anjay_t *anjay) {
+    return anjay->queue_mode_wakeups;
+}
+
+uint64_t anjay_get_num_deferred_requests(anjay_t *anjay) {
+    uint64_t num_deferred, num_dropped;
+    _anjay_coap_stream_get_deferred_request_stats(anjay->comm_stream,
+                                                  &num_deferred, &num_dropped);
+    return num_deferred;
+}
+
+uint64_t anjay_get_num_dropped_deferred_requests(anjay_t *anjay) {
+    uint64_t num_deferred, num_dropped;
+    _anjay_coap_stream_get_deferred_request_stats(anjay->comm_stream,
+                                                  &num_deferred, &num_dropped);
+    return num_dropped;
+}
+
+void _anjay_traffic_stats_snapshot(anjay_t *anjay,
+                                   anjay_traffic_stats_t *out_snapshot) {
+    memset(out_snapshot, 0, sizeof(*out_snapshot));
+    out_snapshot->tx_bytes = anjay_get_tx_bytes(anjay);
+    out_snapshot->rx_bytes = anjay_get_rx_bytes(anjay);
+    out_snapshot->num_incoming_retransmissions =
+            anjay_get_num_incoming_retransmissions(anjay);
+    out_snapshot->num_outgoing_retransmissions =
+            anjay_get_num_outgoing_retransmissions(anjay);
+}
+
+void _anjay_traffic_stats_add_since(anjay_t *anjay,
+                                    anjay_traffic_stats_t *stats,
+                                    const anjay_traffic_stats_t *snapshot) {
+    anjay_traffic_stats_t now;
+    _anjay_traffic_stats_snapshot(anjay, &now);
+    stats->tx_bytes += now.tx_bytes - snapshot->tx_bytes;
+    stats->rx_bytes += now.rx_bytes - snapshot->rx_bytes;
+    stats->num_incoming_retransmissions +=
+            now.num_incoming_retransmissions
+            - snapshot->num_incoming_retransmissions;
+    stats->num_outgoing_retransmissions +=
+            now.num_outgoing_retransmissions
+            - snapshot->num_outgoing_retransmissions;
+}
+
+int anjay_get_server_stats(anjay_t *anjay,
+                           anjay_ssid_t ssid,
+                           anjay_traffic_stats_t *out_stats) {
+    anjay_active_server_info_t *server =
+            _anjay_servers_find_active(&anjay->servers, ssid);
+    if (!server) {
+        return -1;
+    }
+    *out_stats = server->udp_connection.stats;
+    if (anjay->current_connection.server == server) {
+        // traffic of the exchange in progress is not accounted for yet
+        _anjay_traffic_stats_add_since(
+                anjay, out_stats, &anjay->current_connection_stats_snapshot);
+    }
+    return 0;
+}
+
 #ifdef ANJAY_TEST
 #include "test/anjay.c"
 #endif // ANJAY_TEST
@@ -50,7 +50,9 @@ struct anjay_struct {
     anjay_dm_t dm;
     uint16_t udp_listen_port;
     anjay_servers_t servers;
+    anjay_socket_map_t server_sockets;
     anjay_sched_handle_t reload_servers_sched_job_handle;
+    anjay_sched_handle_t serve_deferred_requests_job_handle;
 #ifdef WITH_OBSERVE
     anjay_observe_state_t observe;
 #endif
@@ -61,7 +63,12 @@ struct anjay_struct {
     avs_coap_ctx_t *coap_ctx;
     avs_stream_abstract_t *comm_stream;
     anjay_connection_ref_t current_connection;
+    // global CoAP context counters at the time current_connection was bound
+    anjay_traffic_stats_t current_connection_stats_snapshot;
     anjay_scheduled_notify_t scheduled_notify;
+    // data model changes made by the request currently being handled; they
+    // are flushed by handle_request() only after the response has been sent
+    anjay_notify_queue_t request_notify_queue;
 
     const char *endpoint_name;
     anjay_transaction_state_t transaction_state;
@@ -71,6 +78,16 @@ struct anjay_struct {
     uint8_t *out_buffer;
     size_t out_buffer_size;
 
+    avs_time_duration_t queue_mode_wakeup_slack;
+    uint64_t queue_mode_wakeups;
+
+    anjay_sched_retryable_backoff_t server_backoff;
+    avs_time_duration_t server_reactivation_stagger;
+    anjay_rand_seed_t rand_seed;
+
+    avs_time_duration_t keepalive_interval;
+    AVS_LIST(anjay_keepalive_override_t) keepalive_overrides;
+
 #ifdef WITH_BLOCK_DOWNLOAD
     anjay_downloader_t downloader;
 #endif // WITH_BLOCK_DOWNLOAD
@@ -95,6 +112,29 @@ void _anjay_release_server_stream(anjay_t *anjay);
 
 size_t _anjay_num_non_bootstrap_servers(anjay_t *anjay);
 
+/**
+ * Stores the current values of byte and retransmission counters of the global
+ * CoAP context in @p out_snapshot . All other fields are zeroed.
+ */
+void _anjay_traffic_stats_snapshot(anjay_t *anjay,
+                                   anjay_traffic_stats_t *out_snapshot);
+
+/**
+ * Adds the amount by which byte and retransmission counters of the global
+ * CoAP context have grown since @p snapshot was taken to @p stats .
+ */
+void _anjay_traffic_stats_add_since(anjay_t *anjay,
+                                    anjay_traffic_stats_t *stats,
+                                    const anjay_traffic_stats_t *snapshot);
+
+/**
+ * Returns the queue mode wake-up alignment window applicable to the connection
+ * identified by @p key - i.e. the configured one if the connection is in queue
+ * mode, or zero otherwise.
+ */
+avs_time_duration_t _anjay_queue_mode_wakeup_slack(anjay_t *anjay,
+                                                   anjay_connection_key_t key);
+
 VISIBILITY_PRIVATE_HEADER_END
 
 #endif /* ANJAY_CORE_H */
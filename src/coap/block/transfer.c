@@ -179,10 +179,14 @@ static int accept_response_with_timeout(coap_block_transfer_ctx_t *ctx,
 
     _anjay_coap_in_reset(ctx->in);
 
+    // BLOCK1 transfers are only used for client requests; server requests
+    // arriving in the meantime may be handled after the transfer finishes
+    bool defer_requests = (ctx->block.type == AVS_COAP_BLOCK1);
+
     int handler_retval;
     int result = _anjay_coap_common_recv_msg_with_timeout(
             ctx->coap_ctx, ctx->socket, ctx->in, &recv_timeout,
-            block_recv, &block_recv_data, &handler_retval);
+            block_recv, &block_recv_data, defer_requests, &handler_retval);
 
     if (result == AVS_COAP_CTX_ERR_TIMEOUT) {
         ctx->timed_out = true;
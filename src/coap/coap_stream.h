@@ -94,6 +94,50 @@ void _anjay_coap_stream_set_block_request_validator(
         anjay_coap_block_request_validator_t *validator,
         void *validator_arg);
 
+/**
+ * Requests received while the stream was waiting for a response to a client
+ * request are not rejected, but deferred until the exchange is finished.
+ *
+ * @returns Socket on which the oldest deferred request has been received, or
+ *          NULL if there are no deferred requests.
+ */
+avs_net_abstract_socket_t *
+_anjay_coap_stream_get_deferred_request_socket(avs_stream_abstract_t *stream);
+
+/** Returns the number of requests currently deferred on all sockets. */
+size_t _anjay_coap_stream_num_deferred_requests(avs_stream_abstract_t *stream);
+
+/**
+ * Removes the oldest request deferred on the socket the stream is currently
+ * bound to from the queue, and makes the next attempt to receive a request on
+ * the idle stream return it instead of reading from that socket. The request
+ * is not replayed anymore once the stream is bound to another socket.
+ *
+ * @returns 0 on success, negative value if there are no such requests.
+ */
+int _anjay_coap_stream_replay_deferred_request(avs_stream_abstract_t *stream);
+
+/**
+ * Discards all deferred requests received on @p socket . Needs to be called
+ * before the socket is destroyed.
+ */
+void _anjay_coap_stream_drop_deferred_requests(
+        avs_stream_abstract_t *stream,
+        avs_net_abstract_socket_t *socket);
+
+void _anjay_coap_stream_get_deferred_request_stats(
+        avs_stream_abstract_t *stream,
+        uint64_t *out_num_deferred,
+        uint64_t *out_num_dropped);
+
+/**
+ * Sets the counters that RTT samples taken by the stream are recorded in.
+ * @p stats may be NULL, in which case the samples are not recorded anywhere.
+ * The pointer needs to stay valid until it is replaced by another call.
+ */
+void _anjay_coap_stream_set_traffic_stats(avs_stream_abstract_t *stream,
+                                          anjay_traffic_stats_t *stats);
+
 VISIBILITY_PRIVATE_HEADER_END
 
 #endif // ANJAY_COAP_STREAM_H
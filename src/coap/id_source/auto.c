@@ -25,10 +25,30 @@ VISIBILITY_SOURCE_BEGIN
 typedef struct coap_default_id_src {
     coap_id_source_t base;
     anjay_rand_seed_t rand_seed;
+    uint64_t token_state;
     uint16_t next_msg_id;
     uint8_t token_size;
 } coap_default_id_src_t;
 
+static uint64_t rand64(anjay_rand_seed_t *seed) {
+    return ((uint64_t) _anjay_rand32(seed) << 32) | _anjay_rand32(seed);
+}
+
+/**
+ * SplitMix64: a counter advanced by a fixed odd increment, passed through
+ * a bijective mixing function, which costs a handful of arithmetic operations
+ * instead of a PRNG round per token byte. Outputs are guaranteed to be
+ * distinct only between reseeds (see id_src_seq_get()), i.e. within a single
+ * Message ID cycle; across reseeds, a repeated value is merely as unlikely as
+ * a collision of random 64-bit numbers.
+ */
+static uint64_t next_token_value(coap_default_id_src_t *self) {
+    uint64_t value = (self->token_state += UINT64_C(0x9E3779B97F4A7C15));
+    value = (value ^ (value >> 30)) * UINT64_C(0xBF58476D1CE4E5B9);
+    value = (value ^ (value >> 27)) * UINT64_C(0x94D049BB133111EB);
+    return value ^ (value >> 31);
+}
+
 static avs_coap_msg_identity_t id_src_seq_get(coap_id_source_t *self_) {
     coap_default_id_src_t *self = (coap_default_id_src_t *)self_;
 
@@ -38,10 +58,17 @@ static avs_coap_msg_identity_t id_src_seq_get(coap_id_source_t *self_) {
             .size = self->token_size
         }
     };
-    for (uint8_t i = 0; i < self->token_size; ++i) {
-        id.token.bytes[i] = (char) _anjay_rand32(&self->rand_seed);
+    if (self->token_size) {
+        uint64_t value = next_token_value(self);
+        for (uint8_t i = 0; i < self->token_size; ++i) {
+            id.token.bytes[i] = (char) (uint8_t) (value >> (8 * i));
+        }
+    }
+    if (!++self->next_msg_id) {
+        // mix fresh PRNG output into the counter once per Message ID cycle,
+        // so that the token sequence cannot be followed indefinitely
+        self->token_state ^= rand64(&self->rand_seed);
     }
-    ++self->next_msg_id;
 
     return id;
 }
@@ -64,7 +91,12 @@ coap_id_source_t *_anjay_coap_id_source_auto_new(anjay_rand_seed_t rand_seed,
            sizeof(ID_SRC_SEQ_VTABLE));
     src->rand_seed = rand_seed;
     src->next_msg_id = (uint16_t) _anjay_rand32(&src->rand_seed);
+    src->token_state = rand64(&src->rand_seed);
     src->token_size = (uint8_t) token_size;
 
     return &src->base;
 }
+
+#ifdef ANJAY_TEST
+#include "test/auto.c"
+#endif // ANJAY_TEST
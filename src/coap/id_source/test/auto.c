@@ -0,0 +1,84 @@
+/*
+ * Copyright 2017 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <config.h>
+
+#include <string.h>
+
+#include <avsystem/commons/unit/test.h>
+
+static uint64_t token_to_u64(const avs_coap_token_t *token) {
+    uint64_t result = 0;
+    memcpy(&result, token->bytes, token->size);
+    return result;
+}
+
+static int compare_u64(const void *left_, const void *right_) {
+    uint64_t left = *(const uint64_t *) left_;
+    uint64_t right = *(const uint64_t *) right_;
+    return (left > right) - (left < right);
+}
+
+AVS_UNIT_TEST(coap_id_source_auto, msg_id_sequential) {
+    coap_id_source_t *src = _anjay_coap_id_source_auto_new(42, 8);
+    AVS_UNIT_ASSERT_NOT_NULL(src);
+    avs_coap_msg_identity_t prev = _anjay_coap_id_source_get(src);
+    // more than a full Message ID cycle, to cover reseeding
+    for (size_t i = 0; i < 70000; ++i) {
+        avs_coap_msg_identity_t id = _anjay_coap_id_source_get(src);
+        AVS_UNIT_ASSERT_EQUAL(id.msg_id, (uint16_t) (prev.msg_id + 1));
+        AVS_UNIT_ASSERT_EQUAL(id.token.size, 8);
+        prev = id;
+    }
+    _anjay_coap_id_source_release(&src);
+}
+
+AVS_UNIT_TEST(coap_id_source_auto, token_sizes) {
+    for (size_t size = 0; size <= AVS_COAP_MAX_TOKEN_LENGTH; ++size) {
+        coap_id_source_t *src = _anjay_coap_id_source_auto_new(42, size);
+        AVS_UNIT_ASSERT_NOT_NULL(src);
+        avs_coap_msg_identity_t first = _anjay_coap_id_source_get(src);
+        avs_coap_msg_identity_t second = _anjay_coap_id_source_get(src);
+        AVS_UNIT_ASSERT_EQUAL(first.token.size, size);
+        AVS_UNIT_ASSERT_EQUAL(second.token.size, size);
+        if (size >= 4) {
+            AVS_UNIT_ASSERT_FALSE(avs_coap_token_equal(&first.token,
+                                                       &second.token));
+        }
+        _anjay_coap_id_source_release(&src);
+    }
+}
+
+AVS_UNIT_TEST(coap_id_source_auto, tokens_unique) {
+    // two full Message ID cycles, so that a reseed happens in between
+    static const size_t NUM_TOKENS = 2 * (UINT16_MAX + 1);
+    uint64_t *tokens = (uint64_t *) malloc(NUM_TOKENS * sizeof(*tokens));
+    AVS_UNIT_ASSERT_NOT_NULL(tokens);
+
+    coap_id_source_t *src = _anjay_coap_id_source_auto_new(42, 8);
+    AVS_UNIT_ASSERT_NOT_NULL(src);
+    for (size_t i = 0; i < NUM_TOKENS; ++i) {
+        avs_coap_msg_identity_t id = _anjay_coap_id_source_get(src);
+        tokens[i] = token_to_u64(&id.token);
+    }
+    _anjay_coap_id_source_release(&src);
+
+    qsort(tokens, NUM_TOKENS, sizeof(*tokens), compare_u64);
+    for (size_t i = 1; i < NUM_TOKENS; ++i) {
+        AVS_UNIT_ASSERT_TRUE(tokens[i - 1] != tokens[i]);
+    }
+    free(tokens);
+}
@@ -222,7 +222,7 @@ static int accept_response_with_timeout(coap_client_t *client,
     int recv_result = -1;
     int result = _anjay_coap_common_recv_msg_with_timeout(
             client->common.coap_ctx, client->common.socket, &client->common.in,
-            &timeout, process_received, client, &recv_result);
+            &timeout, process_received, client, true, &recv_result);
     if (result) {
         return result;
     }
@@ -278,6 +278,7 @@ static int send_confirmable_with_retry(coap_client_t *client,
         .retry_count = 0,
         .recv_timeout = AVS_TIME_DURATION_ZERO
     };
+    const avs_time_monotonic_t sent_time = avs_time_monotonic_now();
     int result;
     do {
         if ((result = send_and_update_retry_state(client, msg, &retry_state))) {
@@ -300,6 +301,14 @@ static int send_confirmable_with_retry(coap_client_t *client,
             client->common.coap_ctx).max_retransmit);
 
     assert(result <= 0 || result == COAP_CLIENT_RECEIVE_RESET);
+    // Karn's algorithm: the RTT is ambiguous if the request was retransmitted
+    if ((result == 0 || result == COAP_CLIENT_RECEIVE_RESET)
+            && retry_state.retry_count == 1
+            && client->common.traffic_stats) {
+        _anjay_traffic_stats_add_rtt_sample(
+                client->common.traffic_stats,
+                avs_time_monotonic_diff(avs_time_monotonic_now(), sent_time));
+    }
     if (result != 0) {
         client->state = COAP_CLIENT_STATE_HAS_REQUEST_HEADER;
     }
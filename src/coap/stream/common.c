@@ -100,12 +100,32 @@ static void set_socket_timeout(avs_net_abstract_socket_t *socket,
     }
 }
 
+/**
+ * avs_net waits on the socket with millisecond resolution, so the remaining
+ * time is rounded up to whole milliseconds. This lets consecutive messages
+ * handled within the same millisecond reuse the already applied timeout.
+ */
+static avs_time_duration_t
+round_up_to_socket_granularity(avs_time_duration_t timeout) {
+    int64_t timeout_ms;
+    if (avs_time_duration_to_scalar(&timeout_ms, AVS_TIME_MS, timeout)) {
+        return timeout;
+    }
+    avs_time_duration_t result =
+            avs_time_duration_from_scalar(timeout_ms, AVS_TIME_MS);
+    if (avs_time_duration_less(result, timeout)) {
+        result = avs_time_duration_from_scalar(timeout_ms + 1, AVS_TIME_MS);
+    }
+    return result;
+}
+
 int _anjay_coap_common_recv_msg_with_timeout(avs_coap_ctx_t *ctx,
                                              avs_net_abstract_socket_t *socket,
                                              coap_input_buffer_t *in,
                                              avs_time_duration_t *inout_timeout,
                                              recv_msg_handler_t *handle_msg,
                                              void *handle_msg_data,
+                                             bool defer_requests,
                                              int *out_handler_result) {
     avs_net_socket_opt_value_t original_recv_timeout;
     if (avs_net_socket_get_opt(socket, AVS_NET_SOCKET_OPT_RECV_TIMEOUT,
@@ -115,13 +135,22 @@ int _anjay_coap_common_recv_msg_with_timeout(avs_coap_ctx_t *ctx,
         return -1;
     }
 
-    avs_time_monotonic_t start_time = avs_time_monotonic_now();
-
-    const avs_time_duration_t initial_timeout = *inout_timeout;
+    // The actual waiting is done by avs_net, which polls the socket with its
+    // configured receive timeout. That option only needs to be updated if
+    // the time left until the deadline, at the socket's granularity, differs
+    // from what is already set.
+    const avs_time_monotonic_t deadline =
+            avs_time_monotonic_add(avs_time_monotonic_now(), *inout_timeout);
+    avs_time_duration_t applied_timeout = original_recv_timeout.recv_timeout;
     int result = 0;
 
     while (avs_time_duration_less(AVS_TIME_DURATION_ZERO, *inout_timeout)) {
-        set_socket_timeout(socket, *inout_timeout);
+        const avs_time_duration_t socket_timeout =
+                round_up_to_socket_granularity(*inout_timeout);
+        if (!avs_time_duration_equal(applied_timeout, socket_timeout)) {
+            set_socket_timeout(socket, socket_timeout);
+            applied_timeout = socket_timeout;
+        }
 
         result = _anjay_coap_in_get_next_message(in, ctx, socket);
         switch (result) {
@@ -138,9 +167,8 @@ int _anjay_coap_common_recv_msg_with_timeout(avs_coap_ctx_t *ctx,
             break;
         }
 
-        avs_time_duration_t time_elapsed =
-                avs_time_monotonic_diff(avs_time_monotonic_now(), start_time);
-        *inout_timeout = avs_time_duration_diff(initial_timeout, time_elapsed);
+        *inout_timeout = avs_time_monotonic_diff(deadline,
+                                                 avs_time_monotonic_now());
 
         if (!result) {
             const avs_coap_msg_t *msg = _anjay_coap_in_get_message(in);
@@ -154,6 +182,11 @@ int _anjay_coap_common_recv_msg_with_timeout(avs_coap_ctx_t *ctx,
                 goto exit;
             }
 
+            if (defer_requests && avs_coap_msg_is_request(msg)
+                    && !_anjay_coap_in_defer_request(in, socket, msg)) {
+                continue;
+            }
+
             if (!error_code) {
                 if (avs_coap_msg_get_type(msg) == AVS_COAP_MSG_CONFIRMABLE) {
                     avs_coap_ctx_send_empty(ctx, socket, AVS_COAP_MSG_RESET,
@@ -172,7 +205,10 @@ int _anjay_coap_common_recv_msg_with_timeout(avs_coap_ctx_t *ctx,
     result = AVS_COAP_CTX_ERR_TIMEOUT;
 
 exit:
-    set_socket_timeout(socket, original_recv_timeout.recv_timeout);
+    if (!avs_time_duration_equal(applied_timeout,
+                                 original_recv_timeout.recv_timeout)) {
+        set_socket_timeout(socket, original_recv_timeout.recv_timeout);
+    }
 
     assert(result <= 0);
     return result;
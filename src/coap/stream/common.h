@@ -35,6 +35,9 @@ typedef struct coap_stream_common {
 
     coap_input_buffer_t in;
     coap_output_buffer_t out;
+
+    // counters of the connection the stream is bound to; may be NULL
+    anjay_traffic_stats_t *traffic_stats;
 } coap_stream_common_t;
 
 int _anjay_coap_common_fill_msg_info(avs_coap_msg_info_t *info,
@@ -76,6 +79,11 @@ typedef int recv_msg_handler_t(const avs_coap_msg_t *msg,
  * @param        handle_msg         Function to call after successfully
  *                                  receiving the message.
  * @param        handle_msg_data    Opaque pointer passed to @p handle_msg.
+ * @param        defer_requests     If true, requests that @p handle_msg does
+ *                                  not accept are deferred (see
+ *                                  @ref _anjay_coap_in_defer_request) instead
+ *                                  of being rejected. Should be set while
+ *                                  waiting for a response to a client request.
  * @param[out]   out_handler_result Set to the return value of @p handle_msg .
  *                                  Only valid if the function succeeds.
  *
@@ -91,6 +99,7 @@ int _anjay_coap_common_recv_msg_with_timeout(avs_coap_ctx_t *ctx,
                                              avs_time_duration_t *inout_timeout,
                                              recv_msg_handler_t *handle_msg,
                                              void *handle_msg_data,
+                                             bool defer_requests,
                                              int *out_handler_result);
 
 uint32_t _anjay_coap_common_timestamp(void);
@@ -26,17 +26,102 @@
 #include <stdint.h>
 #include <stddef.h>
 #include <stdlib.h>
+#include <string.h>
 #include <errno.h>
 
 #include "../coap_log.h"
 
 VISIBILITY_SOURCE_BEGIN
 
+static size_t msg_size(const avs_coap_msg_t *msg) {
+    return offsetof(avs_coap_msg_t, content) + msg->length;
+}
+
+static AVS_LIST(coap_deferred_request_t) *
+find_deferred_request_ptr(coap_input_buffer_t *in,
+                          avs_net_abstract_socket_t *socket) {
+    AVS_LIST(coap_deferred_request_t) *it;
+    AVS_LIST_FOREACH_PTR(it, &in->deferred_requests) {
+        if (!socket || (*it)->socket == socket) {
+            return it;
+        }
+    }
+    return NULL;
+}
+
+static void delete_deferred_request(AVS_LIST(coap_deferred_request_t) *ptr) {
+    free((*ptr)->msg);
+    AVS_LIST_DELETE(ptr);
+}
+
+int _anjay_coap_in_replay_deferred_request(coap_input_buffer_t *in,
+                                           avs_net_abstract_socket_t *socket) {
+    in->replay_deferred_request = false;
+    AVS_LIST(coap_deferred_request_t) *request_ptr =
+            find_deferred_request_ptr(in, socket);
+    if (!request_ptr) {
+        return -1;
+    }
+
+    size_t size = msg_size((*request_ptr)->msg);
+    assert(size <= in->buffer_size);
+    memcpy(in->buffer, (*request_ptr)->msg, size);
+    delete_deferred_request(request_ptr);
+    in->replay_deferred_request = true;
+    coap_log(TRACE, "replaying deferred request, msg_id = %u",
+             avs_coap_msg_get_id(_anjay_coap_in_get_message(in)));
+    return 0;
+}
+
+static bool request_served(const coap_input_buffer_t *in,
+                           avs_net_abstract_socket_t *socket,
+                           uint16_t msg_id) {
+    for (size_t i = 0; i < COAP_SERVED_REQUESTS_HISTORY; ++i) {
+        if (in->served_requests[i].socket == socket
+                && in->served_requests[i].msg_id == msg_id) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void _anjay_coap_in_mark_request_served(coap_input_buffer_t *in,
+                                        avs_net_abstract_socket_t *socket) {
+    const avs_coap_msg_t *msg = _anjay_coap_in_get_message(in);
+    if (!avs_coap_msg_is_request(msg)) {
+        return;
+    }
+    uint16_t msg_id = avs_coap_msg_get_id(msg);
+    if (!request_served(in, socket, msg_id)) {
+        in->served_requests[in->next_served_request].socket = socket;
+        in->served_requests[in->next_served_request].msg_id = msg_id;
+        in->next_served_request =
+                (in->next_served_request + 1) % COAP_SERVED_REQUESTS_HISTORY;
+    }
+
+    AVS_LIST(coap_deferred_request_t) *it;
+    AVS_LIST(coap_deferred_request_t) helper;
+    AVS_LIST_DELETABLE_FOREACH_PTR(it, helper, &in->deferred_requests) {
+        if ((*it)->socket == socket
+                && avs_coap_msg_get_id((*it)->msg) == msg_id) {
+            coap_log(DEBUG, "dropping deferred retransmission of request %u",
+                     msg_id);
+            delete_deferred_request(it);
+        }
+    }
+}
+
 int _anjay_coap_in_get_next_message(coap_input_buffer_t *in,
                                     avs_coap_ctx_t *ctx,
                                     avs_net_abstract_socket_t *socket) {
-    int result = avs_coap_ctx_recv(ctx, socket, (avs_coap_msg_t *) in->buffer,
+    int result;
+    if (in->replay_deferred_request) {
+        in->replay_deferred_request = false;
+        result = 0;
+    } else {
+        result = avs_coap_ctx_recv(ctx, socket, (avs_coap_msg_t *) in->buffer,
                                    in->buffer_size);
+    }
     if (result) {
         int error = avs_net_socket_errno(socket);
         if (error) {
@@ -70,3 +155,57 @@ void _anjay_coap_in_read(coap_input_buffer_t *in,
     *out_message_finished = (in->payload_off >= in->payload_size);
 }
 
+int _anjay_coap_in_defer_request(coap_input_buffer_t *in,
+                                 avs_net_abstract_socket_t *socket,
+                                 const avs_coap_msg_t *msg) {
+    size_t num_deferred = 0;
+    AVS_LIST(coap_deferred_request_t) it;
+    AVS_LIST_FOREACH(it, in->deferred_requests) {
+        if (it->socket == socket
+                && avs_coap_msg_get_id(it->msg) == avs_coap_msg_get_id(msg)) {
+            coap_log(TRACE, "request %u already deferred",
+                     avs_coap_msg_get_id(msg));
+            return 0;
+        }
+        ++num_deferred;
+    }
+    if (request_served(in, socket, avs_coap_msg_get_id(msg))) {
+        coap_log(TRACE, "request %u already served",
+                 avs_coap_msg_get_id(msg));
+        return 0;
+    }
+
+    AVS_LIST(coap_deferred_request_t) request = NULL;
+    if (num_deferred < COAP_MAX_DEFERRED_REQUESTS
+            && (request = AVS_LIST_NEW_ELEMENT(coap_deferred_request_t))
+            && !(request->msg = (avs_coap_msg_t *) malloc(msg_size(msg)))) {
+        AVS_LIST_DELETE(&request);
+    }
+    if (!request) {
+        coap_log(DEBUG, "could not defer request %u",
+                 avs_coap_msg_get_id(msg));
+        ++in->num_dropped_deferred_requests;
+        return -1;
+    }
+
+    memcpy(request->msg, msg, msg_size(msg));
+    request->socket = socket;
+    AVS_LIST_APPEND(&in->deferred_requests, request);
+    ++in->num_deferred_requests;
+    coap_log(DEBUG, "request %u deferred until the current exchange finishes",
+             avs_coap_msg_get_id(msg));
+    return 0;
+}
+
+void _anjay_coap_in_drop_deferred_requests(coap_input_buffer_t *in,
+                                           avs_net_abstract_socket_t *socket) {
+    AVS_LIST(coap_deferred_request_t) *request_ptr;
+    while ((request_ptr = find_deferred_request_ptr(in, socket))) {
+        delete_deferred_request(request_ptr);
+    }
+    for (size_t i = 0; i < COAP_SERVED_REQUESTS_HISTORY; ++i) {
+        if (!socket || in->served_requests[i].socket == socket) {
+            in->served_requests[i].socket = NULL;
+        }
+    }
+}
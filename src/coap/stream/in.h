@@ -31,6 +31,29 @@
 
 VISIBILITY_PRIVATE_HEADER_BEGIN
 
+/**
+ * Maximum number of incoming requests that may be deferred while waiting for
+ * a response to a client request. Any further requests are rejected with
+ * 5.03 Service Unavailable, like before the queue was introduced.
+ */
+#define COAP_MAX_DEFERRED_REQUESTS 4
+
+/**
+ * Number of requests served most recently whose identities are remembered, so
+ * that their retransmissions are neither deferred nor replayed.
+ */
+#define COAP_SERVED_REQUESTS_HISTORY 8
+
+typedef struct {
+    avs_net_abstract_socket_t *socket;
+    avs_coap_msg_t *msg;
+} coap_deferred_request_t;
+
+typedef struct {
+    avs_net_abstract_socket_t *socket;
+    uint16_t msg_id;
+} coap_served_request_t;
+
 typedef struct coap_input_buffer {
     uint8_t *buffer;
     size_t buffer_size;
@@ -39,6 +62,24 @@ typedef struct coap_input_buffer {
     size_t payload_size;
 
     anjay_rand_seed_t rand_seed;
+
+    /**
+     * Requests received during an outstanding client exchange, in order of
+     * arrival. @ref _anjay_coap_in_replay_deferred_request moves one of them
+     * to @ref buffer and sets @ref replay_deferred_request , so that it is
+     * handed out by @ref _anjay_coap_in_get_next_message instead of reading
+     * the socket.
+     */
+    AVS_LIST(coap_deferred_request_t) deferred_requests;
+    bool replay_deferred_request;
+
+    /** Ring buffer of recently served requests; see
+     * @ref _anjay_coap_in_mark_request_served . */
+    coap_served_request_t served_requests[COAP_SERVED_REQUESTS_HISTORY];
+    size_t next_served_request;
+
+    uint64_t num_deferred_requests;
+    uint64_t num_dropped_deferred_requests;
 } coap_input_buffer_t;
 
 static inline void _anjay_coap_in_reset(coap_input_buffer_t *in) {
@@ -79,6 +120,45 @@ int _anjay_coap_in_get_next_message(coap_input_buffer_t *in,
                                     avs_coap_ctx_t *ctx,
                                     avs_net_abstract_socket_t *socket);
 
+/**
+ * Stores a copy of the request @p msg received on @p socket , so that it can
+ * be handled once the current exchange is finished. Retransmissions of a
+ * request that is already deferred or has recently been served are ignored.
+ *
+ * @returns 0 if the request has been deferred, negative value if it needs to
+ *          be rejected because the queue is full or out of memory.
+ */
+int _anjay_coap_in_defer_request(coap_input_buffer_t *in,
+                                 avs_net_abstract_socket_t *socket,
+                                 const avs_coap_msg_t *msg);
+
+/**
+ * Removes the oldest request deferred on @p socket from the queue and stores
+ * it in the input buffer, so that the next call to
+ * @ref _anjay_coap_in_get_next_message returns it instead of reading from the
+ * socket.
+ *
+ * @returns 0 on success, negative value if there are no such requests.
+ */
+int _anjay_coap_in_replay_deferred_request(coap_input_buffer_t *in,
+                                           avs_net_abstract_socket_t *socket);
+
+/**
+ * Remembers that the request currently held in the input buffer, received on
+ * @p socket , is being served, and discards any of its retransmissions that
+ * have been deferred in the meantime.
+ */
+void _anjay_coap_in_mark_request_served(coap_input_buffer_t *in,
+                                        avs_net_abstract_socket_t *socket);
+
+/**
+ * Discards deferred requests received on @p socket , or all deferred requests
+ * if @p socket is NULL. Recently served requests received on that socket are
+ * forgotten as well.
+ */
+void _anjay_coap_in_drop_deferred_requests(coap_input_buffer_t *in,
+                                           avs_net_abstract_socket_t *socket);
+
 void _anjay_coap_in_read(coap_input_buffer_t *in,
                          size_t *out_bytes_read,
                          char *out_message_finished,
@@ -308,6 +308,8 @@ static int receive_request(coap_server_t *server) {
     if (result) {
         return result;
     }
+    _anjay_coap_in_mark_request_served(&server->common.in,
+                                       server->common.socket);
 
     const avs_coap_msg_t *msg = _anjay_coap_in_get_message(&server->common.in);
     switch (process_initial_request(server, msg)) {
@@ -569,7 +571,7 @@ static int receive_next_block_with_timeout(coap_server_t *server) {
         int result = _anjay_coap_common_recv_msg_with_timeout(
                 server->common.coap_ctx, server->common.socket,
                 &server->common.in, &timeout, receive_next_block, server,
-                &recv_result);
+                false, &recv_result);
         if (result) {
             return result;
         }
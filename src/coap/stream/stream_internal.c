@@ -160,6 +160,9 @@ static int coap_setsock(avs_stream_abstract_t *stream_,
         return -1;
     }
 
+    // a request replayed on the previous socket must not be handed out as if
+    // it was received on the new one
+    stream->data.common.in.replay_deferred_request = false;
     stream->data.common.socket = sock;
     return 0;
 }
@@ -254,6 +257,7 @@ static int coap_close(avs_stream_abstract_t *stream_) {
     coap_stream_t *stream = (coap_stream_t *)stream_;
 
     reset(stream);
+    _anjay_coap_in_drop_deferred_requests(&stream->data.common.in, NULL);
 
     if (stream->data.common.socket) {
         avs_net_socket_cleanup(&stream->data.common.socket);
@@ -452,3 +456,62 @@ void _anjay_coap_stream_set_block_request_validator(
     _anjay_coap_server_set_block_request_relation_validator(
             get_server(stream), validator, validator_arg);
 }
+
+avs_net_abstract_socket_t *
+_anjay_coap_stream_get_deferred_request_socket(avs_stream_abstract_t *stream_) {
+    coap_stream_t *stream = (coap_stream_t*)stream_;
+    assert(stream->vtable == &COAP_STREAM_VTABLE);
+
+    AVS_LIST(coap_deferred_request_t) first =
+            stream->data.common.in.deferred_requests;
+    return first ? first->socket : NULL;
+}
+
+size_t
+_anjay_coap_stream_num_deferred_requests(avs_stream_abstract_t *stream_) {
+    coap_stream_t *stream = (coap_stream_t*)stream_;
+    assert(stream->vtable == &COAP_STREAM_VTABLE);
+
+    return AVS_LIST_SIZE(stream->data.common.in.deferred_requests);
+}
+
+int _anjay_coap_stream_replay_deferred_request(avs_stream_abstract_t *stream_) {
+    coap_stream_t *stream = (coap_stream_t*)stream_;
+    assert(stream->vtable == &COAP_STREAM_VTABLE);
+
+    if (!is_reset(stream) || !stream->data.common.socket) {
+        coap_log(ERROR, "replaying requests requires an idle, bound stream");
+        return -1;
+    }
+    return _anjay_coap_in_replay_deferred_request(&stream->data.common.in,
+                                                  stream->data.common.socket);
+}
+
+void _anjay_coap_stream_drop_deferred_requests(
+        avs_stream_abstract_t *stream_,
+        avs_net_abstract_socket_t *socket) {
+    coap_stream_t *stream = (coap_stream_t*)stream_;
+    assert(stream->vtable == &COAP_STREAM_VTABLE);
+    assert(socket);
+
+    _anjay_coap_in_drop_deferred_requests(&stream->data.common.in, socket);
+}
+
+void _anjay_coap_stream_get_deferred_request_stats(
+        avs_stream_abstract_t *stream_,
+        uint64_t *out_num_deferred,
+        uint64_t *out_num_dropped) {
+    coap_stream_t *stream = (coap_stream_t*)stream_;
+    assert(stream->vtable == &COAP_STREAM_VTABLE);
+
+    *out_num_deferred = stream->data.common.in.num_deferred_requests;
+    *out_num_dropped = stream->data.common.in.num_dropped_deferred_requests;
+}
+
+void _anjay_coap_stream_set_traffic_stats(avs_stream_abstract_t *stream_,
+                                          anjay_traffic_stats_t *stats) {
+    coap_stream_t *stream = (coap_stream_t*)stream_;
+    assert(stream->vtable == &COAP_STREAM_VTABLE);
+
+    stream->data.common.traffic_stats = stats;
+}
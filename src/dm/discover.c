@@ -49,6 +49,20 @@ static int print_con_attr(avs_stream_abstract_t *stream,
 #define print_con_attr(...) 0
 #endif // WITH_CON_ATTR
 
+#ifdef WITH_EVAL_PERIOD_ATTRS
+static int print_eval_period_attrs(avs_stream_abstract_t *stream,
+                                   const anjay_dm_custom_attrs_t *attrs) {
+    int result = 0;
+    (void) ((result = print_time_attr(stream, ANJAY_CUSTOM_ATTR_EPMIN,
+                                      attrs->min_eval_period))
+            || (result = print_time_attr(stream, ANJAY_CUSTOM_ATTR_EPMAX,
+                                         attrs->max_eval_period)));
+    return result;
+}
+#else // WITH_EVAL_PERIOD_ATTRS
+#define print_eval_period_attrs(...) 0
+#endif // WITH_EVAL_PERIOD_ATTRS
+
 static int print_double_attr(avs_stream_abstract_t *stream,
                              const char *name,
                              double value) {
@@ -65,7 +79,9 @@ static int print_attrs(avs_stream_abstract_t *stream,
                                       attrs->standard.min_period))
             || (result = print_time_attr(stream, ANJAY_ATTR_PMAX,
                                          attrs->standard.max_period))
-            || (result = print_con_attr(stream, attrs->custom.data.con)));
+            || (result = print_con_attr(stream, attrs->custom.data.con))
+            || (result = print_eval_period_attrs(stream,
+                                                 &attrs->custom.data)));
     return result;
 }
 
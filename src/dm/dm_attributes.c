@@ -48,6 +48,12 @@ static inline void combine_attrs(anjay_dm_internal_attrs_t *out,
     if (out->custom.data.con < 0) {
         out->custom.data.con = other->custom.data.con;
     }
+#endif
+#ifdef WITH_EVAL_PERIOD_ATTRS
+    combine_period(&out->custom.data.min_eval_period,
+                   other->custom.data.min_eval_period);
+    combine_period(&out->custom.data.max_eval_period,
+                   other->custom.data.max_eval_period);
 #endif
     combine_period(&out->standard.min_period, other->standard.min_period);
     combine_period(&out->standard.max_period, other->standard.max_period);
@@ -163,6 +169,10 @@ bool _anjay_dm_attributes_empty(const anjay_dm_internal_attrs_t *attrs) {
             && attrs->standard.max_period < 0
 #ifdef WITH_CON_ATTR
             && attrs->custom.data.con < 0
+#endif
+#ifdef WITH_EVAL_PERIOD_ATTRS
+            && attrs->custom.data.min_eval_period < 0
+            && attrs->custom.data.max_eval_period < 0
 #endif
             ;
 }
@@ -181,6 +191,10 @@ bool _anjay_dm_attributes_full(const anjay_dm_internal_attrs_t *attrs) {
             && attrs->standard.max_period >= 0
 #ifdef WITH_CON_ATTR
             && attrs->custom.data.con >= 0
+#endif
+#ifdef WITH_EVAL_PERIOD_ATTRS
+            && attrs->custom.data.min_eval_period >= 0
+            && attrs->custom.data.max_eval_period >= 0
 #endif
             ;
 }
@@ -28,6 +28,8 @@ VISIBILITY_PRIVATE_HEADER_BEGIN
 #define ANJAY_ATTR_SSID "ssid"
 
 #define ANJAY_CUSTOM_ATTR_CON "con"
+#define ANJAY_CUSTOM_ATTR_EPMIN "epmin"
+#define ANJAY_CUSTOM_ATTR_EPMAX "epmax"
 
 typedef struct {
     /** Object whose Instance is being queried. */
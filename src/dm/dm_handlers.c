@@ -143,6 +143,7 @@ int _anjay_dm_instance_reset(anjay_t *anjay,
                              anjay_iid_t iid,
                              const anjay_dm_module_t *current_module) {
     dm_log(TRACE, "instance_reset /%u/%u", (*obj_ptr)->oid, iid);
+    _anjay_dm_read_cache_invalidate_instance(anjay, (*obj_ptr)->oid, iid);
     int result = _anjay_dm_transaction_include_object(anjay, obj_ptr);
     if (result) {
         return result;
@@ -292,6 +293,7 @@ int _anjay_dm_resource_write(anjay_t *anjay,
                              anjay_input_ctx_t *ctx,
                              const anjay_dm_module_t *current_module) {
     anjay_log(TRACE, "resource_write /%u/%u/%u", (*obj_ptr)->oid, iid, rid);
+    _anjay_dm_read_cache_invalidate(anjay, (*obj_ptr)->oid, iid, rid);
     int result = _anjay_dm_transaction_include_object(anjay, obj_ptr);
     if (result) {
         return result;
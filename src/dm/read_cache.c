@@ -0,0 +1,425 @@
+/*
+ * Copyright 2017 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <config.h>
+
+#include <assert.h>
+#include <string.h>
+
+#include "read_cache.h"
+
+#include "../anjay_core.h"
+#include "../io/vtable.h"
+
+VISIBILITY_SOURCE_BEGIN
+
+typedef enum {
+    CACHED_BYTES,
+    CACHED_STRING,
+    CACHED_I32,
+    CACHED_I64,
+    CACHED_FLOAT,
+    CACHED_DOUBLE,
+    CACHED_BOOL,
+    CACHED_OBJLNK,
+    CACHED_ARRAY_START,
+    CACHED_ARRAY_INDEX,
+    CACHED_ARRAY_FINISH
+} cached_value_type_t;
+
+/**
+ * A single anjay_ret_* call made by the resource_read handler. Bytes and
+ * strings are stored in @ref cached_value_t.data .
+ */
+typedef struct {
+    cached_value_type_t type;
+    union {
+        int32_t i32;
+        int64_t i64;
+        float f32;
+        double f64;
+        bool boolean;
+        struct {
+            anjay_oid_t oid;
+            anjay_iid_t iid;
+        } objlnk;
+        anjay_riid_t riid;
+        struct {
+            size_t declared_size;
+            size_t written;
+        } bytes;
+    } value;
+    char data[];
+} cached_value_t;
+
+struct anjay_dm_read_cache_entry_struct {
+    anjay_oid_t oid;
+    anjay_iid_t iid;
+    anjay_rid_t rid;
+    avs_time_monotonic_t expires;
+    AVS_LIST(cached_value_t) values;
+};
+
+typedef struct {
+    const anjay_output_ctx_vtable_t *vtable;
+    const anjay_ret_bytes_ctx_vtable_t *ret_bytes_vtable;
+    int errno_;
+    AVS_LIST(cached_value_t) *append_ptr;
+    cached_value_t *bytes;
+} recording_ctx_t;
+
+static AVS_LIST(cached_value_t) record_value(anjay_output_ctx_t *ctx_,
+                                             cached_value_type_t type,
+                                             size_t data_size) {
+    recording_ctx_t *ctx = (recording_ctx_t *) ctx_;
+    AVS_LIST(cached_value_t) value = (AVS_LIST(cached_value_t))
+            AVS_LIST_NEW_BUFFER(sizeof(cached_value_t) + data_size);
+    if (!value) {
+        anjay_log(ERROR, "out of memory");
+        return NULL;
+    }
+    value->type = type;
+    AVS_LIST_INSERT(ctx->append_ptr, value);
+    ctx->append_ptr = AVS_LIST_NEXT_PTR(ctx->append_ptr);
+    return value;
+}
+
+static int *recording_errno_ptr(anjay_output_ctx_t *ctx) {
+    return &((recording_ctx_t *) ctx)->errno_;
+}
+
+static anjay_ret_bytes_ctx_t *recording_bytes_begin(anjay_output_ctx_t *ctx,
+                                                    size_t length) {
+    cached_value_t *value = record_value(ctx, CACHED_BYTES, length);
+    if (!value) {
+        return NULL;
+    }
+    value->value.bytes.declared_size = length;
+    ((recording_ctx_t *) ctx)->bytes = value;
+    return (anjay_ret_bytes_ctx_t *)
+            &((recording_ctx_t *) ctx)->ret_bytes_vtable;
+}
+
+static int recording_bytes_append(anjay_ret_bytes_ctx_t *ctx_,
+                                  const void *data,
+                                  size_t size) {
+    recording_ctx_t *ctx =
+            AVS_CONTAINER_OF(ctx_, recording_ctx_t, ret_bytes_vtable);
+    cached_value_t *value = ctx->bytes;
+    assert(value);
+    if (size > value->value.bytes.declared_size - value->value.bytes.written) {
+        anjay_log(ERROR, "more bytes returned than declared");
+        return -1;
+    }
+    memcpy(value->data + value->value.bytes.written, data, size);
+    value->value.bytes.written += size;
+    return 0;
+}
+
+static int recording_string(anjay_output_ctx_t *ctx, const char *str) {
+    size_t size = strlen(str) + 1;
+    cached_value_t *value = record_value(ctx, CACHED_STRING, size);
+    if (!value) {
+        return -1;
+    }
+    memcpy(value->data, str, size);
+    return 0;
+}
+
+#define DEFINE_RECORDING_HANDLER(Suffix, Type, Field, Tag) \
+    static int recording_##Suffix(anjay_output_ctx_t *ctx, Type arg) { \
+        cached_value_t *value = record_value(ctx, Tag, 0); \
+        if (!value) { \
+            return -1; \
+        } \
+        value->value.Field = arg; \
+        return 0; \
+    }
+
+DEFINE_RECORDING_HANDLER(i32, int32_t, i32, CACHED_I32)
+DEFINE_RECORDING_HANDLER(i64, int64_t, i64, CACHED_I64)
+DEFINE_RECORDING_HANDLER(float, float, f32, CACHED_FLOAT)
+DEFINE_RECORDING_HANDLER(double, double, f64, CACHED_DOUBLE)
+DEFINE_RECORDING_HANDLER(bool, bool, boolean, CACHED_BOOL)
+
+static int recording_objlnk(anjay_output_ctx_t *ctx,
+                            anjay_oid_t oid,
+                            anjay_iid_t iid) {
+    cached_value_t *value = record_value(ctx, CACHED_OBJLNK, 0);
+    if (!value) {
+        return -1;
+    }
+    value->value.objlnk.oid = oid;
+    value->value.objlnk.iid = iid;
+    return 0;
+}
+
+// Resource Instances cannot be nested, so the same context is used for them
+static anjay_output_ctx_t *recording_array_start(anjay_output_ctx_t *ctx) {
+    return record_value(ctx, CACHED_ARRAY_START, 0) ? ctx : NULL;
+}
+
+static int recording_array_finish(anjay_output_ctx_t *ctx) {
+    return record_value(ctx, CACHED_ARRAY_FINISH, 0) ? 0 : -1;
+}
+
+static int recording_set_id(anjay_output_ctx_t *ctx,
+                            anjay_id_type_t type,
+                            uint16_t id) {
+    if (type != ANJAY_ID_RIID) {
+        return -1;
+    }
+    cached_value_t *value = record_value(ctx, CACHED_ARRAY_INDEX, 0);
+    if (!value) {
+        return -1;
+    }
+    value->value.riid = id;
+    return 0;
+}
+
+static const anjay_output_ctx_vtable_t RECORDING_VTABLE = {
+    .errno_ptr = recording_errno_ptr,
+    .bytes_begin = recording_bytes_begin,
+    .string = recording_string,
+    .i32 = recording_i32,
+    .i64 = recording_i64,
+    .f32 = recording_float,
+    .f64 = recording_double,
+    .boolean = recording_bool,
+    .objlnk = recording_objlnk,
+    .array_start = recording_array_start,
+    .array_finish = recording_array_finish,
+    .set_id = recording_set_id
+};
+
+static const anjay_ret_bytes_ctx_vtable_t RECORDING_BYTES_VTABLE = {
+    .append = recording_bytes_append
+};
+
+static int replay_bytes(anjay_output_ctx_t *ctx, const cached_value_t *value) {
+    anjay_ret_bytes_ctx_t *bytes =
+            anjay_ret_bytes_begin(ctx, value->value.bytes.declared_size);
+    if (!bytes) {
+        return -1;
+    }
+    if (!value->value.bytes.written) {
+        return 0;
+    }
+    return anjay_ret_bytes_append(bytes, value->data,
+                                  value->value.bytes.written);
+}
+
+static int replay(anjay_output_ctx_t *out_ctx,
+                  AVS_LIST(const cached_value_t) values) {
+    anjay_output_ctx_t *ctx = out_ctx;
+    AVS_LIST(const cached_value_t) value;
+    AVS_LIST_FOREACH(value, values) {
+        int result = 0;
+        switch (value->type) {
+        case CACHED_BYTES:
+            result = replay_bytes(ctx, value);
+            break;
+        case CACHED_STRING:
+            result = anjay_ret_string(ctx, value->data);
+            break;
+        case CACHED_I32:
+            result = anjay_ret_i32(ctx, value->value.i32);
+            break;
+        case CACHED_I64:
+            result = anjay_ret_i64(ctx, value->value.i64);
+            break;
+        case CACHED_FLOAT:
+            result = anjay_ret_float(ctx, value->value.f32);
+            break;
+        case CACHED_DOUBLE:
+            result = anjay_ret_double(ctx, value->value.f64);
+            break;
+        case CACHED_BOOL:
+            result = anjay_ret_bool(ctx, value->value.boolean);
+            break;
+        case CACHED_OBJLNK:
+            result = anjay_ret_objlnk(ctx, value->value.objlnk.oid,
+                                      value->value.objlnk.iid);
+            break;
+        case CACHED_ARRAY_START:
+            if (!(ctx = anjay_ret_array_start(out_ctx))) {
+                result = -1;
+            }
+            break;
+        case CACHED_ARRAY_INDEX:
+            result = anjay_ret_array_index(ctx, value->value.riid);
+            break;
+        case CACHED_ARRAY_FINISH:
+            result = anjay_ret_array_finish(ctx);
+            ctx = out_ctx;
+            break;
+        }
+        if (result) {
+            return result;
+        }
+    }
+    return 0;
+}
+
+static void delete_entry(AVS_LIST(anjay_dm_read_cache_entry_t) *entry_ptr) {
+    AVS_LIST_CLEAR(&(*entry_ptr)->values);
+    AVS_LIST_DELETE(entry_ptr);
+}
+
+static AVS_LIST(anjay_dm_read_cache_entry_t) *
+find_entry_ptr(anjay_t *anjay,
+               anjay_oid_t oid,
+               anjay_iid_t iid,
+               anjay_rid_t rid) {
+    AVS_LIST(anjay_dm_read_cache_entry_t) *it;
+    AVS_LIST_FOREACH_PTR(it, &anjay->dm.read_cache) {
+        if ((*it)->oid == oid && (*it)->iid == iid && (*it)->rid == rid) {
+            return it;
+        }
+    }
+    return NULL;
+}
+
+static int read_and_record(anjay_t *anjay,
+                           const anjay_dm_object_def_t *const *obj,
+                           anjay_iid_t iid,
+                           anjay_rid_t rid,
+                           anjay_output_ctx_t *out_ctx) {
+    AVS_LIST(anjay_dm_read_cache_entry_t) entry =
+            AVS_LIST_NEW_ELEMENT(anjay_dm_read_cache_entry_t);
+    if (!entry) {
+        anjay_log(ERROR, "out of memory");
+        return _anjay_dm_resource_read(anjay, obj, iid, rid, out_ctx, NULL);
+    }
+
+    recording_ctx_t recorder = {
+        .vtable = &RECORDING_VTABLE,
+        .ret_bytes_vtable = &RECORDING_BYTES_VTABLE,
+        .append_ptr = &entry->values
+    };
+    int result = _anjay_dm_resource_read(anjay, obj, iid, rid,
+                                         (anjay_output_ctx_t *) &recorder,
+                                         NULL);
+    if (!result) {
+        result = replay(out_ctx, entry->values);
+    }
+    // a handler that did not return any value is left for the output context
+    // to complain about; there is nothing worth caching in that case
+    if (result || !entry->values) {
+        delete_entry(&entry);
+        return result;
+    }
+
+    entry->oid = (*obj)->oid;
+    entry->iid = iid;
+    entry->rid = rid;
+    entry->expires = avs_time_monotonic_add(avs_time_monotonic_now(),
+                                            (*obj)->read_cache_ttl);
+    AVS_LIST_INSERT(&anjay->dm.read_cache, entry);
+    return 0;
+}
+
+/**
+ * Looks up the entry for the given Resource, deleting all expired entries on
+ * the way. Entries are only looked up by Resource path, so without this, the
+ * value of a Resource that is not read again would stay in memory until its
+ * Object is invalidated.
+ */
+static AVS_LIST(anjay_dm_read_cache_entry_t) *
+find_live_entry_ptr(anjay_t *anjay,
+                    anjay_oid_t oid,
+                    anjay_iid_t iid,
+                    anjay_rid_t rid) {
+    const avs_time_monotonic_t now = avs_time_monotonic_now();
+    AVS_LIST(anjay_dm_read_cache_entry_t) *result = NULL;
+    AVS_LIST(anjay_dm_read_cache_entry_t) *it = &anjay->dm.read_cache;
+    while (*it) {
+        if (!avs_time_monotonic_before(now, (*it)->expires)) {
+            delete_entry(it);
+            continue;
+        }
+        if ((*it)->oid == oid && (*it)->iid == iid && (*it)->rid == rid) {
+            result = it;
+        }
+        it = AVS_LIST_NEXT_PTR(it);
+    }
+    return result;
+}
+
+int _anjay_dm_read_cache_read(anjay_t *anjay,
+                              const anjay_dm_object_def_t *const *obj,
+                              anjay_iid_t iid,
+                              anjay_rid_t rid,
+                              anjay_output_ctx_t *out_ctx) {
+    if (!avs_time_duration_less(AVS_TIME_DURATION_ZERO,
+                                (*obj)->read_cache_ttl)) {
+        return _anjay_dm_resource_read(anjay, obj, iid, rid, out_ctx, NULL);
+    }
+
+    AVS_LIST(anjay_dm_read_cache_entry_t) *entry_ptr =
+            find_live_entry_ptr(anjay, (*obj)->oid, iid, rid);
+    if (entry_ptr) {
+        anjay_log(TRACE, "serving /%u/%u/%u from read cache", (*obj)->oid,
+                  iid, rid);
+        return replay(out_ctx, (*entry_ptr)->values);
+    }
+    return read_and_record(anjay, obj, iid, rid, out_ctx);
+}
+
+void _anjay_dm_read_cache_invalidate(anjay_t *anjay,
+                                     anjay_oid_t oid,
+                                     anjay_iid_t iid,
+                                     anjay_rid_t rid) {
+    AVS_LIST(anjay_dm_read_cache_entry_t) *entry_ptr =
+            find_entry_ptr(anjay, oid, iid, rid);
+    if (entry_ptr) {
+        delete_entry(entry_ptr);
+    }
+}
+
+/**
+ * Deletes cached values of all Resources of Object @p oid , limited to
+ * Instance @p iid unless it is ANJAY_IID_INVALID.
+ */
+static void invalidate_matching(anjay_t *anjay,
+                                anjay_oid_t oid,
+                                anjay_iid_t iid) {
+    AVS_LIST(anjay_dm_read_cache_entry_t) *it = &anjay->dm.read_cache;
+    while (*it) {
+        if ((*it)->oid == oid
+                && (iid == ANJAY_IID_INVALID || (*it)->iid == iid)) {
+            delete_entry(it);
+        } else {
+            it = AVS_LIST_NEXT_PTR(it);
+        }
+    }
+}
+
+void _anjay_dm_read_cache_invalidate_instance(anjay_t *anjay,
+                                              anjay_oid_t oid,
+                                              anjay_iid_t iid) {
+    invalidate_matching(anjay, oid, iid);
+}
+
+void _anjay_dm_read_cache_invalidate_object(anjay_t *anjay, anjay_oid_t oid) {
+    invalidate_matching(anjay, oid, ANJAY_IID_INVALID);
+}
+
+void _anjay_dm_read_cache_clear(anjay_t *anjay) {
+    while (anjay->dm.read_cache) {
+        delete_entry(&anjay->dm.read_cache);
+    }
+}
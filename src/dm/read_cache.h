@@ -0,0 +1,60 @@
+/*
+ * Copyright 2017 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANJAY_DM_READ_CACHE_H
+#define ANJAY_DM_READ_CACHE_H
+
+#include <anjay/dm.h>
+
+#include <avsystem/commons/list.h>
+
+VISIBILITY_PRIVATE_HEADER_BEGIN
+
+typedef struct anjay_dm_read_cache_entry_struct anjay_dm_read_cache_entry_t;
+
+/**
+ * Reads the Resource /@p (*obj)->oid /@p iid /@p rid into @p out_ctx .
+ *
+ * If the Object declares a positive <c>read_cache_ttl</c>, the values returned
+ * by its <c>resource_read</c> handler are remembered and repeated reads within
+ * that time are served without calling the handler again. Otherwise, this is
+ * equivalent to calling <c>_anjay_dm_resource_read()</c> directly.
+ */
+int _anjay_dm_read_cache_read(anjay_t *anjay,
+                              const anjay_dm_object_def_t *const *obj,
+                              anjay_iid_t iid,
+                              anjay_rid_t rid,
+                              anjay_output_ctx_t *out_ctx);
+
+/** Forgets the cached value of Resource /@p oid /@p iid /@p rid , if any. */
+void _anjay_dm_read_cache_invalidate(anjay_t *anjay,
+                                     anjay_oid_t oid,
+                                     anjay_iid_t iid,
+                                     anjay_rid_t rid);
+
+/** Forgets cached values of all Resources of Instance /@p oid /@p iid . */
+void _anjay_dm_read_cache_invalidate_instance(anjay_t *anjay,
+                                              anjay_oid_t oid,
+                                              anjay_iid_t iid);
+
+/** Forgets cached values of all Resources of Object @p oid . */
+void _anjay_dm_read_cache_invalidate_object(anjay_t *anjay, anjay_oid_t oid);
+
+void _anjay_dm_read_cache_clear(anjay_t *anjay);
+
+VISIBILITY_PRIVATE_HEADER_END
+
+#endif // ANJAY_DM_READ_CACHE_H
@@ -65,50 +65,105 @@ static int validate_supported_rids(const anjay_dm_object_def_t *obj_def) {
     return 0;
 }
 
-int anjay_register_object(anjay_t *anjay,
-                          const anjay_dm_object_def_t *const *def_ptr) {
-    assert(!anjay->transaction_state.depth);
-    assert(!anjay->transaction_state.objs_in_transaction);
+static int compare_obj_oids(const void *left_, const void *right_,
+                            size_t size) {
+    (void) size;
+    anjay_oid_t left =
+            (**(const anjay_dm_object_def_t *const *const *) left_)->oid;
+    anjay_oid_t right =
+            (**(const anjay_dm_object_def_t *const *const *) right_)->oid;
+    return left < right ? -1 : (left == right ? 0 : 1);
+}
 
-    if (!def_ptr || !*def_ptr) {
-        anjay_log(ERROR, "invalid object pointer");
-        return -1;
+static int
+make_sorted_objects_list(AVS_LIST(const anjay_dm_object_def_t *const *) *out,
+                         const anjay_dm_object_def_t *const *const *def_ptrs,
+                         size_t count) {
+    assert(!*out);
+    for (size_t i = 0; i < count; ++i) {
+        if (!def_ptrs[i] || !*def_ptrs[i]) {
+            anjay_log(ERROR, "invalid object pointer");
+            return -1;
+        }
+        if (validate_supported_rids(*def_ptrs[i])) {
+            return -1;
+        }
+        AVS_LIST(const anjay_dm_object_def_t *const *) new_elem =
+                AVS_LIST_NEW_ELEMENT(const anjay_dm_object_def_t *const *);
+        if (!new_elem) {
+            anjay_log(ERROR, "out of memory");
+            return -1;
+        }
+        *new_elem = def_ptrs[i];
+        AVS_LIST_INSERT(out, new_elem);
     }
+    AVS_LIST_SORT(out, compare_obj_oids);
+    return 0;
+}
 
-    AVS_LIST(const anjay_dm_object_def_t *const *) *obj_iter;
-
-    AVS_LIST_FOREACH_PTR(obj_iter, &anjay->dm.objects) {
-        assert(*obj_iter && **obj_iter);
-
-        if ((***obj_iter)->oid >= (*def_ptr)->oid) {
-            break;
+/**
+ * Both lists are sorted by OID, so a single parallel walk is enough to find
+ * any Object that would end up registered twice.
+ */
+static int
+check_no_duplicates(AVS_LIST(const anjay_dm_object_def_t *const *) registered,
+                    AVS_LIST(const anjay_dm_object_def_t *const *) new_objs) {
+    AVS_LIST(const anjay_dm_object_def_t *const *) it;
+    AVS_LIST_FOREACH(it, new_objs) {
+        if (AVS_LIST_NEXT(it) && (**it)->oid == (**AVS_LIST_NEXT(it))->oid) {
+            anjay_log(ERROR, "data model object /%u passed more than once",
+                      (**it)->oid);
+            return -1;
+        }
+        while (registered && (**registered)->oid < (**it)->oid) {
+            registered = AVS_LIST_NEXT(registered);
+        }
+        if (registered && (**registered)->oid == (**it)->oid) {
+            anjay_log(ERROR, "data model object /%u already registered",
+                      (**it)->oid);
+            return -1;
         }
     }
+    return 0;
+}
 
-    if (*obj_iter && (***obj_iter)->oid == (*def_ptr)->oid) {
-        anjay_log(ERROR, "data model object /%u already registered",
-                  (*def_ptr)->oid);
-        return -1;
-    }
+int anjay_register_objects(anjay_t *anjay,
+                           const anjay_dm_object_def_t *const *const *def_ptrs,
+                           size_t count) {
+    assert(!anjay->transaction_state.depth);
+    assert(!anjay->transaction_state.objs_in_transaction);
 
-    if (validate_supported_rids(*def_ptr)) {
+    if (!def_ptrs && count) {
+        anjay_log(ERROR, "invalid object pointer array");
         return -1;
     }
 
-    AVS_LIST(const anjay_dm_object_def_t *const *) new_elem =
-            AVS_LIST_NEW_ELEMENT(const anjay_dm_object_def_t *const *);
-    if (!new_elem) {
-        anjay_log(ERROR, "out of memory");
+    AVS_LIST(const anjay_dm_object_def_t *const *) new_objs = NULL;
+    if (make_sorted_objects_list(&new_objs, def_ptrs, count)
+            || check_no_duplicates(anjay->dm.objects, new_objs)) {
+        AVS_LIST_CLEAR(&new_objs);
         return -1;
     }
+    if (!new_objs) {
+        return 0;
+    }
 
-    *new_elem = def_ptr;
-    AVS_LIST_INSERT(obj_iter, new_elem);
-
-    anjay_log(INFO, "successfully registered object /%u", (**new_elem)->oid);
-    if (anjay_notify_instances_changed(anjay, (**new_elem)->oid)) {
-        anjay_log(WARNING, "anjay_notify_instances_changed() failed on /%u",
-                  (**new_elem)->oid);
+    AVS_LIST(const anjay_dm_object_def_t *const *) *obj_iter =
+            &anjay->dm.objects;
+    while (new_objs) {
+        while (*obj_iter && (***obj_iter)->oid < (**new_objs)->oid) {
+            obj_iter = AVS_LIST_NEXT_PTR(obj_iter);
+        }
+        AVS_LIST_INSERT(obj_iter, AVS_LIST_DETACH(&new_objs));
+        anjay_log(INFO, "successfully registered object /%u",
+                  (***obj_iter)->oid);
+        // anjay_notify_instances_changed() only queues the change; all of
+        // them will be handled by a single scheduled job
+        if (anjay_notify_instances_changed(anjay, (***obj_iter)->oid)) {
+            anjay_log(WARNING, "anjay_notify_instances_changed() failed on /%u",
+                      (***obj_iter)->oid);
+        }
+        obj_iter = AVS_LIST_NEXT_PTR(obj_iter);
     }
     if (anjay_schedule_registration_update(anjay, ANJAY_SSID_ANY)) {
         anjay_log(WARNING, "anjay_schedule_registration_update() failed");
@@ -116,6 +171,11 @@ int anjay_register_object(anjay_t *anjay,
     return 0;
 }
 
+int anjay_register_object(anjay_t *anjay,
+                          const anjay_dm_object_def_t *const *def_ptr) {
+    return anjay_register_objects(anjay, &def_ptr, 1);
+}
+
 static void remove_oid_from_notify_queue(anjay_notify_queue_t *out_queue,
                                          anjay_oid_t oid) {
     AVS_LIST(anjay_notify_queue_object_entry_t) *it;
@@ -193,6 +253,7 @@ void _anjay_dm_cleanup(anjay_t *anjay) {
     }
 
     AVS_LIST_CLEAR(&anjay->dm.objects);
+    _anjay_dm_read_cache_clear(anjay);
 }
 
 const anjay_dm_object_def_t *const *
@@ -336,7 +397,7 @@ static int read_resource_internal(anjay_t *anjay,
                                   anjay_output_ctx_t *out_ctx) {
     int result = _anjay_output_set_id(out_ctx, ANJAY_ID_RID, rid);
     if (!result) {
-        result = _anjay_dm_resource_read(anjay, obj, iid, rid, out_ctx, NULL);
+        result = _anjay_dm_read_cache_read(anjay, obj, iid, rid, out_ctx);
     }
     return result;
 }
@@ -650,6 +711,10 @@ request_attrs_empty(const anjay_request_attributes_t *attrs) {
             && !attrs->has_max_period
 #ifdef WITH_CON_ATTR
             && !attrs->custom.has_con
+#endif
+#ifdef WITH_EVAL_PERIOD_ATTRS
+            && !attrs->custom.has_min_eval_period
+            && !attrs->custom.has_max_eval_period
 #endif
             && resource_specific_request_attrs_empty(attrs);
 }
@@ -850,7 +915,8 @@ static int dm_write(anjay_t *anjay,
         }
     }
     if (!retval) {
-        retval = _anjay_notify_perform(anjay, notify_queue);
+        retval = _anjay_notify_queue_merge(&anjay->request_notify_queue,
+                                           &notify_queue);
     }
     _anjay_notify_clear_queue(&notify_queue);
     return retval;
@@ -882,9 +948,39 @@ static void update_attrs(anjay_dm_internal_res_attrs_t *attrs_ptr,
         attrs_ptr->custom.data.con = request_attrs->values.custom.data.con;
     }
 #endif
+#ifdef WITH_EVAL_PERIOD_ATTRS
+    if (request_attrs->custom.has_min_eval_period) {
+        attrs_ptr->custom.data.min_eval_period =
+                request_attrs->values.custom.data.min_eval_period;
+    }
+    if (request_attrs->custom.has_max_eval_period) {
+        attrs_ptr->custom.data.max_eval_period =
+                request_attrs->values.custom.data.max_eval_period;
+    }
+#endif
+}
+
+static bool attrs_valid(const anjay_dm_internal_attrs_t *attrs) {
+#ifdef WITH_EVAL_PERIOD_ATTRS
+    if (attrs->custom.data.max_eval_period == 0
+            || (attrs->custom.data.max_eval_period >= 0
+                    && attrs->custom.data.max_eval_period
+                            <= attrs->custom.data.min_eval_period)) {
+        anjay_log(DEBUG, "Attempted to set attributes that fail the "
+                         "'0 <= epmin < epmax' precondition");
+        return false;
+    }
+#else // WITH_EVAL_PERIOD_ATTRS
+    (void) attrs;
+#endif // WITH_EVAL_PERIOD_ATTRS
+    return true;
 }
 
 static bool resource_attrs_valid(const anjay_dm_internal_res_attrs_t *attrs) {
+    if (!attrs_valid(_anjay_dm_get_internal_attrs_const(
+                &attrs->standard.common))) {
+        return false;
+    }
     double step = 0.0;
     if (!isnan(attrs->standard.step)) {
         if (attrs->standard.step < 0.0) {
@@ -940,9 +1036,14 @@ static int dm_write_instance_attrs(anjay_t *anjay,
             _anjay_dm_get_internal_attrs(&attrs.standard.common));
     if (!result) {
         update_attrs(&attrs, attributes);
-        result = _anjay_dm_instance_write_default_attrs(
-                anjay, obj, iid, _anjay_dm_current_ssid(anjay),
-                _anjay_dm_get_internal_attrs(&attrs.standard.common), NULL);
+        if (!attrs_valid(_anjay_dm_get_internal_attrs_const(
+                    &attrs.standard.common))) {
+            result = ANJAY_ERR_BAD_REQUEST;
+        } else {
+            result = _anjay_dm_instance_write_default_attrs(
+                    anjay, obj, iid, _anjay_dm_current_ssid(anjay),
+                    _anjay_dm_get_internal_attrs(&attrs.standard.common), NULL);
+        }
     }
     return result;
 }
@@ -956,9 +1057,14 @@ static int dm_write_object_attrs(anjay_t *anjay,
             _anjay_dm_get_internal_attrs(&attrs.standard.common));
     if (!result) {
         update_attrs(&attrs, attributes);
-        result = _anjay_dm_object_write_default_attrs(
-                anjay, obj, _anjay_dm_current_ssid(anjay),
-                _anjay_dm_get_internal_attrs(&attrs.standard.common), NULL);
+        if (!attrs_valid(_anjay_dm_get_internal_attrs_const(
+                    &attrs.standard.common))) {
+            result = ANJAY_ERR_BAD_REQUEST;
+        } else {
+            result = _anjay_dm_object_write_default_attrs(
+                    anjay, obj, _anjay_dm_current_ssid(anjay),
+                    _anjay_dm_get_internal_attrs(&attrs.standard.common), NULL);
+        }
     }
     return result;
 }
@@ -1180,11 +1286,8 @@ static int dm_create(anjay_t *anjay,
         }
     }
     if (!result) {
-        anjay_notify_queue_t notify_queue = NULL;
-        (void) ((result = _anjay_notify_queue_instance_created(&notify_queue,
-                                                               request->uri.oid,
-                                                               new_iid))
-                || (result = _anjay_notify_flush(anjay, &notify_queue)));
+        result = _anjay_notify_queue_instance_created(
+                &anjay->request_notify_queue, request->uri.oid, new_iid);
     }
     return result;
 }
@@ -1206,10 +1309,9 @@ static int dm_delete(anjay_t *anjay,
         retval = _anjay_dm_instance_remove(anjay, obj, request->uri.iid, NULL);
     }
     if (!retval) {
-        anjay_notify_queue_t notify_queue = NULL;
-        (void) ((retval = _anjay_notify_queue_instance_removed(
-                        &notify_queue, request->uri.oid, request->uri.iid))
-                || (retval = _anjay_notify_flush(anjay, &notify_queue)));
+        retval = _anjay_notify_queue_instance_removed(
+                &anjay->request_notify_queue,
+                request->uri.oid, request->uri.iid);
     }
     return retval;
 }
@@ -1262,7 +1364,12 @@ static int invoke_transactional_action(anjay_t *anjay,
         retval = ANJAY_ERR_METHOD_NOT_ALLOWED;
     }
 
-    return _anjay_dm_transaction_finish(anjay, retval);
+    retval = _anjay_dm_transaction_finish(anjay, retval);
+    if (retval) {
+        // changes that have been rolled back must not trigger notifications
+        _anjay_notify_clear_queue(&anjay->request_notify_queue);
+    }
+    return retval;
 }
 
 static int invoke_action(anjay_t *anjay,
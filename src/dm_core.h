@@ -28,6 +28,7 @@
 #include "coap/coap_stream.h"
 #include "observe_core.h"
 #include "dm/dm_attributes.h"
+#include "dm/read_cache.h"
 
 VISIBILITY_PRIVATE_HEADER_BEGIN
 
@@ -39,6 +40,7 @@ typedef struct {
 struct anjay_dm {
     AVS_LIST(const anjay_dm_object_def_t *const *) objects;
     AVS_LIST(anjay_dm_installed_module_t) modules;
+    AVS_LIST(anjay_dm_read_cache_entry_t) read_cache;
 };
 
 void _anjay_dm_cleanup(anjay_t *anjay);
@@ -97,6 +99,18 @@ _anjay_request_attributes_equal(const anjay_request_attributes_t *left,
                                     == right->values.custom.data.con)
                     : !right->custom.has_con)
 #endif // WITH_CON_ATTR
+#ifdef WITH_EVAL_PERIOD_ATTRS
+            && (left->custom.has_min_eval_period
+                    ? (right->custom.has_min_eval_period
+                            && (left->values.custom.data.min_eval_period
+                                == right->values.custom.data.min_eval_period))
+                    : !right->custom.has_min_eval_period)
+            && (left->custom.has_max_eval_period
+                    ? (right->custom.has_max_eval_period
+                            && (left->values.custom.data.max_eval_period
+                                == right->values.custom.data.max_eval_period))
+                    : !right->custom.has_max_eval_period)
+#endif // WITH_EVAL_PERIOD_ATTRS
             ;
 }
 
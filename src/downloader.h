@@ -29,12 +29,21 @@ VISIBILITY_PRIVATE_HEADER_BEGIN
 
 typedef struct anjay_download_ctx anjay_download_ctx_t;
 
+#ifdef WITH_HTTP_DOWNLOAD
+typedef struct anjay_http_idle_connection anjay_http_idle_connection_t;
+#endif // WITH_HTTP_DOWNLOAD
+
 typedef struct {
     coap_id_source_t *id_source;
     anjay_rand_seed_t rand_seed;
 
     uintptr_t next_id;
     AVS_LIST(anjay_download_ctx_t) downloads;
+
+#ifdef WITH_HTTP_DOWNLOAD
+    // HTTP connections kept open after finished downloads; see http.c
+    AVS_LIST(anjay_http_idle_connection_t) http_idle_connections;
+#endif // WITH_HTTP_DOWNLOAD
 } anjay_downloader_t;
 
 /**
@@ -62,7 +71,8 @@ int _anjay_downloader_init(anjay_downloader_t *dl,
 /**
  * Frees any resources associated with the downloader object. Aborts all
  * unfinished downloads, calling their @ref anjay_download_finished_handler_t
- * handlers beforehand. All scheduled retransmission jobs are canceled.
+ * handlers beforehand. All scheduled retransmission jobs are canceled, and
+ * idle HTTP connections are closed.
  *
  * @param dl    Pointer to the downloader object to cleanup.
  */
@@ -92,6 +102,10 @@ int _anjay_downloader_handle_packet(anjay_downloader_t *dl,
 void _anjay_downloader_abort(anjay_downloader_t *dl,
                              anjay_download_handle_t handle);
 
+int _anjay_downloader_get_stats(anjay_downloader_t *dl,
+                                anjay_download_handle_t handle,
+                                anjay_traffic_stats_t *out_stats);
+
 VISIBILITY_PRIVATE_HEADER_END
 
 #endif /* ANJAY_DOWNLOADER_H */
@@ -39,6 +39,10 @@ typedef struct {
     avs_net_abstract_socket_t *socket;
     avs_coap_msg_identity_t last_req_id;
 
+    // used for RTT sampling; reset whenever last_req_id changes
+    unsigned last_req_num_transmissions;
+    avs_time_monotonic_t last_req_first_sent;
+
     /*
      * After calling @ref _anjay_downloader_download:
      *     handle to a job that sends the initial request.
@@ -168,10 +172,15 @@ static int request_coap_block(anjay_downloader_t *dl,
 
     const avs_coap_msg_t *msg = avs_coap_msg_builder_get_msg(&builder);
 
+    anjay_traffic_stats_t snapshot;
+    _anjay_traffic_stats_snapshot(anjay, &snapshot);
     result = avs_coap_ctx_send(anjay->coap_ctx, ctx->socket, msg);
+    _anjay_traffic_stats_add_since(anjay, &ctx->common.stats, &snapshot);
 
     if (result) {
         dl_log(ERROR, "could not send request: %d", result);
+    } else if (ctx->last_req_num_transmissions++ == 0) {
+        ctx->last_req_first_sent = avs_time_monotonic_now();
     }
 
 finish:
@@ -183,6 +192,7 @@ static int request_next_coap_block(anjay_downloader_t *dl,
                                    AVS_LIST(anjay_download_ctx_t) *ctx_ptr) {
     anjay_coap_download_ctx_t *ctx = (anjay_coap_download_ctx_t *) *ctx_ptr;
     ctx->last_req_id = _anjay_coap_id_source_get(dl->id_source);
+    ctx->last_req_num_transmissions = 0;
 
     if (request_coap_block(dl, ctx)
             || schedule_coap_retransmission(dl, ctx)) {
@@ -399,8 +409,11 @@ static void handle_coap_message(anjay_downloader_t *dl,
 
     anjay_coap_download_ctx_t *ctx = (anjay_coap_download_ctx_t *) *ctx_ptr;
     avs_coap_ctx_set_tx_params(anjay->coap_ctx, &anjay->udp_tx_params);
+    anjay_traffic_stats_t snapshot;
+    _anjay_traffic_stats_snapshot(anjay, &snapshot);
     int result = avs_coap_ctx_recv(anjay->coap_ctx, ctx->socket, msg,
                                    anjay->in_buffer_size);
+    _anjay_traffic_stats_add_since(anjay, &ctx->common.stats, &snapshot);
 
     if (result) {
         dl_log(DEBUG, "recv result: %d", result);
@@ -431,7 +444,19 @@ static void handle_coap_message(anjay_downloader_t *dl,
             dl_log(DEBUG, "msg id mismatch (got %u, expected %u), ignoring",
                    avs_coap_msg_get_id(msg), ctx->last_req_id.msg_id);
             return;
-        } else if (type == AVS_COAP_MSG_RESET) {
+        }
+        // Karn's algorithm: the RTT is ambiguous if the request was
+        // retransmitted
+        if (ctx->last_req_num_transmissions == 1) {
+            _anjay_traffic_stats_add_rtt_sample(
+                    &ctx->common.stats,
+                    avs_time_monotonic_diff(avs_time_monotonic_now(),
+                                            ctx->last_req_first_sent));
+            // take at most one sample per request, even if the ACK is
+            // duplicated
+            ctx->last_req_num_transmissions = 0;
+        }
+        if (type == AVS_COAP_MSG_RESET) {
             dl_log(DEBUG, "Reset response, aborting transfer");
             _anjay_downloader_abort_transfer(dl, ctx_ptr,
                                              ANJAY_DOWNLOAD_ERR_FAILED);
@@ -451,9 +476,11 @@ static void handle_coap_message(anjay_downloader_t *dl,
         }
     } else {
         dl_log(TRACE, "Separate Response received");
+        _anjay_traffic_stats_snapshot(anjay, &snapshot);
         avs_coap_ctx_send_empty(anjay->coap_ctx, ctx->socket,
                                 AVS_COAP_MSG_ACKNOWLEDGEMENT,
                                 avs_coap_msg_get_id(msg));
+        _anjay_traffic_stats_add_since(anjay, &ctx->common.stats, &snapshot);
     }
 
     handle_coap_response(msg, dl, ctx_ptr);
@@ -89,6 +89,9 @@ void _anjay_downloader_cleanup(anjay_downloader_t *dl) {
         _anjay_downloader_abort_transfer(dl, &dl->downloads,
                                          ANJAY_DOWNLOAD_ERR_ABORTED);
     }
+#ifdef WITH_HTTP_DOWNLOAD
+    _anjay_downloader_http_close_idle_connections(dl);
+#endif // WITH_HTTP_DOWNLOAD
 
     _anjay_coap_id_source_release(&dl->id_source);
 }
@@ -229,3 +232,18 @@ void _anjay_downloader_abort(anjay_downloader_t *dl,
         _anjay_downloader_abort_transfer(dl, ctx, ANJAY_DOWNLOAD_ERR_ABORTED);
     }
 }
+
+int _anjay_downloader_get_stats(anjay_downloader_t *dl,
+                                anjay_download_handle_t handle,
+                                anjay_traffic_stats_t *out_stats) {
+    uintptr_t id = (uintptr_t)handle;
+
+    AVS_LIST(anjay_download_ctx_t) *ctx =
+            _anjay_downloader_find_ctx_ptr_by_id(dl, id);
+    if (!ctx) {
+        dl_log(DEBUG, "download id = %" PRIuPTR " not found (expired?)", id);
+        return -1;
+    }
+    *out_stats = (*ctx)->common.stats;
+    return 0;
+}
@@ -18,9 +18,12 @@
 
 #include <errno.h>
 #include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include <avsystem/commons/http.h>
 #include <avsystem/commons/stream/stream_net.h>
+#include <avsystem/commons/utils.h>
 
 #define ANJAY_DOWNLOADER_INTERNALS
 
@@ -28,44 +31,255 @@
 
 VISIBILITY_SOURCE_BEGIN
 
+/** Time after which a connection left open by a finished download is closed
+ * if no other download to the same URL reuses it. Kept below the keep-alive
+ * timeouts commonly used by servers (e.g. 5 seconds in Apache httpd), so that
+ * a pooled connection is rarely already closed by the other side. */
+#define HTTP_IDLE_CONNECTION_TIMEOUT_S 4
+
+/** Maximum number of idle connections; the oldest one is closed first. */
+#define HTTP_MAX_IDLE_CONNECTIONS 2
+
 typedef struct {
     anjay_download_ctx_common_t common;
     avs_net_ssl_configuration_t ssl_configuration;
     avs_http_t *client;
+    char *url;
     avs_url_t *parsed_url;
     avs_stream_abstract_t *stream;
+    // set if the stream has been taken over from an idle connection, and no
+    // response data has been received through it yet
+    bool stream_reused;
     anjay_sched_handle_t send_request_job;
 } anjay_http_download_ctx_t;
 
-static int send_request(anjay_t *anjay, void *id_) {
-    uintptr_t id = (uintptr_t) id_;
-    AVS_LIST(anjay_download_ctx_t) *ctx_ptr =
-            _anjay_downloader_find_ctx_ptr_by_id(&anjay->downloader, id);
-    if (!ctx_ptr) {
-        dl_log(DEBUG, "download id = %" PRIuPTR "expired", id);
-        return 0;
+/**
+ * HTTP stream whose response has been read completely, and which may be used
+ * to send another request over the same (possibly TLS) connection.
+ *
+ * An avs_http stream always requests the URL it has been opened with, so the
+ * full URL, not only the scheme, host and port, is a part of the key. For
+ * HTTPS, so is the security information, compared by content; the PSK and
+ * identity are copied into psk_buffer, as the ones passed in the download
+ * configuration are not guaranteed to outlive the download.
+ */
+struct anjay_http_idle_connection {
+    avs_net_ssl_configuration_t ssl_configuration;
+    char *psk_buffer;
+    avs_http_t *client;
+    char *url;
+    avs_stream_abstract_t *stream;
+    anjay_sched_handle_t expire_job;
+};
+
+static void close_idle_connection(
+        anjay_downloader_t *dl,
+        AVS_LIST(anjay_http_idle_connection_t) *conn_ptr) {
+    _anjay_sched_del(_anjay_downloader_get_anjay(dl)->sched,
+                     &(*conn_ptr)->expire_job);
+    avs_stream_cleanup(&(*conn_ptr)->stream);
+    avs_http_free((*conn_ptr)->client);
+    free((*conn_ptr)->url);
+    free((*conn_ptr)->psk_buffer);
+    AVS_LIST_DELETE(conn_ptr);
+}
+
+static bool is_plain_http(const char *url) {
+    return avs_strncasecmp(url, "http://", sizeof("http://") - 1) == 0;
+}
+
+/**
+ * Certificate-based configurations may refer to files, directories or
+ * buffers, so only PSK ones are compared; connections that use certificates
+ * are never pooled.
+ */
+static bool is_security_info_comparable(const avs_net_security_info_t *info) {
+    return info->mode == AVS_NET_SECURITY_PSK;
+}
+
+static bool same_bytes(const void *a, size_t a_size,
+                       const void *b, size_t b_size) {
+    return a_size == b_size && (!a_size || memcmp(a, b, a_size) == 0);
+}
+
+static bool same_security_info(const avs_net_security_info_t *a,
+                               const avs_net_security_info_t *b) {
+    return is_security_info_comparable(a)
+            && is_security_info_comparable(b)
+            && same_bytes(a->data.psk.psk, a->data.psk.psk_size,
+                          b->data.psk.psk, b->data.psk.psk_size)
+            && same_bytes(a->data.psk.identity, a->data.psk.identity_size,
+                          b->data.psk.identity, b->data.psk.identity_size);
+}
+
+static int copy_psk(anjay_http_idle_connection_t *conn) {
+    avs_net_psk_t *psk = &conn->ssl_configuration.security.data.psk;
+    // one extra byte, so that malloc() is never called with zero size
+    if (!(conn->psk_buffer = (char *) malloc(psk->psk_size
+                                             + psk->identity_size + 1))) {
+        return -1;
+    }
+    if (psk->psk_size) {
+        memcpy(conn->psk_buffer, psk->psk, psk->psk_size);
+    }
+    if (psk->identity_size) {
+        memcpy(conn->psk_buffer + psk->psk_size, psk->identity,
+               psk->identity_size);
     }
+    psk->psk = conn->psk_buffer;
+    psk->identity = conn->psk_buffer + psk->psk_size;
+    return 0;
+}
 
-    anjay_http_download_ctx_t *ctx = (anjay_http_download_ctx_t *) *ctx_ptr;
+void _anjay_downloader_http_close_idle_connections(anjay_downloader_t *dl) {
+    while (dl->http_idle_connections) {
+        close_idle_connection(dl, &dl->http_idle_connections);
+    }
+}
+
+static int expire_idle_connection(anjay_t *anjay, void *conn) {
+    AVS_LIST(anjay_http_idle_connection_t) *conn_ptr =
+            AVS_LIST_FIND_PTR(&anjay->downloader.http_idle_connections, conn);
+    if (conn_ptr) {
+        dl_log(DEBUG, "closing idle HTTP connection to %s", (*conn_ptr)->url);
+        close_idle_connection(&anjay->downloader, conn_ptr);
+    }
+    return 0;
+}
+
+/**
+ * Moves the connection used by @p ctx, which has just finished, to the list of
+ * idle connections. On failure, the connection is left in @p ctx , so that it
+ * is closed as usual.
+ */
+static void keep_connection_idle(anjay_downloader_t *dl,
+                                 anjay_http_download_ctx_t *ctx) {
+    const bool plain_http = is_plain_http(ctx->url);
+    if (!plain_http
+            && !is_security_info_comparable(&ctx->ssl_configuration.security)) {
+        return;
+    }
+    AVS_LIST(anjay_http_idle_connection_t) conn =
+            AVS_LIST_NEW_ELEMENT(anjay_http_idle_connection_t);
+    if (!conn) {
+        return;
+    }
+    conn->ssl_configuration = ctx->ssl_configuration;
+    if (!plain_http && copy_psk(conn)) {
+        AVS_LIST_DELETE(&conn);
+        return;
+    }
+    if (_anjay_sched(_anjay_downloader_get_anjay(dl)->sched, &conn->expire_job,
+                     avs_time_duration_from_scalar(
+                             HTTP_IDLE_CONNECTION_TIMEOUT_S, AVS_TIME_S),
+                     expire_idle_connection, conn)) {
+        free(conn->psk_buffer);
+        AVS_LIST_DELETE(&conn);
+        return;
+    }
+
+    conn->client = ctx->client;
+    conn->url = ctx->url;
+    conn->stream = ctx->stream;
+    avs_http_ssl_configuration(conn->client, &conn->ssl_configuration);
+    ctx->client = NULL;
+    ctx->url = NULL;
+    ctx->stream = NULL;
+
+    AVS_LIST_APPEND(&dl->http_idle_connections, conn);
+    if (AVS_LIST_SIZE(dl->http_idle_connections) > HTTP_MAX_IDLE_CONNECTIONS) {
+        close_idle_connection(dl, &dl->http_idle_connections);
+    }
+}
+
+/**
+ * Takes over an idle connection matching @p ctx , if there is one.
+ *
+ * @returns true if <c>ctx->stream</c> has been set to a reused stream.
+ */
+static bool take_idle_connection(anjay_downloader_t *dl,
+                                 anjay_http_download_ctx_t *ctx) {
+    AVS_LIST(anjay_http_idle_connection_t) *conn_ptr;
+    AVS_LIST_FOREACH_PTR(conn_ptr, &dl->http_idle_connections) {
+        if (strcmp((*conn_ptr)->url, ctx->url) == 0
+                && (is_plain_http(ctx->url)
+                    || same_security_info(
+                               &(*conn_ptr)->ssl_configuration.security,
+                               &ctx->ssl_configuration.security))) {
+            break;
+        }
+    }
+    if (!conn_ptr || !*conn_ptr) {
+        return false;
+    }
+
+    // the stream refers to the client it has been opened with
+    avs_http_free(ctx->client);
+    ctx->client = (*conn_ptr)->client;
+    ctx->stream = (*conn_ptr)->stream;
+    avs_http_ssl_configuration(ctx->client, &ctx->ssl_configuration);
+    (*conn_ptr)->client = NULL;
+    (*conn_ptr)->stream = NULL;
+    close_idle_connection(dl, conn_ptr);
+    return true;
+}
+
+static int open_stream(anjay_http_download_ctx_t *ctx) {
     int result = avs_http_open_stream(&ctx->stream, ctx->client,
                                       AVS_HTTP_GET, AVS_HTTP_CONTENT_IDENTITY,
                                       ctx->parsed_url, NULL, NULL);
-    avs_url_free(ctx->parsed_url);
-    ctx->parsed_url = NULL;
     if (result || !ctx->stream) {
-        goto error;
+        return -1;
     }
 
     if (avs_stream_finish_message(ctx->stream)) {
         dl_log(ERROR, "Could not send HTTP request, error %d",
                avs_stream_errno(ctx->stream));
-        goto error;
+        return -1;
     }
-
     return 0;
-error:
-    _anjay_downloader_abort_transfer(&anjay->downloader, ctx_ptr,
-                                     ANJAY_DOWNLOAD_ERR_FAILED);
+}
+
+/**
+ * Sends the request again over a new connection. Called when a reused
+ * connection fails before any response data arrives, which most likely means
+ * that the server closed it in the meantime. Never called more than once per
+ * download, as the new stream is not a reused one.
+ */
+static int retry_on_fresh_connection(anjay_http_download_ctx_t *ctx) {
+    dl_log(DEBUG, "could not reuse idle connection to %s, reconnecting",
+           ctx->url);
+    ctx->stream_reused = false;
+    avs_stream_cleanup(&ctx->stream);
+    return open_stream(ctx);
+}
+
+static int send_request(anjay_t *anjay, void *id_) {
+    uintptr_t id = (uintptr_t) id_;
+    AVS_LIST(anjay_download_ctx_t) *ctx_ptr =
+            _anjay_downloader_find_ctx_ptr_by_id(&anjay->downloader, id);
+    if (!ctx_ptr) {
+        dl_log(DEBUG, "download id = %" PRIuPTR "expired", id);
+        return 0;
+    }
+
+    anjay_http_download_ctx_t *ctx = (anjay_http_download_ctx_t *) *ctx_ptr;
+    int result;
+    if (take_idle_connection(&anjay->downloader, ctx)) {
+        ctx->stream_reused = true;
+        if (!(result = avs_stream_finish_message(ctx->stream))) {
+            dl_log(DEBUG, "reusing idle connection to %s", ctx->url);
+        } else {
+            result = retry_on_fresh_connection(ctx);
+        }
+    } else {
+        result = open_stream(ctx);
+    }
+
+    if (result) {
+        _anjay_downloader_abort_transfer(&anjay->downloader, ctx_ptr,
+                                         ANJAY_DOWNLOAD_ERR_FAILED);
+    }
     return 0;
 }
 
@@ -86,10 +300,16 @@ static void handle_http_packet(anjay_downloader_t *dl,
         char message_finished = 0;
         if (avs_stream_read(ctx->stream, &bytes_read, &message_finished,
                             anjay->in_buffer, anjay->in_buffer_size)) {
+            if (ctx->stream_reused && !retry_on_fresh_connection(ctx)) {
+                return;
+            }
             _anjay_downloader_abort_transfer(dl, ctx_ptr,
                                              ANJAY_DOWNLOAD_ERR_FAILED);
             return;
         }
+        if (bytes_read) {
+            ctx->stream_reused = false;
+        }
         if (bytes_read
                 && ctx->common.on_next_block(_anjay_downloader_get_anjay(dl),
                                              anjay->in_buffer, bytes_read, NULL,
@@ -101,6 +321,7 @@ static void handle_http_packet(anjay_downloader_t *dl,
         if (message_finished) {
             dl_log(INFO, "HTTP transfer id = %" PRIuPTR " finished",
                    ctx->common.id);
+            keep_connection_idle(dl, ctx);
             _anjay_downloader_abort_transfer(dl, ctx_ptr, 0);
             return;
         }
@@ -124,6 +345,7 @@ static void cleanup_http_transfer(anjay_downloader_t *dl,
     avs_stream_cleanup(&ctx->stream);
     avs_url_free(ctx->parsed_url);
     avs_http_free(ctx->client);
+    free(ctx->url);
     AVS_LIST_DELETE(ctx_ptr);
 }
 
@@ -173,6 +395,12 @@ _anjay_downloader_http_ctx_new(anjay_downloader_t *dl,
     ctx->ssl_configuration.security = cfg->security_info;
     avs_http_ssl_configuration(ctx->client, &ctx->ssl_configuration);
 
+    if (!(ctx->url = (char *) malloc(strlen(cfg->url) + 1))) {
+        dl_log(ERROR, "out of memory");
+        goto error;
+    }
+    strcpy(ctx->url, cfg->url);
+
     if (!(ctx->parsed_url = avs_url_parse(cfg->url))) {
         goto error;
     }
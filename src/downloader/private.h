@@ -45,6 +45,8 @@ typedef struct {
     anjay_download_next_block_handler_t *on_next_block;
     anjay_download_finished_handler_t *on_download_finished;
     void *user_data;
+
+    anjay_traffic_stats_t stats;
 } anjay_download_ctx_common_t;
 
 static inline anjay_t *_anjay_downloader_get_anjay(anjay_downloader_t *dl) {
@@ -71,6 +73,11 @@ AVS_LIST(anjay_download_ctx_t)
 _anjay_downloader_http_ctx_new(anjay_downloader_t *dl,
                                const anjay_download_config_t *cfg,
                                uintptr_t id);
+
+/**
+ * Closes all HTTP connections kept open for reuse by later downloads.
+ */
+void _anjay_downloader_http_close_idle_connections(anjay_downloader_t *dl);
 #endif // WITH_HTTP_DOWNLOAD
 
 VISIBILITY_PRIVATE_HEADER_END
@@ -143,19 +143,38 @@ static int get_server_lifetime(anjay_t *anjay,
     return 0;
 }
 
+static AVS_LIST(const anjay_string_t)
+get_register_query(anjay_t *anjay,
+                   anjay_register_query_cache_t *cache,
+                   const anjay_update_parameters_t *params) {
+    const anjay_binding_mode_t binding_mode =
+            params->binding_mode == ANJAY_BINDING_U ? ANJAY_BINDING_NONE
+                                                    : params->binding_mode;
+    if (cache->query
+            && cache->lifetime_s == params->lifetime_s
+            && cache->binding_mode == binding_mode) {
+        return cache->query;
+    }
+
+    // endpoint name and MSISDN do not change during the lifetime of Anjay
+    AVS_LIST_CLEAR(&cache->query);
+    cache->query = _anjay_make_query_string_list(
+            ANJAY_SUPPORTED_ENABLER_VERSION, anjay->endpoint_name,
+            &params->lifetime_s, binding_mode, _anjay_local_msisdn(anjay));
+    cache->lifetime_s = params->lifetime_s;
+    cache->binding_mode = binding_mode;
+    return cache->query;
+}
+
 static int send_register(anjay_t *anjay,
+                         anjay_register_query_cache_t *query_cache,
                          const anjay_update_parameters_t *params) {
     anjay_msg_details_t details = {
         .msg_type = AVS_COAP_MSG_CONFIRMABLE,
         .msg_code = AVS_COAP_CODE_POST,
         .format = ANJAY_COAP_FORMAT_APPLICATION_LINK,
         .uri_path = _anjay_make_string_list("rd", NULL),
-        .uri_query = _anjay_make_query_string_list(
-                ANJAY_SUPPORTED_ENABLER_VERSION, anjay->endpoint_name,
-                &params->lifetime_s,
-                params->binding_mode == ANJAY_BINDING_U ? ANJAY_BINDING_NONE
-                                                        : params->binding_mode,
-                _anjay_local_msisdn(anjay))
+        .uri_query = get_register_query(anjay, query_cache, params)
     };
 
     int result = -1;
@@ -175,7 +194,7 @@ static int send_register(anjay_t *anjay,
 
 cleanup:
     AVS_LIST_CLEAR(&details.uri_path);
-    AVS_LIST_CLEAR(&details.uri_query);
+    // uri_query is owned by query_cache
     return result;
 }
 
@@ -353,6 +372,7 @@ registration_info_init(anjay_registration_info_t *info,
                        anjay_update_parameters_t *move_params) {
     update_registration_info(info, move_params);
 
+    AVS_LIST_CLEAR(&info->endpoint_path);
     info->endpoint_path = *move_endpoint_path;
     *move_endpoint_path = NULL;
 }
@@ -360,6 +380,7 @@ registration_info_init(anjay_registration_info_t *info,
 void _anjay_registration_info_cleanup(anjay_registration_info_t *info) {
     AVS_LIST_CLEAR(&info->endpoint_path);
     cleanup_update_parameters(&info->last_update_params);
+    AVS_LIST_CLEAR(&info->register_query.query);
 }
 
 int _anjay_register(anjay_t *anjay) {
@@ -371,18 +392,16 @@ int _anjay_register(anjay_t *anjay) {
     AVS_LIST(const anjay_string_t) endpoint_path = NULL;
     int result = -1;
 
-    if (send_register(anjay, &new_params)
+    anjay_registration_info_t *info =
+            &anjay->current_connection.server->registration_info;
+    if (send_register(anjay, &info->register_query, &new_params)
             || check_register_response(anjay->comm_stream, &endpoint_path)) {
         anjay_log(ERROR, "could not register to server %u",
                   _anjay_dm_current_ssid(anjay));
         goto fail;
     }
 
-    _anjay_registration_info_cleanup(
-            &anjay->current_connection.server->registration_info);
-    registration_info_init(
-            &anjay->current_connection.server->registration_info,
-            &endpoint_path, &new_params);
+    registration_info_init(info, &endpoint_path, &new_params);
     result = 0;
 
 fail:
@@ -423,3 +423,31 @@ AVS_UNIT_TEST(tlv_in_types, invalid_read) {
 
     TEST_TEARDOWN;
 }
+
+AVS_UNIT_TEST(tlv_in_bytes, remaining_length) {
+    TEST_ENV(64);
+    AVS_UNIT_ASSERT_SUCCESS(avs_stream_write_f(stream, "%s",
+                                               "\xC7\x2A" "0123456"));
+    AVS_UNIT_ASSERT_SUCCESS(avs_stream_write_f(stream, "%s",
+                                               "\xC3\x45" "abc"));
+
+    size_t length;
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_remaining_length(in, &length));
+    AVS_UNIT_ASSERT_EQUAL(length, 7);
+
+    char buf[4];
+    size_t bytes_read;
+    bool message_finished;
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_bytes(in, &bytes_read, &message_finished,
+                                            buf, sizeof(buf)));
+    AVS_UNIT_ASSERT_EQUAL(bytes_read, 4);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_remaining_length(in, &length));
+    AVS_UNIT_ASSERT_EQUAL(length, 3);
+
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_next_entry(in));
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_input_remaining_length(in, &length));
+    AVS_UNIT_ASSERT_EQUAL(length, 3);
+    TLV_BYTES_TEST_ID(ANJAY_ID_RID, 0x45);
+
+    TEST_TEARDOWN;
+}
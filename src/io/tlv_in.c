@@ -42,25 +42,30 @@ typedef struct {
     size_t bytes_read;
 } tlv_in_t;
 
+static int tlv_ensure_id_read(tlv_in_t *ctx) {
+    if (ctx->id < 0) {
+        anjay_id_type_t placeholder_type;
+        uint16_t placeholder_id;
+        return _anjay_input_get_id((anjay_input_ctx_t *) ctx,
+                                   &placeholder_type, &placeholder_id);
+    }
+    return 0;
+}
+
 static int tlv_get_some_bytes(anjay_input_ctx_t *ctx_,
                               size_t *out_bytes_read,
                               bool *out_message_finished,
                               void *out_buf,
                               size_t buf_size) {
     tlv_in_t *ctx = (tlv_in_t *) ctx_;
-    if (ctx->id < 0) {
-        anjay_id_type_t placeholder_type;
-        uint16_t placeholder_id;
-        int retval =
-                _anjay_input_get_id(ctx_, &placeholder_type, &placeholder_id);
-        if (retval) {
-            return retval;
-        }
+    int retval = tlv_ensure_id_read(ctx);
+    if (retval) {
+        return retval;
     }
     char stream_finished;
     *out_bytes_read = 0;
     buf_size = AVS_MIN(buf_size, ctx->length - ctx->bytes_read);
-    int retval = avs_stream_read((avs_stream_abstract_t *) &ctx->stream,
+    retval = avs_stream_read((avs_stream_abstract_t *) &ctx->stream,
                                  out_bytes_read, &stream_finished,
                                  out_buf, buf_size);
     ctx->bytes_read += *out_bytes_read;
@@ -312,6 +317,15 @@ static int tlv_in_close(anjay_input_ctx_t *ctx_) {
     return 0;
 }
 
+static int tlv_remaining_length(anjay_input_ctx_t *ctx_, size_t *out_length) {
+    tlv_in_t *ctx = (tlv_in_t *) ctx_;
+    int retval = tlv_ensure_id_read(ctx);
+    if (!retval) {
+        *out_length = ctx->length - ctx->bytes_read;
+    }
+    return retval;
+}
+
 static const anjay_input_ctx_vtable_t TLV_IN_VTABLE = {
     tlv_get_some_bytes,
     tlv_get_string,
@@ -324,7 +338,8 @@ static const anjay_input_ctx_vtable_t TLV_IN_VTABLE = {
     tlv_in_attach_child,
     tlv_get_id,
     tlv_next_entry,
-    tlv_in_close
+    tlv_in_close,
+    tlv_remaining_length
 };
 
 static int tlv_safe_read(avs_stream_abstract_t *stream_,
@@ -17,6 +17,7 @@
 #include <config.h>
 
 #include <inttypes.h>
+#include <stdio.h>
 #include <stdlib.h>
 
 #include <avsystem/commons/stream_v_table.h>
@@ -70,6 +71,22 @@ double _anjay_ntohd(uint64_t v) {
     return conv.d;
 }
 
+int _anjay_stream_at_end(avs_stream_abstract_t *in) {
+    if (avs_stream_peek(in, 0) != EOF) {
+        return 0; // data ahead
+    }
+
+    size_t bytes_read;
+    char message_finished;
+    char value;
+    int result = avs_stream_read(in, &bytes_read, &message_finished,
+                                 &value, sizeof(value));
+    if (!result && !bytes_read && message_finished) {
+        return 1;
+    }
+    return result < 0 ? result : -1;
+}
+
 struct anjay_output_ctx_struct {
     const anjay_output_ctx_vtable_t *vtable;
 };
@@ -455,6 +472,14 @@ int _anjay_input_get_id(anjay_input_ctx_t *ctx,
     return ctx->vtable->get_id(ctx, out_type, out_id);
 }
 
+int _anjay_input_remaining_length(anjay_input_ctx_t *ctx,
+                                  size_t *out_length) {
+    if (!ctx->vtable->remaining_length) {
+        return -1;
+    }
+    return ctx->vtable->remaining_length(ctx, out_length);
+}
+
 int _anjay_input_next_entry(anjay_input_ctx_t *ctx) {
     if (!ctx->vtable->next_entry) {
         return -1;
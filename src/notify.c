@@ -27,6 +27,78 @@
 VISIBILITY_SOURCE_BEGIN
 
 #ifdef WITH_OBSERVE
+/**
+ * Stores IIDs that are present in exactly one of the sorted lists @p left and
+ * @p right in @p *out , in ascending order.
+ */
+static int symmetric_difference(AVS_LIST(const anjay_iid_t) left,
+                                AVS_LIST(const anjay_iid_t) right,
+                                AVS_LIST(anjay_iid_t) *out) {
+    AVS_LIST(anjay_iid_t) *append_ptr = out;
+    while (left || right) {
+        anjay_iid_t iid;
+        if (!right || (left && *left < *right)) {
+            iid = *left;
+            left = AVS_LIST_NEXT(left);
+        } else if (!left || *right < *left) {
+            iid = *right;
+            right = AVS_LIST_NEXT(right);
+        } else {
+            left = AVS_LIST_NEXT(left);
+            right = AVS_LIST_NEXT(right);
+            continue;
+        }
+        if (!AVS_LIST_INSERT_NEW(anjay_iid_t, append_ptr)) {
+            anjay_log(ERROR, "Out of memory");
+            AVS_LIST_CLEAR(out);
+            return -1;
+        }
+        **append_ptr = iid;
+        append_ptr = AVS_LIST_NEXT_PTR(append_ptr);
+    }
+    return 0;
+}
+
+/**
+ * Notifies observations affected by a change to the Instance set of an Object.
+ *
+ * If the change has been reported with exhaustive known_added/known_removed
+ * lists (Create, Delete, Bootstrap), only Object-level observations and
+ * observations of the Instances on those lists are notified. Otherwise, e.g.
+ * after an explicit anjay_notify_instances_changed() call, the change may
+ * affect anything in the Object (including attributes stored outside of the
+ * Object itself), so all observations related to the Object are notified.
+ */
+static int observe_notify_instance_set_change(
+        anjay_t *anjay,
+        anjay_observe_key_t *observe_key,
+        const anjay_notify_queue_object_entry_t *entry,
+        bool *out_whole_object_notified) {
+    const anjay_notify_queue_instance_entry_t *changes =
+            &entry->instance_set_changes;
+    AVS_LIST(anjay_iid_t) affected = NULL;
+    observe_key->rid = ANJAY_RID_EMPTY;
+    // added and removed IIDs are disjoint, so this is just their union
+    if (changes->unknown_change
+            || symmetric_difference(changes->known_added_iids,
+                                    changes->known_removed_iids, &affected)) {
+        *out_whole_object_notified = true;
+        observe_key->iid = ANJAY_IID_INVALID;
+        return _anjay_observe_notify(anjay, observe_key, true);
+    }
+    // notifying a specific Instance also notifies Object-level observations
+    int ret = 0;
+    AVS_LIST(anjay_iid_t) it;
+    AVS_LIST_FOREACH(it, affected) {
+        observe_key->iid = *it;
+        _anjay_update_ret(&ret,
+                          _anjay_observe_notify(anjay, observe_key, true));
+    }
+    AVS_LIST_CLEAR(&affected);
+    *out_whole_object_notified = false;
+    return ret;
+}
+
 static int observe_notify(anjay_t *anjay,
                           anjay_notify_queue_t queue) {
     anjay_observe_key_t observe_key = {
@@ -41,20 +113,22 @@ static int observe_notify(anjay_t *anjay,
     AVS_LIST_FOREACH(it, queue) {
         observe_key.oid = it->oid;
         if (it->instance_set_changes.instance_set_changed) {
-            observe_key.iid = ANJAY_IID_INVALID;
-            observe_key.rid = ANJAY_RID_EMPTY;
+            bool whole_object_notified;
             _anjay_update_ret(&ret,
-                              _anjay_observe_notify(anjay, &observe_key, true));
-        } else {
-            AVS_LIST(anjay_notify_queue_resource_entry_t) it2;
-            AVS_LIST_FOREACH(it2, it->resources_changed) {
-                observe_key.iid = it2->iid;
-                observe_key.rid = it2->rid;
-                _anjay_update_ret(&ret,
-                                  _anjay_observe_notify(anjay, &observe_key,
-                                                        true));
+                              observe_notify_instance_set_change(
+                                      anjay, &observe_key, it,
+                                      &whole_object_notified));
+            if (whole_object_notified) {
+                continue;
             }
         }
+        AVS_LIST(anjay_notify_queue_resource_entry_t) it2;
+        AVS_LIST_FOREACH(it2, it->resources_changed) {
+            observe_key.iid = it2->iid;
+            observe_key.rid = it2->rid;
+            _anjay_update_ret(&ret,
+                              _anjay_observe_notify(anjay, &observe_key, true));
+        }
     }
     return ret;
 }
@@ -109,11 +183,103 @@ static int server_modified_notify(anjay_t *anjay,
     return ret;
 }
 
+static bool
+interested_in_entry(const anjay_notify_interest_t *interest,
+                    const anjay_notify_queue_object_entry_t *entry) {
+    if (interest->instance_set_changes_only
+            && !entry->instance_set_changes.instance_set_changed) {
+        return false;
+    }
+    if (!interest->oids) {
+        return true;
+    }
+    for (size_t i = 0; i < interest->num_oids; ++i) {
+        if (interest->oids[i] >= entry->oid) {
+            return interest->oids[i] == entry->oid;
+        }
+    }
+    return false;
+}
+
+/**
+ * Builds a list of shallow copies of the entries of @p queue that match
+ * @p interest . The copies share the inner lists with the original entries, so
+ * the result shall be freed with AVS_LIST_CLEAR() only.
+ *
+ * @returns 0 if there are no matching entries, 1 if the matching entries have
+ *          been stored in @p *out_filtered , 2 if all entries are matching (in
+ *          which case @p *out_filtered is left unchanged) or a negative value
+ *          in case of error.
+ */
+static int filter_queue(anjay_notify_queue_t queue,
+                        const anjay_notify_interest_t *interest,
+                        anjay_notify_queue_t *out_filtered) {
+    size_t matching = 0;
+    AVS_LIST(anjay_notify_queue_object_entry_t) it;
+    AVS_LIST_FOREACH(it, queue) {
+        if (interested_in_entry(interest, it)) {
+            ++matching;
+        }
+    }
+    if (!matching) {
+        return 0;
+    } else if (matching == AVS_LIST_SIZE(queue)) {
+        return 2;
+    }
+
+    AVS_LIST(anjay_notify_queue_object_entry_t) *append_ptr = out_filtered;
+    AVS_LIST_FOREACH(it, queue) {
+        if (!interested_in_entry(interest, it)) {
+            continue;
+        }
+        if (!AVS_LIST_INSERT_NEW(anjay_notify_queue_object_entry_t,
+                                 append_ptr)) {
+            anjay_log(ERROR, "Out of memory");
+            AVS_LIST_CLEAR(out_filtered);
+            return -1;
+        }
+        **append_ptr = *it;
+        append_ptr = AVS_LIST_NEXT_PTR(append_ptr);
+    }
+    return 1;
+}
+
+static void invalidate_read_cache(anjay_t *anjay,
+                                  anjay_notify_queue_t queue) {
+    AVS_LIST(anjay_notify_queue_object_entry_t) it;
+    AVS_LIST_FOREACH(it, queue) {
+        if (it->instance_set_changes.instance_set_changed) {
+            _anjay_dm_read_cache_invalidate_object(anjay, it->oid);
+            continue;
+        }
+        AVS_LIST(anjay_notify_queue_resource_entry_t) res;
+        AVS_LIST_FOREACH(res, it->resources_changed) {
+            _anjay_dm_read_cache_invalidate(anjay, it->oid, res->iid, res->rid);
+        }
+    }
+}
+
+static int module_notify(anjay_t *anjay,
+                         const anjay_dm_installed_module_t *module,
+                         anjay_notify_queue_t queue) {
+    anjay_notify_queue_t filtered = NULL;
+    int result = filter_queue(queue, &module->def->notify_interest, &filtered);
+    if (result <= 0) {
+        return result;
+    }
+    result = module->def->notify_callback(anjay, filtered ? filtered : queue,
+                                          module->arg);
+    AVS_LIST_CLEAR(&filtered);
+    return result;
+}
+
 int _anjay_notify_perform(anjay_t *anjay,
                           anjay_notify_queue_t queue) {
     if (!queue) {
         return 0;
     }
+    // cached values need to be gone before observations are re-evaluated
+    invalidate_read_cache(anjay, queue);
     int ret = 0;
     AVS_LIST(anjay_notify_queue_object_entry_t) it;
     AVS_LIST_FOREACH(it, queue) {
@@ -129,9 +295,7 @@ int _anjay_notify_perform(anjay_t *anjay,
     AVS_LIST(anjay_dm_installed_module_t) module;
     AVS_LIST_FOREACH(module, anjay->dm.modules) {
         if (module->def->notify_callback) {
-            _anjay_update_ret(&ret,
-                              module->def->notify_callback(anjay, queue,
-                                                           module->arg));
+            _anjay_update_ret(&ret, module_notify(anjay, module, queue));
         }
     }
     return ret;
@@ -259,6 +423,7 @@ int _anjay_notify_queue_instance_set_unknown_change(
         return -1;
     }
     (*entry_ptr)->instance_set_changes.instance_set_changed = true;
+    (*entry_ptr)->instance_set_changes.unknown_change = true;
     return 0;
 }
 
@@ -307,6 +472,56 @@ int _anjay_notify_queue_resource_change(anjay_notify_queue_t *out_queue,
     return 0;
 }
 
+static int merge_object_entry(anjay_notify_queue_t *out_queue,
+                              const anjay_notify_queue_object_entry_t *entry) {
+    if (entry->instance_set_changes.instance_set_changed) {
+        AVS_LIST(anjay_iid_t) iid;
+        AVS_LIST_FOREACH(iid, entry->instance_set_changes.known_added_iids) {
+            if (_anjay_notify_queue_instance_created(out_queue,
+                                                     entry->oid, *iid)) {
+                return -1;
+            }
+        }
+        AVS_LIST_FOREACH(iid, entry->instance_set_changes.known_removed_iids) {
+            if (_anjay_notify_queue_instance_removed(out_queue,
+                                                     entry->oid, *iid)) {
+                return -1;
+            }
+        }
+        if (entry->instance_set_changes.unknown_change
+                && _anjay_notify_queue_instance_set_unknown_change(
+                        out_queue, entry->oid)) {
+            return -1;
+        }
+    }
+    AVS_LIST(anjay_notify_queue_resource_entry_t) res;
+    AVS_LIST_FOREACH(res, entry->resources_changed) {
+        if (_anjay_notify_queue_resource_change(out_queue, entry->oid,
+                                                res->iid, res->rid)) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int _anjay_notify_queue_merge(anjay_notify_queue_t *out_queue,
+                              anjay_notify_queue_t *src_queue_ptr) {
+    int result = 0;
+    if (!*out_queue) {
+        *out_queue = *src_queue_ptr;
+        *src_queue_ptr = NULL;
+    } else {
+        AVS_LIST(anjay_notify_queue_object_entry_t) it;
+        AVS_LIST_FOREACH(it, *src_queue_ptr) {
+            if ((result = merge_object_entry(out_queue, it))) {
+                break;
+            }
+        }
+    }
+    _anjay_notify_clear_queue(src_queue_ptr);
+    return result;
+}
+
 void _anjay_notify_clear_queue(anjay_notify_queue_t *out_queue) {
     AVS_LIST_CLEAR(out_queue) {
         AVS_LIST_CLEAR(&(*out_queue)->instance_set_changes.known_added_iids);
@@ -342,6 +557,9 @@ int anjay_notify_changed(anjay_t *anjay,
                          anjay_oid_t oid,
                          anjay_iid_t iid,
                          anjay_rid_t rid) {
+    // the notification itself is deferred, but Reads must not return the
+    // outdated value in the meantime
+    _anjay_dm_read_cache_invalidate(anjay, oid, iid, rid);
     int retval;
     (void) ((retval = _anjay_notify_queue_resource_change(
                     &anjay->scheduled_notify.queue, oid, iid, rid))
@@ -350,6 +568,7 @@ int anjay_notify_changed(anjay_t *anjay,
 }
 
 int anjay_notify_instances_changed(anjay_t *anjay, anjay_oid_t oid) {
+    _anjay_dm_read_cache_invalidate_object(anjay, oid);
     int retval;
     (void) ((retval = _anjay_notify_queue_instance_set_unknown_change(
                     &anjay->scheduled_notify.queue, oid))
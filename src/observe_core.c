@@ -24,6 +24,7 @@
 
 #include "coap/content_format.h"
 
+#include "access_control_utils.h"
 #include "anjay_core.h"
 #include "dm/query.h"
 #include "observe_core.h"
@@ -35,6 +36,22 @@ struct anjay_observe_entry_struct {
     anjay_sched_handle_t notify_task;
     avs_time_real_t last_confirmable;
 
+    // set whenever a change that may affect the observed value is reported,
+    // cleared whenever the value is read from the data model
+    bool change_pending;
+
+    // set when notify_task has been pulled forward to a queue mode wake-up,
+    // cleared whenever it is handled, rescheduled or cancelled; only such
+    // a trigger may treat "pmax" expiring within the wake-up slack as already
+    // expired
+    bool pulled_forward;
+
+#ifdef WITH_EVAL_PERIOD_ATTRS
+    // time at which the value was last read from the data model, used to
+    // enforce the "epmin" and "epmax" attributes
+    avs_time_real_t last_evaluated;
+#endif // WITH_EVAL_PERIOD_ATTRS
+
     // last_sent has ALWAYS EXACTLY one element,
     // but is stored as a list to allow easy moving from unsent
     AVS_LIST(anjay_observe_resource_value_t) last_sent;
@@ -121,10 +138,15 @@ int _anjay_observe_init(anjay_t *anjay, bool confirmable_notifications) {
     return 0;
 }
 
+static void cancel_trigger(anjay_t *anjay, anjay_observe_entry_t *entry) {
+    entry->pulled_forward = false;
+    _anjay_sched_del(anjay->sched, &entry->notify_task);
+}
+
 static void cleanup_connection(anjay_t *anjay,
                                anjay_observe_connection_entry_t *conn) {
     AVS_RBTREE_DELETE(&conn->entries) {
-        _anjay_sched_del(anjay->sched, &(*conn->entries)->notify_task);
+        cancel_trigger(anjay, *conn->entries);
         AVS_LIST_CLEAR(&(*conn->entries)->last_sent);
     }
     _anjay_sched_del(anjay->sched, &conn->flush_task);
@@ -174,8 +196,9 @@ const anjay_observe_stream_t *_anjay_observe_stream_initializer__(void) {
 static void clear_entry(anjay_t *anjay,
                         anjay_observe_connection_entry_t *connection,
                         anjay_observe_entry_t *entry) {
-    _anjay_sched_del(anjay->sched, &entry->notify_task);
+    cancel_trigger(anjay, entry);
     AVS_LIST_CLEAR(&entry->last_sent);
+    entry->change_pending = false;
 
     if (entry->last_unsent) {
         anjay_observe_resource_value_t **unsent_ptr;
@@ -223,25 +246,104 @@ newest_value(const anjay_observe_entry_t *entry) {
     }
 }
 
+static avs_time_duration_t delay_until_period_passes(avs_time_real_t since,
+                                                     time_t period) {
+    avs_time_duration_t delay = avs_time_real_diff(since, avs_time_real_now());
+    delay = avs_time_duration_add(
+            delay, avs_time_duration_from_scalar(period, AVS_TIME_S));
+    if (avs_time_duration_less(delay, AVS_TIME_DURATION_ZERO)) {
+        delay = AVS_TIME_DURATION_ZERO;
+    }
+    return delay;
+}
+
+static int schedule_trigger_delayed(anjay_t *anjay,
+                                    anjay_observe_entry_t *entry,
+                                    avs_time_duration_t delay) {
+    cancel_trigger(anjay, entry);
+    return _anjay_sched(anjay->sched, &entry->notify_task, delay,
+                        trigger_observe, entry);
+}
+
 static int schedule_trigger(anjay_t *anjay,
                             anjay_observe_entry_t *entry,
                             time_t period) {
     if (period < 0) {
         return 0;
     }
+    return schedule_trigger_delayed(
+            anjay, entry,
+            delay_until_period_passes(newest_value(entry)->timestamp, period));
+}
 
-    avs_time_duration_t delay =
-            avs_time_real_diff(newest_value(entry)->timestamp,
-                               avs_time_real_now());
-    delay = avs_time_duration_add(
-            delay, avs_time_duration_from_scalar(period, AVS_TIME_S));
-    if (avs_time_duration_less(delay, AVS_TIME_DURATION_ZERO)) {
-        delay = AVS_TIME_DURATION_ZERO;
+/**
+ * Schedules the trigger that evaluates @p entry when no change is reported,
+ * i.e. when "pmax" expires, or earlier if "epmax" requires the value to be
+ * sampled sooner. Sampling is never scheduled before "pmin" passes, as no
+ * notification could be sent in that case anyway.
+ */
+static int
+schedule_periodic_trigger(anjay_t *anjay,
+                          anjay_observe_entry_t *entry,
+                          const anjay_dm_internal_res_attrs_t *attrs) {
+#ifdef WITH_EVAL_PERIOD_ATTRS
+    if (attrs->custom.data.max_eval_period > 0) {
+        const avs_time_real_t newest = newest_value(entry)->timestamp;
+        avs_time_duration_t delay = delay_until_period_passes(
+                entry->last_evaluated, attrs->custom.data.max_eval_period);
+        if (attrs->standard.common.min_period > 0) {
+            avs_time_duration_t pmin_delay = delay_until_period_passes(
+                    newest, attrs->standard.common.min_period);
+            if (avs_time_duration_less(delay, pmin_delay)) {
+                delay = pmin_delay;
+            }
+        }
+        if (attrs->standard.common.max_period >= 0) {
+            avs_time_duration_t pmax_delay = delay_until_period_passes(
+                    newest, attrs->standard.common.max_period);
+            if (avs_time_duration_less(pmax_delay, delay)) {
+                delay = pmax_delay;
+            }
+        }
+        return schedule_trigger_delayed(anjay, entry, delay);
     }
+#endif // WITH_EVAL_PERIOD_ATTRS
+    return schedule_trigger(anjay, entry, attrs->standard.common.max_period);
+}
 
-    _anjay_sched_del(anjay->sched, &entry->notify_task);
-    return _anjay_sched(anjay->sched, &entry->notify_task, delay,
-                        trigger_observe, entry);
+/**
+ * Schedules the trigger that evaluates @p entry after a change is reported,
+ * i.e. as soon as "pmin" passes - but, if "epmin" is set, no sooner than that
+ * since the previous evaluation, however often the changes are reported.
+ */
+static int schedule_change_trigger(anjay_t *anjay,
+                                   anjay_observe_entry_t *entry,
+                                   const anjay_dm_internal_res_attrs_t *attrs) {
+    time_t period = 0;
+    if (attrs->standard.common.min_period > 0) {
+        period = attrs->standard.common.min_period;
+    }
+#ifdef WITH_EVAL_PERIOD_ATTRS
+    if (attrs->custom.data.min_eval_period > 0) {
+        const avs_time_real_t newest = newest_value(entry)->timestamp;
+        avs_time_duration_t delay = delay_until_period_passes(newest, period);
+        avs_time_duration_t epmin_delay = delay_until_period_passes(
+                entry->last_evaluated, attrs->custom.data.min_eval_period);
+        if (avs_time_duration_less(delay, epmin_delay)) {
+            delay = epmin_delay;
+        }
+        // pmax still has to be honored, even if it means sampling earlier
+        if (attrs->standard.common.max_period >= 0) {
+            avs_time_duration_t pmax_delay = delay_until_period_passes(
+                    newest, attrs->standard.common.max_period);
+            if (avs_time_duration_less(pmax_delay, delay)) {
+                delay = pmax_delay;
+            }
+        }
+        return schedule_trigger_delayed(anjay, entry, delay);
+    }
+#endif // WITH_EVAL_PERIOD_ATTRS
+    return schedule_trigger(anjay, entry, period);
 }
 
 static AVS_LIST(anjay_observe_resource_value_t)
@@ -299,7 +401,7 @@ static int insert_error(anjay_t *anjay,
                         anjay_observe_entry_t *entry,
                         const avs_coap_msg_identity_t *identity,
                         int outer_result) {
-    _anjay_sched_del(anjay->sched, &entry->notify_task);
+    cancel_trigger(anjay, entry);
     const anjay_msg_details_t details = {
         .msg_type = anjay->observe.confirmable_notifications
                 ? AVS_COAP_MSG_CONFIRMABLE : AVS_COAP_MSG_NON_CONFIRMABLE,
@@ -377,14 +479,16 @@ static int insert_initial_value(
 
     int result;
     anjay_dm_internal_res_attrs_t attrs;
+#ifdef WITH_EVAL_PERIOD_ATTRS
+    entry->last_evaluated = now;
+#endif // WITH_EVAL_PERIOD_ATTRS
     // we assume that the initial value should be treated as sent,
     // even though we haven't actually sent it ourselves
     if (!(result = get_attrs(anjay, &attrs, &entry->key))
             && (entry->last_sent =
                     create_resource_value(details, entry, identity,
                                           numeric, data, size))
-            && !(result = schedule_trigger(anjay, entry,
-                                           attrs.standard.common.max_period))) {
+            && !(result = schedule_periodic_trigger(anjay, entry, &attrs))) {
         entry->last_confirmable = now;
     } else {
         clear_entry(anjay, conn_state, entry);
@@ -552,10 +656,12 @@ void _anjay_observe_gc(anjay_t *anjay) {
 }
 
 static bool has_pmax_expired(const anjay_observe_resource_value_t *value,
-                             const anjay_dm_attributes_t *attrs) {
+                             const anjay_dm_attributes_t *attrs,
+                             avs_time_duration_t slack) {
     return attrs->max_period >= 0
-            && avs_time_real_diff(avs_time_real_now(), value->timestamp).seconds
-                    >= attrs->max_period;
+            && avs_time_duration_add(
+                    avs_time_real_diff(avs_time_real_now(), value->timestamp),
+                    slack).seconds >= attrs->max_period;
 }
 
 static bool process_step(const anjay_observe_resource_value_t *previous,
@@ -795,8 +901,7 @@ static void schedule_all_triggers(anjay_t *anjay,
         if (!entry->notify_task) {
             anjay_dm_internal_res_attrs_t attrs;
             if (get_attrs(anjay, &attrs, &entry->key)
-                    || schedule_trigger(anjay, entry,
-                                        attrs.standard.common.max_period)) {
+                    || schedule_periodic_trigger(anjay, entry, &attrs)) {
                 anjay_log(ERROR,
                           "Could not schedule automatic notification trigger");
             }
@@ -866,10 +971,25 @@ int _anjay_observe_sched_flush_current_connection(anjay_t *anjay) {
     return sched_flush_send_queue(anjay, conn);
 }
 
+/**
+ * Result of a data model read performed for a notification. It is kept across
+ * calls to <c>update_notification_value()</c>, so that observations of the same
+ * path by multiple servers may be served with a single read - see
+ * <c>trigger_observe()</c>.
+ */
+typedef struct {
+    bool valid;
+    ssize_t size; // or a negative error code
+    anjay_msg_details_t details;
+    double numeric;
+    char buf[ANJAY_MAX_OBSERVABLE_RESOURCE_SIZE];
+} observe_read_result_t;
+
 static int
 update_notification_value(anjay_t *anjay,
                           anjay_observe_connection_entry_t *conn_state,
-                          anjay_observe_entry_t *entry) {
+                          anjay_observe_entry_t *entry,
+                          observe_read_result_t *read_result) {
     if (is_error_value(newest_value(entry))) {
         return 0;
     }
@@ -886,15 +1006,49 @@ update_notification_value(anjay_t *anjay,
         return result;
     }
 
-    bool pmax_expired = has_pmax_expired(newest_value(entry),
-                                         &attrs.standard.common);
-    char buf[ANJAY_MAX_OBSERVABLE_RESOURCE_SIZE];
+    // if this trigger has been pulled forward by queue_mode_align_jobs(), pmax
+    // expiring within the queue mode wake-up window is treated as expired, so
+    // that it actually sends the notification instead of waking the connection
+    // again later; other triggers only consider pmax expired when it really is
+    bool pmax_expired = has_pmax_expired(
+            newest_value(entry), &attrs.standard.common,
+            entry->pulled_forward
+                    ? _anjay_queue_mode_wakeup_slack(anjay, conn_state->key)
+                    : AVS_TIME_DURATION_ZERO);
+    const char *buf;
+    size_t size;
+    double numeric;
     anjay_msg_details_t observe_details;
-    double numeric = NAN;
-    ssize_t size = read_new_value(anjay, obj, entry, &observe_details, &numeric,
-                                  buf, sizeof(buf));
-    if (size < 0) {
-        return (int) size;
+    if (pmax_expired && !entry->change_pending && !read_result->valid
+            && (*obj)->all_changes_notified) {
+        // the Object reports all changes and none has been reported since the
+        // newest value was read, so it is still up to date
+        const anjay_observe_resource_value_t *newest = newest_value(entry);
+        buf = newest->value;
+        size = newest->value_length;
+        numeric = newest->numeric;
+        observe_details = newest->details;
+    } else {
+        if (!read_result->valid) {
+            read_result->numeric = NAN;
+            read_result->size = read_new_value(anjay, obj, entry,
+                                               &read_result->details,
+                                               &read_result->numeric,
+                                               read_result->buf,
+                                               sizeof(read_result->buf));
+            read_result->valid = true;
+        }
+        if (read_result->size < 0) {
+            return (int) read_result->size;
+        }
+        entry->change_pending = false;
+#ifdef WITH_EVAL_PERIOD_ATTRS
+        entry->last_evaluated = avs_time_real_now();
+#endif // WITH_EVAL_PERIOD_ATTRS
+        buf = read_result->buf;
+        size = (size_t) read_result->size;
+        numeric = read_result->numeric;
+        observe_details = read_result->details;
     }
 #ifdef WITH_CON_ATTR
     if (attrs.custom.data.con >= 0) {
@@ -908,67 +1062,205 @@ update_notification_value(anjay_t *anjay,
     }
 
     if (pmax_expired || should_update(newest_value(entry), &attrs.standard,
-                                      &observe_details, numeric,
-                                      buf, (size_t) size)) {
+                                      &observe_details, numeric, buf, size)) {
         result = insert_new_value(conn_state, entry, &observe_details,
                                   &newest_value(entry)->identity, numeric,
-                                  buf, (size_t) size);
+                                  buf, size);
     }
 
-    if (schedule_trigger(anjay, entry, attrs.standard.common.max_period)) {
+    if (schedule_periodic_trigger(anjay, entry, &attrs)) {
         anjay_log(ERROR, "Could not schedule automatic notification trigger");
     }
 
     return result;
 }
 
-static int trigger_observe(anjay_t *anjay, void *entry_) {
-    anjay_observe_entry_t *entry = (anjay_observe_entry_t *) entry_;
+static int process_trigger(anjay_t *anjay,
+                           anjay_observe_entry_t *entry,
+                           observe_read_result_t *read_result) {
     AVS_RBTREE_ELEM(anjay_observe_connection_entry_t) conn =
             AVS_RBTREE_FIND(anjay->observe.connection_entries,
                             connection_query(&entry->key.connection));
     assert(conn);
     observe_server_state_t state =
             server_state(anjay, entry->key.connection.ssid);
-    if (!state.server_active && !state.notification_storing_enabled) {
-        return 0;
+    int result = 0;
+    if (state.server_active || state.notification_storing_enabled) {
+        result = update_notification_value(anjay, conn, entry, read_result);
+        if (result) {
+            result = insert_error(anjay, conn, entry,
+                                  &newest_value(entry)->identity, result);
+        }
+        if (state.server_active) {
+            int flush_result = sched_flush_send_queue(anjay, conn);
+            if (!result) {
+                result = flush_result;
+            }
+        }
     }
+    // the trigger has been handled, so it no longer counts as pulled forward,
+    // even if it has not been rescheduled
+    entry->pulled_forward = false;
+    return result;
+}
 
-    int result = update_notification_value(anjay, conn, entry);
-    if (result) {
-        result = insert_error(anjay, conn, entry,
-                              &newest_value(entry)->identity, result);
+/**
+ * Checks whether a value read on behalf of @p entry may be reused for
+ * @p other , i.e. whether the read would produce the same output for both
+ * servers. Access Control is the only thing that depends on the server, so
+ * this is the case if both of them are granted or both are denied Read access
+ * to the observed instance.
+ *
+ * Object-level observations are never considered shareable, as checking that
+ * would require iterating over all the instances.
+ */
+static bool read_result_shareable(anjay_t *anjay,
+                                  const anjay_observe_entry_t *entry,
+                                  const anjay_observe_entry_t *other) {
+    if (entry->key.iid == ANJAY_IID_INVALID) {
+        return false;
     }
-    if (state.server_active) {
-        int flush_result = sched_flush_send_queue(anjay, conn);
-        if (!result) {
-            result = flush_result;
+    anjay_action_info_t info = {
+        .oid = entry->key.oid,
+        .iid = entry->key.iid,
+        .ssid = entry->key.connection.ssid,
+        .action = ANJAY_ACTION_READ
+    };
+    bool entry_allowed = _anjay_access_control_action_allowed(anjay, &info);
+    info.ssid = other->key.connection.ssid;
+    return entry_allowed == _anjay_access_control_action_allowed(anjay, &info);
+}
+
+static bool trigger_due(anjay_t *anjay, const anjay_observe_entry_t *entry) {
+    avs_time_duration_t delay;
+    return entry->notify_task
+            && !_anjay_sched_time_to_job(anjay->sched, entry->notify_task,
+                                         &delay)
+            && !avs_time_duration_less(AVS_TIME_DURATION_ZERO, delay);
+}
+
+static int trigger_observe(anjay_t *anjay, void *entry_) {
+    anjay_observe_entry_t *entry = (anjay_observe_entry_t *) entry_;
+    observe_read_result_t read_result = {
+        .valid = false
+    };
+    int result = process_trigger(anjay, entry, &read_result);
+    if (!read_result.valid) {
+        return result;
+    }
+
+    // Observations of the same path and format by other connections, whose
+    // triggers are also due, are handled right away using the same value,
+    // instead of reading and encoding it again in their own jobs.
+    anjay_observe_key_t sibling_key = entry->key;
+    AVS_RBTREE_ELEM(anjay_observe_connection_entry_t) conn;
+    AVS_RBTREE_FOREACH(conn, anjay->observe.connection_entries) {
+        if (!connection_key_cmp(&conn->key, &entry->key.connection)) {
+            continue;
+        }
+        sibling_key.connection = conn->key;
+        AVS_RBTREE_ELEM(anjay_observe_entry_t) sibling =
+                AVS_RBTREE_FIND(conn->entries, entry_query(&sibling_key));
+        if (sibling && trigger_due(anjay, sibling)
+                && read_result_shareable(anjay, entry, sibling)) {
+            // pulled_forward is left in place for process_trigger(), which
+            // clears it just like when the sibling's own job runs
+            _anjay_sched_del(anjay->sched, &sibling->notify_task);
+            _anjay_update_ret(&result,
+                              process_trigger(anjay, sibling, &read_result));
         }
     }
     return result;
 }
 
+void _anjay_observe_pull_forward_triggers(anjay_t *anjay,
+                                          anjay_connection_key_t key,
+                                          avs_time_duration_t max_delay) {
+    AVS_RBTREE_ELEM(anjay_observe_connection_entry_t) conn =
+            AVS_RBTREE_FIND(anjay->observe.connection_entries,
+                            connection_query(&key));
+    if (!conn) {
+        return;
+    }
+
+    avs_time_real_t now = avs_time_real_now();
+    AVS_RBTREE_ELEM(anjay_observe_entry_t) entry;
+    AVS_RBTREE_FOREACH(entry, conn->entries) {
+        avs_time_duration_t delay;
+        anjay_dm_internal_res_attrs_t attrs;
+        if (!entry->notify_task
+                || _anjay_sched_time_to_job(anjay->sched, entry->notify_task,
+                                            &delay)
+                || avs_time_duration_less(max_delay, delay)
+                || get_attrs(anjay, &attrs, &entry->key)) {
+            continue;
+        }
+        if (attrs.standard.common.min_period > 0
+                && avs_time_real_diff(now, newest_value(entry)->timestamp)
+                                .seconds < attrs.standard.common.min_period) {
+            // never violate pmin
+            continue;
+        }
+#ifdef WITH_EVAL_PERIOD_ATTRS
+        if (attrs.custom.data.min_eval_period > 0
+                && avs_time_real_diff(now, entry->last_evaluated).seconds
+                        < attrs.custom.data.min_eval_period) {
+            // nor epmin
+            continue;
+        }
+#endif // WITH_EVAL_PERIOD_ATTRS
+        if (!_anjay_sched_pull_forward(anjay->sched, &entry->notify_task,
+                                       max_delay)) {
+            entry->pulled_forward = true;
+        }
+    }
+}
+
 static inline int notify_entry(anjay_t *anjay,
                                const anjay_dm_object_def_t *const *obj,
                                anjay_observe_entry_t *entry) {
-    anjay_dm_internal_res_attrs_t attrs = ANJAY_DM_INTERNAL_RES_ATTRS_EMPTY;
-    time_t period = 0;
-    if (!get_effective_attrs(anjay, &attrs, obj, &entry->key)
-            && attrs.standard.common.min_period > 0) {
-        period = attrs.standard.common.min_period;
+    entry->change_pending = true;
+    anjay_dm_internal_res_attrs_t attrs;
+    if (get_effective_attrs(anjay, &attrs, obj, &entry->key)) {
+        attrs = ANJAY_DM_INTERNAL_RES_ATTRS_EMPTY;
     }
-    return schedule_trigger(anjay, entry, period);
+    return schedule_change_trigger(anjay, entry, &attrs);
 }
 
 #ifdef ANJAY_TEST
 #include "test/observe_mock.h"
 #endif // ANJAY_TEST
 
+typedef int observe_entry_handler_t(anjay_t *anjay,
+                                    const anjay_dm_object_def_t *const *obj,
+                                    anjay_observe_entry_t *entry);
+
+static int notify_entry_handler(anjay_t *anjay,
+                                const anjay_dm_object_def_t *const *obj,
+                                anjay_observe_entry_t *entry) {
+    return notify_entry(anjay, obj, entry);
+}
+
+/**
+ * Used for observations that shall not be notified about a change (because it
+ * was made by the observing server itself), but whose value still needs to be
+ * read again instead of being reused when "pmax" expires.
+ */
+static int mark_change_pending(anjay_t *anjay,
+                               const anjay_dm_object_def_t *const *obj,
+                               anjay_observe_entry_t *entry) {
+    (void) anjay;
+    (void) obj;
+    entry->change_pending = true;
+    return 0;
+}
+
 static int observe_notify_bound(anjay_t *anjay,
                                 anjay_observe_connection_entry_t *connection,
                                 const anjay_observe_key_t *lower_bound,
                                 const anjay_observe_key_t *upper_bound,
-                                const anjay_dm_object_def_t *const *obj) {
+                                const anjay_dm_object_def_t *const *obj,
+                                observe_entry_handler_t *handler) {
     int retval = 0;
     AVS_RBTREE_ELEM(anjay_observe_entry_t) it =
             AVS_RBTREE_LOWER_BOUND(connection->entries,
@@ -981,7 +1273,7 @@ static int observe_notify_bound(anjay_t *anjay,
 
     for (; it != end; it = AVS_RBTREE_ELEM_NEXT(it)) {
         assert(it);
-        _anjay_update_ret(&retval, notify_entry(anjay, obj, it));
+        _anjay_update_ret(&retval, handler(anjay, obj, it));
     }
     return retval;
 }
@@ -991,7 +1283,8 @@ observe_notify_wildcard_impl(anjay_t *anjay,
                              anjay_observe_connection_entry_t *connection,
                              const anjay_observe_key_t *specimen_key,
                              const anjay_dm_object_def_t *const *obj,
-                             bool iid_wildcard) {
+                             bool iid_wildcard,
+                             observe_entry_handler_t *handler) {
     anjay_observe_key_t lower_bound = *specimen_key;
     anjay_observe_key_t upper_bound = *specimen_key;
     lower_bound.format = 0;
@@ -1003,29 +1296,31 @@ observe_notify_wildcard_impl(anjay_t *anjay,
     lower_bound.rid = -1;
     upper_bound.rid = -1;
     return observe_notify_bound(anjay, connection,
-                                &lower_bound, &upper_bound, obj);
+                                &lower_bound, &upper_bound, obj, handler);
 }
 
 static inline int
 observe_notify_iid_wildcard(anjay_t *anjay,
                             anjay_observe_connection_entry_t *connection,
                             const anjay_observe_key_t *specimen_key,
-                            const anjay_dm_object_def_t *const *obj) {
+                            const anjay_dm_object_def_t *const *obj,
+                            observe_entry_handler_t *handler) {
     return observe_notify_wildcard_impl(anjay, connection,
-                                        specimen_key, obj, true);
+                                        specimen_key, obj, true, handler);
 }
 
 static inline int
 observe_notify_rid_wildcard(anjay_t *anjay,
                             anjay_observe_connection_entry_t *connection,
                             const anjay_observe_key_t *specimen_key,
-                            const anjay_dm_object_def_t *const *obj) {
+                            const anjay_dm_object_def_t *const *obj,
+                            observe_entry_handler_t *handler) {
     return observe_notify_wildcard_impl(anjay, connection,
-                                        specimen_key, obj, false);
+                                        specimen_key, obj, false, handler);
 }
 
 /**
- * Calls <c>notify_entry()</c> on all registered Observe entries that match
+ * Calls <c>handler</c> on all registered Observe entries that match
  * <c>key</c>.
  *
  * This is harder than may seem at the first glance, because both <c>key</c>
@@ -1100,7 +1395,8 @@ observe_notify_rid_wildcard(anjay_t *anjay,
 static int observe_notify(anjay_t *anjay,
                           anjay_observe_connection_entry_t *connection,
                           const anjay_observe_key_t *key,
-                          const anjay_dm_object_def_t *const *obj) {
+                          const anjay_dm_object_def_t *const *obj,
+                          observe_entry_handler_t *handler) {
     assert(key->format == AVS_COAP_FORMAT_NONE);
     assert(!obj || !*obj || (*obj)->oid == key->oid);
     assert(key->rid >= -1 && key->rid <= UINT16_MAX);
@@ -1120,20 +1416,20 @@ static int observe_notify(anjay_t *anjay,
         } else {
             _anjay_update_ret(&retval,
                               observe_notify_iid_wildcard(anjay, connection,
-                                                          key, obj));
+                                                          key, obj, handler));
         }
     } else {
         _anjay_update_ret(&retval,
                           observe_notify_rid_wildcard(anjay, connection,
-                                                      key, obj));
+                                                      key, obj, handler));
         _anjay_update_ret(&retval,
                           observe_notify_iid_wildcard(anjay, connection,
-                                                      key, obj));
+                                                      key, obj, handler));
     }
 
     _anjay_update_ret(&retval,
                       observe_notify_bound(anjay, connection, &lower_bound,
-                                           &upper_bound, obj));
+                                           &upper_bound, obj, handler));
     return retval;
 }
 
@@ -1149,13 +1445,20 @@ int _anjay_observe_notify(anjay_t *anjay,
     anjay_observe_key_t modified_key = *key;
     AVS_RBTREE_ELEM(anjay_observe_connection_entry_t) connection;
     AVS_RBTREE_FOREACH(connection, anjay->observe.connection_entries) {
+        observe_entry_handler_t *handler = notify_entry_handler;
         if ((connection->key.ssid == key->connection.ssid)
                 == invert_server_match) {
-            continue;
+            if (!invert_server_match) {
+                continue;
+            }
+            // the server that made the change is not notified about it, but
+            // the values stored for its observations are outdated all the same
+            handler = mark_change_pending;
         }
         modified_key.connection = connection->key;
         _anjay_update_ret(&result, observe_notify(anjay, connection,
-                                                  &modified_key, obj));
+                                                  &modified_key, obj,
+                                                  handler));
     }
     return result;
 }
@@ -99,11 +99,21 @@ int _anjay_observe_notify(anjay_t *anjay,
 anjay_output_ctx_t *_anjay_observe_decorate_ctx(anjay_output_ctx_t *backend,
                                                 double *out_numeric);
 
+/**
+ * Pulls forward automatic notification triggers for observations related to
+ * connection @p key that are scheduled no later than @p max_delay from now and
+ * for which the "pmin" period has already passed.
+ */
+void _anjay_observe_pull_forward_triggers(anjay_t *anjay,
+                                          anjay_connection_key_t key,
+                                          avs_time_duration_t max_delay);
+
 #else // WITH_OBSERVE
 
 #define _anjay_observe_init(...) ((int) 0)
 #define _anjay_observe_cleanup(...) ((void) 0)
 #define _anjay_observe_sched_flush_current_connection(...) ((void) 0)
+#define _anjay_observe_pull_forward_triggers(...) ((void) 0)
 
 #endif // WITH_OBSERVE
 
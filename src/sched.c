@@ -46,26 +46,78 @@ anjay_sched_t *_anjay_sched_new(anjay_t *anjay) {
     anjay_sched_t *sched = (anjay_sched_t *) calloc(1, sizeof(anjay_sched_t));
     if (sched) {
         sched->anjay = anjay;
+        sched->rand_seed = (anjay_rand_seed_t) (time(NULL) ^ (uintptr_t) sched);
     }
     return sched;
 }
 
+void _anjay_sched_seed(anjay_sched_t *sched, uint32_t seed) {
+    sched->rand_seed = (anjay_rand_seed_t) seed;
+}
+
+static bool task_due(anjay_sched_t *sched, const avs_time_monotonic_t *now) {
+    return sched->entries
+            && !avs_time_monotonic_before(*now, sched->entries->when);
+}
+
 static anjay_sched_entry_t *fetch_task(anjay_sched_t *sched,
                                        const avs_time_monotonic_t *now) {
-    if (sched->entries
-            && !avs_time_monotonic_before(*now, sched->entries->when)) {
+    if (task_due(sched, now)) {
         return AVS_LIST_DETACH(&sched->entries);
     } else {
         return NULL;
     }
 }
 
-static void update_backoff(anjay_sched_retryable_backoff_t *cfg) {
-    cfg->delay = avs_time_duration_mul(cfg->delay, 2);
+static double rand_unit(anjay_sched_t *sched) {
+    return (double) _anjay_rand32(&sched->rand_seed) / 4294967296.0;
+}
+
+static avs_time_duration_t
+min_duration(avs_time_duration_t a, avs_time_duration_t b) {
+    return avs_time_duration_less(b, a) ? b : a;
+}
 
-    if (avs_time_duration_less(cfg->max_delay, cfg->delay)) {
-        cfg->delay = cfg->max_delay;
+/**
+ * Returns the delay to wait before the next attempt of a failed job, and
+ * advances @p cfg so that the following call yields the delay after that.
+ */
+static avs_time_duration_t update_backoff(anjay_sched_t *sched,
+                                          anjay_sched_retryable_backoff_t *cfg) {
+    const double multiplier = cfg->multiplier >= 1.0 ? cfg->multiplier : 2.0;
+    const double max_s = avs_time_duration_to_fscalar(cfg->max_delay,
+                                                      AVS_TIME_S);
+
+    if (cfg->jitter == ANJAY_BACKOFF_JITTER_DECORRELATED) {
+        // delay holds the previous randomized delay
+        double low_s = avs_time_duration_to_fscalar(cfg->min_delay,
+                                                    AVS_TIME_S);
+        double high_s = multiplier
+                * avs_time_duration_to_fscalar(cfg->delay, AVS_TIME_S);
+        if (high_s < low_s) {
+            high_s = low_s;
+        }
+        double delay_s = low_s + rand_unit(sched) * (high_s - low_s);
+        cfg->delay = min_duration(
+                avs_time_duration_from_fscalar(delay_s, AVS_TIME_S),
+                cfg->max_delay);
+        return cfg->delay;
+    }
+
+    // delay holds the nominal delay; only the returned value is randomized
+    avs_time_duration_t result = cfg->delay;
+    if (cfg->jitter_fraction > 0.0) {
+        double delay_s = avs_time_duration_to_fscalar(cfg->delay, AVS_TIME_S);
+        result = avs_time_duration_from_fscalar(
+                delay_s * (1.0 - cfg->jitter_fraction * rand_unit(sched)),
+                AVS_TIME_S);
     }
+    double next_s = multiplier
+            * avs_time_duration_to_fscalar(cfg->delay, AVS_TIME_S);
+    cfg->delay = next_s < max_s
+            ? avs_time_duration_from_fscalar(next_s, AVS_TIME_S)
+            : cfg->max_delay;
+    return result;
 }
 
 static anjay_sched_handle_t
@@ -100,9 +152,13 @@ static void execute_task(anjay_sched_t *sched,
     case SCHED_TASK_RETRYABLE: {
             anjay_sched_retryable_backoff_t *backoff =
                     &get_retryable_entry(entry)->backoff;
+            avs_time_duration_t retry_delay = AVS_TIME_DURATION_INVALID;
+            if (clb_result != 0) {
+                retry_delay = update_backoff(sched, backoff);
+            }
 
             if (clb_result == 0
-                    || !sched_delayed(sched, backoff->delay, entry)) {
+                    || !sched_delayed(sched, retry_delay, entry)) {
                 sched_log(TRACE, "retryable job %p cancel (result = %d)",
                           (void*)entry, clb_result);
                 AVS_LIST_DELETE(&entry);
@@ -112,41 +168,67 @@ static void execute_task(anjay_sched_t *sched,
                            && "handle must not be modified if the job fails");
                     *entry->handle_ptr = handle;
                 }
-                update_backoff(backoff);
                 sched_log(TRACE, "retryable job %p backoff = %d.%09u (result = "
-                          "%d)", (void*)entry, (int)backoff->delay.seconds,
-                          (unsigned)backoff->delay.nanoseconds, clb_result);
+                          "%d)", (void*)entry, (int)retry_delay.seconds,
+                          (unsigned)retry_delay.nanoseconds, clb_result);
             }
         }
         return;
     }
 }
 
-ssize_t _anjay_sched_run(anjay_sched_t *sched) {
-    int running = 1;
+static bool budget_exhausted(size_t tasks_executed,
+                             size_t max_jobs,
+                             const avs_time_monotonic_t *deadline) {
+    if (max_jobs && tasks_executed >= max_jobs) {
+        return true;
+    }
+    // at least one job is always executed, so that progress is guaranteed
+    return tasks_executed > 0
+            && avs_time_monotonic_valid(*deadline)
+            && !avs_time_monotonic_before(avs_time_monotonic_now(), *deadline);
+}
+
+ssize_t _anjay_sched_run_bounded(anjay_sched_t *sched,
+                                 size_t max_jobs,
+                                 avs_time_duration_t max_duration,
+                                 bool *out_work_remaining) {
     ssize_t tasks_executed = 0;
 
     avs_time_monotonic_t now = avs_time_monotonic_now();
+    avs_time_monotonic_t deadline = AVS_TIME_MONOTONIC_INVALID;
+    if (avs_time_duration_valid(max_duration)) {
+        deadline = avs_time_monotonic_add(now, max_duration);
+    }
 
-    while (running) {
+    while (!budget_exhausted((size_t) tasks_executed, max_jobs, &deadline)) {
         anjay_sched_entry_t *task = fetch_task(sched, &now);
         if (!task) {
-            running = 0;
-        } else {
-            execute_task(sched, task);
-            ++tasks_executed;
+            break;
         }
+        execute_task(sched, task);
+        ++tasks_executed;
+    }
+
+    bool work_remaining = task_due(sched, &now);
+    if (out_work_remaining) {
+        *out_work_remaining = work_remaining;
     }
 
     avs_time_duration_t delay = AVS_TIME_DURATION_ZERO;
     _anjay_sched_time_to_next(sched, &delay);
-    sched_log(TRACE, "%lu scheduled tasks remain; next after "
+    sched_log(TRACE, "%lu scheduled tasks remain (%s due); next after "
                      "%" PRId64 ".%09" PRId32,
               (unsigned long)AVS_LIST_SIZE(sched->entries),
+              work_remaining ? "some" : "none",
               delay.seconds, delay.nanoseconds);
     return tasks_executed;
 }
 
+ssize_t _anjay_sched_run(anjay_sched_t *sched) {
+    return _anjay_sched_run_bounded(sched, 0, AVS_TIME_DURATION_INVALID, NULL);
+}
+
 void _anjay_sched_delete(anjay_sched_t **sched_ptr) {
     if (!sched_ptr || !*sched_ptr) {
         return;
@@ -316,6 +398,56 @@ int _anjay_sched_del(anjay_sched_t *sched, anjay_sched_handle_t *handle) {
     return result;
 }
 
+int _anjay_sched_time_to_job(anjay_sched_t *sched,
+                             anjay_sched_handle_t handle,
+                             avs_time_duration_t *out_delay) {
+    if (!sched || !handle) {
+        return -1;
+    }
+    anjay_sched_entry_t **task_ptr = find_task_entry_ptr(sched, &handle);
+    if (!task_ptr) {
+        sched_log(ERROR, "cannot find task %p", handle);
+        assert(0 && "Dangling handle detected");
+        return -1;
+    }
+    *out_delay = avs_time_monotonic_diff((*task_ptr)->when,
+                                         avs_time_monotonic_now());
+    if (avs_time_duration_less(*out_delay, AVS_TIME_DURATION_ZERO)) {
+        *out_delay = AVS_TIME_DURATION_ZERO;
+    }
+    return 0;
+}
+
+int _anjay_sched_pull_forward(anjay_sched_t *sched,
+                              anjay_sched_handle_t *handle,
+                              avs_time_duration_t max_delay) {
+    if (!sched || sched->shut_down || !handle || !*handle) {
+        return -1;
+    }
+    anjay_sched_entry_t **task_ptr = find_task_entry_ptr(sched, handle);
+    if (!task_ptr) {
+        sched_log(ERROR, "cannot pull forward task %p - not found", *handle);
+        assert(0 && "Dangling handle detected");
+        return -1;
+    }
+
+    avs_time_monotonic_t now = avs_time_monotonic_now();
+    if (!avs_time_monotonic_before(now, (*task_ptr)->when)) {
+        return 0;
+    }
+    if (avs_time_duration_less(max_delay, avs_time_monotonic_diff(
+                                                  (*task_ptr)->when, now))) {
+        return 1;
+    }
+
+    sched_log(TRACE, "pulling forward task %p", *handle);
+    AVS_LIST(anjay_sched_entry_t) entry = AVS_LIST_DETACH(task_ptr);
+    entry->when = now;
+    insert_entry(sched, entry);
+    assert(*handle == entry);
+    return 0;
+}
+
 int _anjay_sched_time_to_next(anjay_sched_t *sched,
                               avs_time_duration_t *delay) {
     anjay_sched_entry_t *elem;
@@ -17,9 +17,9 @@
 #ifndef ANJAY_SCHED_H
 #define ANJAY_SCHED_H
 
+#include <stdbool.h>
 #include <time.h>
 
-
 #include <anjay/core.h>
 
 VISIBILITY_PRIVATE_HEADER_BEGIN
@@ -36,7 +36,34 @@ typedef struct anjay_sched_struct anjay_sched_t;
  * @returns Created scheduler object, or NULL if there is not enough memory.
  */
 anjay_sched_t *_anjay_sched_new(anjay_t *anjay);
+
+/**
+ * Reseeds the pseudo-random generator used to randomize retry delays of
+ * retryable jobs.
+ */
+void _anjay_sched_seed(anjay_sched_t *sched, uint32_t seed);
 ssize_t _anjay_sched_run(anjay_sched_t *sched);
+
+/**
+ * Executes jobs that are due at the time of the call, like
+ * @ref _anjay_sched_run , but stops early once the budget is exhausted.
+ *
+ * @param sched              Scheduler object to run jobs from.
+ * @param max_jobs           Maximum number of jobs to execute, or 0 for no
+ *                           limit.
+ * @param max_duration       Maximum time to spend executing jobs, or
+ *                           AVS_TIME_DURATION_INVALID for no limit. It is
+ *                           checked between jobs, and at least one due job is
+ *                           always executed.
+ * @param out_work_remaining If not NULL, set to true if some jobs that were due
+ *                           at the time of the call have not been executed.
+ *
+ * @return Number of jobs executed.
+ */
+ssize_t _anjay_sched_run_bounded(anjay_sched_t *sched,
+                                 size_t max_jobs,
+                                 avs_time_duration_t max_duration,
+                                 bool *out_work_remaining);
 void _anjay_sched_delete(anjay_sched_t **sched_ptr);
 
 /**
@@ -78,6 +105,41 @@ int _anjay_sched_del(anjay_sched_t *sched, anjay_sched_handle_t *handle);
 
 int _anjay_sched_time_to_next(anjay_sched_t *sched, avs_time_duration_t *delay);
 
+/**
+ * Determines time remaining until execution of the job identified by
+ * @p handle .
+ *
+ * @param sched         Scheduler object the job is scheduled in.
+ * @param handle        Handle of the job to check.
+ * @param[out] out_delay Relative time from now of the job execution; zero if
+ *                      the job is already due.
+ *
+ * @return 0 on success, negative value if @p handle is invalid.
+ */
+int _anjay_sched_time_to_job(anjay_sched_t *sched,
+                             anjay_sched_handle_t handle,
+                             avs_time_duration_t *out_delay);
+
+/**
+ * Reschedules the job pointed to by @p handle to be executed as soon as
+ * possible, but only if it is already scheduled to run no later than
+ * @p max_delay from now. Jobs scheduled further in the future are left
+ * untouched.
+ *
+ * The handle itself remains valid and keeps referring to the same job.
+ *
+ * @param sched     Scheduler object the job is scheduled in.
+ * @param handle    Pointer to the job handle.
+ * @param max_delay Maximum distance from now of the jobs that may be moved.
+ *
+ * @return 0 if the job is now due, 1 if it was left in place because it is
+ *         scheduled later than @p max_delay from now, negative value in case
+ *         of an error.
+ */
+int _anjay_sched_pull_forward(anjay_sched_t *sched,
+                              anjay_sched_handle_t *handle,
+                              avs_time_duration_t max_delay);
+
 /**
  * See @ref _anjay_sched for details.
  */
@@ -95,6 +157,21 @@ typedef struct {
 
     /** Maximum delay between a failed job execution and next attempt. */
     avs_time_duration_t max_delay;
+
+    /** Factor by which the delay grows after each failed attempt. Values
+     * lower than 1.0 (including 0.0) are treated as 2.0. */
+    double multiplier;
+
+    /** Fraction of each delay that is randomized, see
+     * @ref ANJAY_BACKOFF_JITTER_PROPORTIONAL . */
+    double jitter_fraction;
+
+    /** Randomization strategy. */
+    anjay_backoff_jitter_t jitter;
+
+    /** Lower bound of delays drawn by @ref ANJAY_BACKOFF_JITTER_DECORRELATED .
+     */
+    avs_time_duration_t min_delay;
 } anjay_sched_retryable_backoff_t;
 
 /**
@@ -102,7 +179,7 @@ typedef struct {
  * canceled using @ref _anjay_sched_del .
  *
  * First execution of the @p clb happens after @p delay . Following attempts use
- * an exponential backoff with a factor of 2, determined by @p backoff .
+ * an exponential backoff, optionally randomized, determined by @p backoff .
  *
  * Note: Similar as to @ref _anjay_sched behavior should be expected, except
  * that job handle invalidation is slightly more complicated:
@@ -17,6 +17,8 @@
 #ifndef ANJAY_SCHED_INTERNAL_H
 #define ANJAY_SCHED_INTERNAL_H
 
+#include "utils_core.h"
+
 VISIBILITY_PRIVATE_HEADER_BEGIN
 
 #if !(defined(ANJAY_SCHED_C) || defined(ANJAY_TEST))
@@ -47,6 +49,7 @@ struct anjay_sched_struct {
     anjay_t *anjay;
     AVS_LIST(anjay_sched_entry_t) entries;
     bool shut_down;
+    anjay_rand_seed_t rand_seed;
 };
 
 VISIBILITY_PRIVATE_HEADER_END
@@ -42,11 +42,21 @@ typedef struct {
     anjay_binding_mode_t binding_mode;
 } anjay_update_parameters_t;
 
+typedef struct {
+    // Uri-Query options of the Register message, kept between registrations
+    // and rebuilt only if the lifetime or binding mode they were made for
+    // changes
+    AVS_LIST(const anjay_string_t) query;
+    int64_t lifetime_s;
+    anjay_binding_mode_t binding_mode;
+} anjay_register_query_cache_t;
+
 typedef struct {
     AVS_LIST(const anjay_string_t) endpoint_path;
     anjay_connection_type_t conn_type;
     avs_time_monotonic_t expire_time;
     anjay_update_parameters_t last_update_params;
+    anjay_register_query_cache_t register_query;
 } anjay_registration_info_t;
 
 typedef enum {
@@ -110,6 +120,21 @@ typedef struct {
      * <c>_anjay_connection_internal_ensure_online()</c>.
      */
     anjay_sched_handle_t queue_mode_close_socket_clb_handle;
+
+    /**
+     * CoAP ping keepalive, (re)scheduled by @ref _anjay_release_server_stream
+     * after every exchange on non-queue mode connections - see keepalive.c.
+     */
+    anjay_sched_handle_t keepalive_clb_handle;
+
+    /**
+     * Traffic counters of this connection. While the connection is bound to
+     * the communication stream, traffic is accounted for in the global CoAP
+     * context counters first, and only added here by
+     * @ref _anjay_release_server_stream_without_scheduling_queue - see
+     * <c>anjay_t::current_connection_stats_snapshot</c>.
+     */
+    anjay_traffic_stats_t stats;
 } anjay_server_connection_t;
 
 typedef struct {
@@ -120,6 +145,8 @@ typedef struct {
 
     anjay_registration_info_t registration_info;
     anjay_sched_handle_t sched_update_handle;
+    // staggered reconnection after leaving offline mode; see offline.c
+    anjay_sched_handle_t sched_reconnect_handle;
 } anjay_active_server_info_t;
 
 // inactive servers include administratively disabled ones
@@ -130,6 +157,11 @@ typedef struct {
     bool needs_activation;
 } anjay_inactive_server_info_t;
 
+typedef struct {
+    anjay_ssid_t ssid;
+    avs_time_duration_t interval;
+} anjay_keepalive_override_t;
+
 typedef struct {
     AVS_LIST(anjay_active_server_info_t) active;
     AVS_LIST(anjay_inactive_server_info_t) inactive;
@@ -147,6 +179,28 @@ typedef struct {
     anjay_connection_type_t conn_type;
 } anjay_connection_ref_t;
 
+typedef struct {
+    avs_net_abstract_socket_t *socket;
+    anjay_connection_ref_t ref;
+} anjay_socket_map_entry_t;
+
+/**
+ * Open-addressing hash table mapping server sockets to connections they
+ * belong to, so that @ref anjay_serve does not need to scan the list of active
+ * servers for every incoming packet.
+ *
+ * It is kept in <c>anjay_t</c> rather than @ref anjay_servers_t, because the
+ * latter is rebuilt from scratch on every reload, while the active server
+ * entries (and their sockets) are moved over without being reallocated.
+ */
+typedef struct {
+    anjay_socket_map_entry_t *entries;
+    size_t capacity; // zero or a power of two
+    size_t size;
+} anjay_socket_map_t;
+
+void _anjay_socket_map_cleanup(anjay_socket_map_t *map);
+
 static inline anjay_servers_t
 _anjay_servers_create(void) {
     return (anjay_servers_t){ NULL, NULL, NULL };
@@ -159,11 +213,13 @@ _anjay_servers_create(void) {
 void _anjay_servers_cleanup(anjay_t *anjay);
 
 /**
- * Returns an active server object associated with given @p socket .
+ * Returns a reference to the server connection associated with given
+ * @p socket . If there is no such connection, <c>server</c> field of the
+ * returned reference is NULL.
  */
-anjay_active_server_info_t *
-_anjay_servers_find_by_udp_socket(anjay_servers_t *servers,
-                                  avs_net_abstract_socket_t *socket);
+anjay_connection_ref_t
+_anjay_servers_find_by_socket(anjay_t *anjay,
+                              avs_net_abstract_socket_t *socket);
 
 /**
  * Returns an active server object for given SSID.
@@ -210,6 +266,15 @@ _anjay_connection_get_prepared_socket(anjay_t *anjay,
 
 void _anjay_connection_suspend(anjay_connection_ref_t conn_ref);
 
+/**
+ * (Re)schedules the CoAP ping keepalive for the connection identified by
+ * @p ref to be sent after the keepalive interval configured for its server.
+ * If keepalives are not applicable to the connection (e.g. it is in queue
+ * mode or the interval is zero), a previously scheduled one is canceled.
+ */
+void _anjay_connection_schedule_keepalive(anjay_t *anjay,
+                                          anjay_connection_ref_t ref);
+
 VISIBILITY_PRIVATE_HEADER_END
 
 #endif // ANJAY_SERVERS_H
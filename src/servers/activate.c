@@ -115,7 +115,7 @@ static int sched_reactivate_server(anjay_t *anjay,
                                    avs_time_duration_t reactivate_delay) {
     _anjay_sched_del(anjay->sched, &server->sched_reactivate_handle);
     if (_anjay_sched_retryable(anjay->sched, &server->sched_reactivate_handle,
-                               reactivate_delay, ANJAY_SERVER_RETRYABLE_BACKOFF,
+                               reactivate_delay, anjay->server_backoff,
                                activate_server_job,
                                (void *) (uintptr_t) server->ssid)) {
         anjay_log(TRACE, "could not schedule reactivate job for server SSID %u",
@@ -28,6 +28,7 @@
 #define ANJAY_SERVERS_INTERNALS
 
 #include "connection_info.h"
+#include "socket_map.h"
 
 VISIBILITY_SOURCE_BEGIN
 
@@ -72,7 +73,16 @@ avs_net_abstract_socket_t *_anjay_connection_internal_get_socket(
 }
 
 void
-_anjay_connection_internal_clean_socket(anjay_server_connection_t *connection) {
+_anjay_connection_internal_clean_socket(anjay_t *anjay,
+                                        anjay_server_connection_t *connection) {
+    if (connection->conn_priv_data_.socket) {
+        _anjay_socket_map_remove(&anjay->server_sockets,
+                                 connection->conn_priv_data_.socket);
+        if (anjay->comm_stream) {
+            _anjay_coap_stream_drop_deferred_requests(
+                    anjay->comm_stream, connection->conn_priv_data_.socket);
+        }
+    }
     avs_net_socket_cleanup(&connection->conn_priv_data_.socket);
     memset(&connection->conn_priv_data_, 0,
            sizeof(connection->conn_priv_data_));
@@ -254,7 +264,7 @@ refresh_connection(anjay_t *anjay,
     bool should_be_connected =
             (def->get_connection_mode(info) != ANJAY_CONNECTION_DISABLED);
     if (!should_be_connected) {
-        _anjay_connection_internal_clean_socket(out_connection);
+        _anjay_connection_internal_clean_socket(anjay, out_connection);
     } else {
         dtls_keys_t dtls_keys = EMPTY_DTLS_KEYS_INITIALIZER;
         if (def->get_connection_info(anjay, info, &dtls_keys,
@@ -265,7 +275,7 @@ refresh_connection(anjay_t *anjay,
         }
         if (existing_socket == NULL || force_reconnect
                 || out_connection->needs_socket_update) {
-            _anjay_connection_internal_clean_socket(out_connection);
+            _anjay_connection_internal_clean_socket(anjay, out_connection);
             if (def->create_connected_socket(anjay, out_connection, info,
                                              &dtls_keys)
                 || avs_net_socket_get_local_port(
@@ -276,6 +286,17 @@ refresh_connection(anjay_t *anjay,
                 avs_net_socket_cleanup(&out_connection->conn_priv_data_.socket);
                 return RESULT_ERROR;
             }
+            if (_anjay_socket_map_insert(&anjay->server_sockets,
+                                         out_connection->conn_priv_data_.socket,
+                                         (anjay_connection_ref_t) {
+                                             .server = server,
+                                             .conn_type = def->type
+                                         })) {
+                anjay_log(ERROR, "could not register %s socket for SSID %u",
+                          def->name, server->ssid);
+                avs_net_socket_cleanup(&out_connection->conn_priv_data_.socket);
+                return RESULT_ERROR;
+            }
         } else if (_anjay_connection_internal_ensure_online(out_connection)) {
             return RESULT_ERROR;
         }
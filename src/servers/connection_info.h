@@ -30,7 +30,8 @@ avs_net_abstract_socket_t *_anjay_connection_internal_get_socket(
         const anjay_server_connection_t *connection);
 
 void
-_anjay_connection_internal_clean_socket(anjay_server_connection_t *connection);
+_anjay_connection_internal_clean_socket(anjay_t *anjay,
+                                        anjay_server_connection_t *connection);
 
 int
 _anjay_connection_internal_ensure_online(anjay_server_connection_t *connection);
@@ -0,0 +1,190 @@
+/*
+ * Copyright 2017 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <config.h>
+
+#include "../anjay_core.h"
+#include "../servers.h"
+#include "../coap/coap_stream.h"
+
+VISIBILITY_SOURCE_BEGIN
+
+static avs_time_duration_t keepalive_interval(anjay_t *anjay,
+                                              anjay_ssid_t ssid) {
+    AVS_LIST(anjay_keepalive_override_t) it;
+    AVS_LIST_FOREACH(it, anjay->keepalive_overrides) {
+        if (it->ssid == ssid) {
+            return it->interval;
+        }
+    }
+    return anjay->keepalive_interval;
+}
+
+/**
+ * Sends a CoAP ping, i.e. an empty Confirmable message, through the currently
+ * bound stream. The stream takes care of retransmissions and of matching the
+ * Reset response (RFC 7252, 4.3), which it reports as a positive value.
+ */
+static int send_ping(anjay_t *anjay) {
+    const anjay_msg_details_t details = {
+        .msg_type = AVS_COAP_MSG_CONFIRMABLE,
+        .msg_code = AVS_COAP_CODE_EMPTY,
+        .format = AVS_COAP_FORMAT_NONE
+    };
+    // Empty messages must not carry a token
+    const avs_coap_token_t token = { .size = 0 };
+
+    int result;
+    (void) ((result = _anjay_coap_stream_setup_request(anjay->comm_stream,
+                                                       &details, &token))
+            || (result = avs_stream_finish_message(anjay->comm_stream)));
+    return result;
+}
+
+static int send_keepalive_job(anjay_t *anjay, void *ssid_) {
+    anjay_ssid_t ssid = (anjay_ssid_t) (uintptr_t) ssid_;
+    anjay_connection_ref_t ref = {
+        .server = _anjay_servers_find_active(&anjay->servers, ssid),
+        .conn_type = ANJAY_CONNECTION_UDP
+    };
+    if (!ref.server || anjay->offline || !_anjay_connection_is_online(ref)) {
+        // the first exchange after reconnecting will reschedule the keepalive
+        return 0;
+    }
+
+    avs_time_duration_t until_update;
+    if (!_anjay_sched_time_to_job(anjay->sched,
+                                  ref.server->sched_update_handle,
+                                  &until_update)
+            && avs_time_duration_less(until_update,
+                                      keepalive_interval(anjay, ssid))) {
+        // the Update will refresh NAT bindings just as well
+        _anjay_connection_schedule_keepalive(anjay, ref);
+        return 0;
+    }
+
+    if (_anjay_bind_server_stream(anjay, ref)) {
+        anjay_log(ERROR, "could not get stream for server %u", ssid);
+        return -1;
+    }
+
+    anjay_log(TRACE, "sending keepalive to SSID %u", ssid);
+    int result = send_ping(anjay);
+
+    avs_stream_reset(anjay->comm_stream);
+    _anjay_release_server_stream(anjay);
+
+    if (result >= 0) {
+        return 0;
+    }
+    if (result != AVS_COAP_CTX_ERR_NETWORK
+            && result != AVS_COAP_CTX_ERR_TIMEOUT) {
+        anjay_log(ERROR, "could not send keepalive: %d", result);
+        return result;
+    }
+    anjay_log(ERROR, "keepalive to SSID %u failed, reconnecting", ssid);
+    // As in send_update_sched_job(), the socket is suspended so that no more
+    // keepalives are sent until the reconnection succeeds, and the retryable
+    // Update job reconnects it using its own backoff.
+    _anjay_connection_suspend(ref);
+    return _anjay_schedule_server_reconnect(anjay, ref.server);
+}
+
+void _anjay_connection_schedule_keepalive(anjay_t *anjay,
+                                          anjay_connection_ref_t ref) {
+    anjay_server_connection_t *connection = _anjay_get_server_connection(ref);
+    if (!connection) {
+        return;
+    }
+    _anjay_sched_del(anjay->sched, &connection->keepalive_clb_handle);
+
+    if (ref.conn_type != ANJAY_CONNECTION_UDP
+            || ref.server->ssid == ANJAY_SSID_BOOTSTRAP
+            || _anjay_connection_current_mode(ref) != ANJAY_CONNECTION_ONLINE) {
+        return;
+    }
+    avs_time_duration_t interval = keepalive_interval(anjay, ref.server->ssid);
+    if (!avs_time_duration_less(AVS_TIME_DURATION_ZERO, interval)) {
+        return;
+    }
+
+    if (_anjay_sched(anjay->sched, &connection->keepalive_clb_handle, interval,
+                     send_keepalive_job,
+                     (void *) (uintptr_t) ref.server->ssid)) {
+        anjay_log(ERROR, "could not schedule keepalive for SSID %u",
+                  ref.server->ssid);
+    }
+}
+
+static int set_keepalive_override(anjay_t *anjay,
+                                  anjay_ssid_t ssid,
+                                  avs_time_duration_t interval) {
+    AVS_LIST(anjay_keepalive_override_t) *it;
+    AVS_LIST_FOREACH_PTR(it, &anjay->keepalive_overrides) {
+        if ((*it)->ssid == ssid) {
+            (*it)->interval = interval;
+            return 0;
+        }
+    }
+    AVS_LIST(anjay_keepalive_override_t) entry =
+            AVS_LIST_NEW_ELEMENT(anjay_keepalive_override_t);
+    if (!entry) {
+        anjay_log(ERROR, "out of memory");
+        return -1;
+    }
+    entry->ssid = ssid;
+    entry->interval = interval;
+    AVS_LIST_INSERT(it, entry);
+    return 0;
+}
+
+int anjay_set_server_keepalive_interval(anjay_t *anjay,
+                                        anjay_ssid_t ssid,
+                                        avs_time_duration_t interval) {
+    if (ssid == ANJAY_SSID_BOOTSTRAP) {
+        anjay_log(ERROR, "keepalives are not supported for the Bootstrap "
+                         "Server");
+        return -1;
+    }
+    if (!avs_time_duration_valid(interval)
+            || avs_time_duration_less(interval, AVS_TIME_DURATION_ZERO)) {
+        anjay_log(ERROR, "invalid keepalive interval");
+        return -1;
+    }
+
+    if (ssid == ANJAY_SSID_ANY) {
+        anjay->keepalive_interval = interval;
+        AVS_LIST_CLEAR(&anjay->keepalive_overrides);
+    } else if (set_keepalive_override(anjay, ssid, interval)) {
+        return -1;
+    }
+
+    AVS_LIST(anjay_active_server_info_t) server;
+    AVS_LIST_FOREACH(server, anjay->servers.active) {
+        if (ssid == ANJAY_SSID_ANY || server->ssid == ssid) {
+            _anjay_connection_schedule_keepalive(
+                    anjay, (anjay_connection_ref_t) {
+                        .server = server,
+                        .conn_type = ANJAY_CONNECTION_UDP
+                    });
+        }
+    }
+    return 0;
+}
+
+#ifdef ANJAY_TEST
+#include "test/keepalive.c"
+#endif // ANJAY_TEST
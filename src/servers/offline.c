@@ -25,8 +25,10 @@
 
 VISIBILITY_SOURCE_BEGIN
 
-static void disable_connection(anjay_server_connection_t *connection) {
-    _anjay_connection_internal_clean_socket(connection);
+static void disable_connection(anjay_t *anjay,
+                               anjay_server_connection_t *connection) {
+    _anjay_connection_internal_clean_socket(anjay, connection);
+    _anjay_sched_del(anjay->sched, &connection->keepalive_clb_handle);
     connection->needs_socket_update = false;
 }
 
@@ -35,8 +37,9 @@ static int enter_offline_job(anjay_t *anjay,
     (void) dummy;
     AVS_LIST(anjay_active_server_info_t) server;
     AVS_LIST_FOREACH(server, anjay->servers.active) {
-        disable_connection(&server->udp_connection);
+        disable_connection(anjay, &server->udp_connection);
         _anjay_sched_del(anjay->sched, &server->sched_update_handle);
+        _anjay_sched_del(anjay->sched, &server->sched_reconnect_handle);
     }
     _anjay_sched_del(anjay->sched, &anjay->reload_servers_sched_job_handle);
     anjay->offline = true;
@@ -55,6 +58,49 @@ int anjay_enter_offline(anjay_t *anjay) {
     return 0;
 }
 
+static int reconnect_server_job(anjay_t *anjay, void *ssid_) {
+    anjay_ssid_t ssid = (anjay_ssid_t) (uintptr_t) ssid_;
+    anjay_active_server_info_t *server =
+            _anjay_servers_find_active(&anjay->servers, ssid);
+    if (!server || anjay->offline) {
+        return 0;
+    }
+    server->udp_connection.needs_socket_update = true;
+    return _anjay_schedule_reload_servers(anjay);
+}
+
+/**
+ * Schedules reconnection of @p server after a random delay of up to
+ * anjay_t::server_reactivation_stagger, so that multiple servers (and, across
+ * a fleet, multiple clients) do not reconnect at the very same moment.
+ *
+ * @returns true if the reconnection has been deferred, false if the server
+ *          shall be reconnected immediately.
+ */
+static bool sched_staggered_reconnect(anjay_t *anjay,
+                                      anjay_active_server_info_t *server) {
+    if (!avs_time_duration_less(AVS_TIME_DURATION_ZERO,
+                                anjay->server_reactivation_stagger)) {
+        return false;
+    }
+    double stagger_s =
+            avs_time_duration_to_fscalar(anjay->server_reactivation_stagger,
+                                         AVS_TIME_S);
+    double delay_s = stagger_s * (double) _anjay_rand32(&anjay->rand_seed)
+            / 4294967296.0;
+
+    _anjay_sched_del(anjay->sched, &server->sched_reconnect_handle);
+    if (_anjay_sched(anjay->sched, &server->sched_reconnect_handle,
+                     avs_time_duration_from_fscalar(delay_s, AVS_TIME_S),
+                     reconnect_server_job,
+                     (void *) (uintptr_t) server->ssid)) {
+        anjay_log(WARNING, "could not schedule reconnection of SSID %u, "
+                           "reconnecting immediately", server->ssid);
+        return false;
+    }
+    return true;
+}
+
 static int exit_offline_job(anjay_t *anjay, void *dummy) {
     (void) dummy;
     int result = _anjay_schedule_reload_servers(anjay);
@@ -64,7 +110,9 @@ static int exit_offline_job(anjay_t *anjay, void *dummy) {
     anjay->offline = false;
     AVS_LIST(anjay_active_server_info_t) server;
     AVS_LIST_FOREACH(server, anjay->servers.active) {
-        server->udp_connection.needs_socket_update = true;
+        if (!sched_staggered_reconnect(anjay, server)) {
+            server->udp_connection.needs_socket_update = true;
+        }
     }
     return 0;
 }
@@ -167,7 +167,7 @@ schedule_update(anjay_t *anjay,
     void *update_args = send_update_args_encode(server->ssid, refresh);
 
     return _anjay_sched_retryable(anjay->sched, out_handle, delay,
-                                  ANJAY_SERVER_RETRYABLE_BACKOFF,
+                                  anjay->server_backoff,
                                   send_update_sched_job, update_args);
 }
 
@@ -32,20 +32,23 @@
 #include "connection_info.h"
 #include "register_internal.h"
 #include "servers_internal.h"
+#include "socket_map.h"
 
 VISIBILITY_SOURCE_BEGIN
 
 static void connection_cleanup(anjay_t *anjay,
                                anjay_server_connection_t *connection) {
-    _anjay_connection_internal_clean_socket(connection);
+    _anjay_connection_internal_clean_socket(anjay, connection);
     _anjay_sched_del(anjay->sched,
                      &connection->queue_mode_close_socket_clb_handle);
+    _anjay_sched_del(anjay->sched, &connection->keepalive_clb_handle);
 }
 
 void _anjay_server_cleanup(anjay_t *anjay, anjay_active_server_info_t *server) {
     anjay_log(TRACE, "clear_server SSID %u", server->ssid);
 
     _anjay_sched_del(anjay->sched, &server->sched_update_handle);
+    _anjay_sched_del(anjay->sched, &server->sched_reconnect_handle);
     _anjay_registration_info_cleanup(&server->registration_info);
     connection_cleanup(anjay, &server->udp_connection);
 }
@@ -165,18 +168,17 @@ AVS_LIST(avs_net_abstract_socket_t *const) anjay_get_sockets(anjay_t *anjay) {
     return anjay->servers.public_sockets;
 }
 
-anjay_active_server_info_t *
-_anjay_servers_find_by_udp_socket(anjay_servers_t *servers,
-                                  avs_net_abstract_socket_t *socket) {
-    AVS_LIST(anjay_active_server_info_t) it;
-    AVS_LIST_FOREACH(it, servers->active) {
-        if (_anjay_connection_internal_get_socket(&it->udp_connection)
-                == socket) {
-            return it;
-        }
+anjay_connection_ref_t
+_anjay_servers_find_by_socket(anjay_t *anjay,
+                              avs_net_abstract_socket_t *socket) {
+    const anjay_connection_ref_t *ref =
+            _anjay_socket_map_find(&anjay->server_sockets, socket);
+    if (ref) {
+        return *ref;
     }
-
-    return NULL;
+    return (anjay_connection_ref_t) {
+        .server = NULL
+    };
 }
 
 int _anjay_schedule_socket_update(anjay_t *anjay,
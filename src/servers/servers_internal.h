@@ -27,16 +27,6 @@
 
 VISIBILITY_PRIVATE_HEADER_BEGIN
 
-/**
- * Retryable job backoff configuration for retryable server jobs
- * (Register/Update).
- */
-#define ANJAY_SERVER_RETRYABLE_BACKOFF \
-    ((anjay_sched_retryable_backoff_t){ \
-        .delay = { 1, 0 }, \
-        .max_delay = { 120, 0 } \
-     })
-
 /**
  * Cleans up server data. Does not send De-Register message.
  */
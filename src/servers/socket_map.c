@@ -0,0 +1,134 @@
+/*
+ * Copyright 2017 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <config.h>
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../anjay_core.h"
+
+#define ANJAY_SERVERS_INTERNALS
+
+#include "socket_map.h"
+
+VISIBILITY_SOURCE_BEGIN
+
+#define MIN_CAPACITY 8
+
+static size_t hash_socket(const avs_net_abstract_socket_t *socket) {
+    // Fibonacci hashing; socket pointers are aligned, so their lowest bits
+    // carry no information on their own
+    return (size_t) (((uint64_t) (uintptr_t) socket
+                      * UINT64_C(0x9E3779B97F4A7C15)) >> 32);
+}
+
+static size_t find_slot(const anjay_socket_map_entry_t *entries,
+                        size_t capacity,
+                        const avs_net_abstract_socket_t *socket) {
+    assert(capacity > 0 && !(capacity & (capacity - 1)));
+    size_t index = hash_socket(socket) & (capacity - 1);
+    while (entries[index].socket && entries[index].socket != socket) {
+        index = (index + 1) & (capacity - 1);
+    }
+    return index;
+}
+
+static int resize(anjay_socket_map_t *map, size_t new_capacity) {
+    anjay_socket_map_entry_t *new_entries = (anjay_socket_map_entry_t *)
+            calloc(new_capacity, sizeof(*new_entries));
+    if (!new_entries) {
+        anjay_log(ERROR, "out of memory");
+        return -1;
+    }
+    for (size_t i = 0; i < map->capacity; ++i) {
+        if (map->entries[i].socket) {
+            new_entries[find_slot(new_entries, new_capacity,
+                                  map->entries[i].socket)] = map->entries[i];
+        }
+    }
+    free(map->entries);
+    map->entries = new_entries;
+    map->capacity = new_capacity;
+    return 0;
+}
+
+int _anjay_socket_map_insert(anjay_socket_map_t *map,
+                             avs_net_abstract_socket_t *socket,
+                             anjay_connection_ref_t ref) {
+    assert(socket);
+    // keep the load factor at most 1/2, so that probe sequences stay short
+    if (2 * (map->size + 1) > map->capacity
+            && resize(map, map->capacity ? 2 * map->capacity : MIN_CAPACITY)) {
+        return -1;
+    }
+    size_t index = find_slot(map->entries, map->capacity, socket);
+    if (!map->entries[index].socket) {
+        ++map->size;
+    }
+    map->entries[index].socket = socket;
+    map->entries[index].ref = ref;
+    return 0;
+}
+
+void _anjay_socket_map_remove(anjay_socket_map_t *map,
+                              avs_net_abstract_socket_t *socket) {
+    if (!map->capacity) {
+        return;
+    }
+    const size_t mask = map->capacity - 1;
+    size_t hole = find_slot(map->entries, map->capacity, socket);
+    if (!map->entries[hole].socket) {
+        return;
+    }
+    // backward shift deletion: move subsequent entries of the same probe run
+    // into the hole, unless that would put them before their home slot
+    size_t index = hole;
+    while (true) {
+        index = (index + 1) & mask;
+        if (!map->entries[index].socket) {
+            break;
+        }
+        size_t home = hash_socket(map->entries[index].socket) & mask;
+        if (((index - home) & mask) >= ((index - hole) & mask)) {
+            map->entries[hole] = map->entries[index];
+            hole = index;
+        }
+    }
+    memset(&map->entries[hole], 0, sizeof(map->entries[hole]));
+    --map->size;
+}
+
+const anjay_connection_ref_t *
+_anjay_socket_map_find(const anjay_socket_map_t *map,
+                       const avs_net_abstract_socket_t *socket) {
+    if (!map->capacity || !socket) {
+        return NULL;
+    }
+    const anjay_socket_map_entry_t *entry =
+            &map->entries[find_slot(map->entries, map->capacity, socket)];
+    return entry->socket ? &entry->ref : NULL;
+}
+
+void _anjay_socket_map_cleanup(anjay_socket_map_t *map) {
+    free(map->entries);
+    memset(map, 0, sizeof(*map));
+}
+
+#ifdef ANJAY_TEST
+#include "test/socket_map.c"
+#endif // ANJAY_TEST
@@ -0,0 +1,56 @@
+/*
+ * Copyright 2017 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANJAY_SERVERS_SOCKET_MAP_H
+#define ANJAY_SERVERS_SOCKET_MAP_H
+
+#include "../servers.h"
+
+#ifndef ANJAY_SERVERS_INTERNALS
+#error "Headers from servers/ are not meant to be included from outside"
+#endif
+
+VISIBILITY_PRIVATE_HEADER_BEGIN
+
+/**
+ * Associates @p socket with the server connection identified by @p ref .
+ * If @p socket is already present in the map, its entry is overwritten.
+ *
+ * @returns 0 on success, negative value if the map could not be grown.
+ */
+int _anjay_socket_map_insert(anjay_socket_map_t *map,
+                             avs_net_abstract_socket_t *socket,
+                             anjay_connection_ref_t ref);
+
+/**
+ * Removes the entry for @p socket from the map. Does nothing if there is no
+ * such entry.
+ */
+void _anjay_socket_map_remove(anjay_socket_map_t *map,
+                              avs_net_abstract_socket_t *socket);
+
+/**
+ * @returns Pointer to the connection reference associated with @p socket , or
+ *          NULL if @p socket is not present in the map. The pointer is valid
+ *          until the next modification of the map.
+ */
+const anjay_connection_ref_t *
+_anjay_socket_map_find(const anjay_socket_map_t *map,
+                       const avs_net_abstract_socket_t *socket);
+
+VISIBILITY_PRIVATE_HEADER_END
+
+#endif // ANJAY_SERVERS_SOCKET_MAP_H
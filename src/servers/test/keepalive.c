@@ -0,0 +1,234 @@
+/*
+ * Copyright 2017 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <config.h>
+
+#include <errno.h>
+
+#include <avsystem/commons/unit/test.h>
+
+#include <anjay/stats.h>
+
+#include <anjay_test/dm.h>
+
+#define KEEPALIVE_INTERVAL_S 30
+
+static const avs_time_duration_t KEEPALIVE_INTERVAL =
+        { KEEPALIVE_INTERVAL_S, 0 };
+
+static time_t sched_time_to_next_s(anjay_sched_t *sched) {
+    avs_time_duration_t sched_delay;
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_sched_time_to_next(sched, &sched_delay));
+    return sched_delay.seconds;
+}
+
+// any exchange with the server will do
+static void serve_write_attributes(anjay_t *anjay,
+                                   avs_net_abstract_socket_t *mocksock) {
+    static const char REQUEST[] =
+            "\x40\x03\xFA\x3E" // CoAP header
+            "\xB2" "42" // OID
+            "\x02" "77" // IID
+            "\x47" "pmin=69";
+    avs_unit_mocksock_input(mocksock, REQUEST, sizeof(REQUEST) - 1);
+    _anjay_mock_dm_expect_instance_present(anjay, &OBJ, 77, 1);
+    _anjay_mock_dm_expect_instance_read_default_attrs(
+            anjay, &OBJ, 77, 1, 0, &ANJAY_DM_INTERNAL_ATTRS_EMPTY);
+    _anjay_mock_dm_expect_instance_write_default_attrs(
+            anjay, &OBJ, 77, 1,
+            &(const anjay_dm_internal_attrs_t) {
+                _ANJAY_DM_CUSTOM_ATTRS_INITIALIZER
+                .standard = {
+                    .min_period = 69,
+                    .max_period = ANJAY_ATTRIB_PERIOD_NONE
+                }
+            }, 0);
+    DM_TEST_EXPECT_RESPONSE(mocksock, "\x60\x44\xFA\x3E");
+    AVS_UNIT_ASSERT_SUCCESS(anjay_serve(anjay, mocksock));
+}
+
+static int unexpected_job(anjay_t *anjay, void *arg) {
+    (void) anjay; (void) arg;
+    AVS_UNIT_ASSERT_TRUE(false);
+    return -1;
+}
+
+static void expect_ping_and_reset(avs_net_abstract_socket_t *mocksock,
+                                  uint16_t msg_id) {
+    const char ping[] = { '\x40', '\x00', (char) (msg_id >> 8),
+                          (char) msg_id };
+    const char reset[] = { '\x70', '\x00', (char) (msg_id >> 8),
+                           (char) msg_id };
+    avs_unit_mocksock_expect_output(mocksock, ping, sizeof(ping));
+    avs_unit_mocksock_input(mocksock, reset, sizeof(reset));
+}
+
+AVS_UNIT_TEST(keepalive, bytes_per_hour) {
+    DM_TEST_INIT_WITH_CONFIG(.keepalive_interval = KEEPALIVE_INTERVAL);
+    AVS_UNIT_ASSERT_NULL(
+            anjay->servers.active->udp_connection.keepalive_clb_handle);
+
+    serve_write_attributes(anjay, mocksocks[0]);
+    AVS_UNIT_ASSERT_EQUAL(sched_time_to_next_s(anjay->sched),
+                          KEEPALIVE_INTERVAL_S);
+
+    anjay_traffic_stats_t before;
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_server_stats(anjay, 1, &before));
+
+    static const size_t PINGS_PER_HOUR = 3600 / KEEPALIVE_INTERVAL_S;
+    for (size_t i = 0; i < PINGS_PER_HOUR; ++i) {
+        _anjay_mock_clock_advance(KEEPALIVE_INTERVAL);
+        expect_ping_and_reset(mocksocks[0], (uint16_t) (0x69ED + i));
+        AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+        avs_unit_mocksock_assert_expects_met(mocksocks[0]);
+        AVS_UNIT_ASSERT_EQUAL(sched_time_to_next_s(anjay->sched),
+                              KEEPALIVE_INTERVAL_S);
+    }
+
+#ifdef WITH_NET_STATS
+    anjay_traffic_stats_t after;
+    AVS_UNIT_ASSERT_SUCCESS(anjay_get_server_stats(anjay, 1, &after));
+    const uint64_t ping_bytes_per_hour = (after.tx_bytes - before.tx_bytes)
+                                         + (after.rx_bytes - before.rx_bytes);
+    AVS_UNIT_ASSERT_EQUAL(ping_bytes_per_hour, PINGS_PER_HOUR * (4 + 4));
+
+    // keeping the NAT binding open with Updates instead would take at least
+    // the smallest possible Update (no query string, no object list) and its
+    // response at the same rate; real Updates are usually much larger
+    static const char UPDATE[] =
+            "\x40\x02\x69\xED" // CoAP header
+            "\xB2" "rd" // Uri-Path
+            "\x04" "5a3f"; // Uri-Path
+    static const char UPDATE_RESPONSE[] = "\x60\x44\x69\xED";
+    const uint64_t update_bytes_per_hour =
+            PINGS_PER_HOUR
+            * ((sizeof(UPDATE) - 1) + (sizeof(UPDATE_RESPONSE) - 1));
+    AVS_UNIT_ASSERT_TRUE(2 * ping_bytes_per_hour <= update_bytes_per_hour);
+#else
+    (void) before;
+#endif // WITH_NET_STATS
+
+    DM_TEST_FINISH;
+}
+
+AVS_UNIT_TEST(keepalive, postponed_by_traffic) {
+    DM_TEST_INIT_WITH_SSIDS(1);
+    AVS_UNIT_ASSERT_SUCCESS(
+            anjay_set_server_keepalive_interval(anjay, 1, KEEPALIVE_INTERVAL));
+    AVS_UNIT_ASSERT_EQUAL(sched_time_to_next_s(anjay->sched),
+                          KEEPALIVE_INTERVAL_S);
+
+    // incoming request restarts the idle period
+    _anjay_mock_clock_advance(avs_time_duration_from_scalar(20, AVS_TIME_S));
+    serve_write_attributes(anjay, mocksocks[0]);
+    AVS_UNIT_ASSERT_EQUAL(sched_time_to_next_s(anjay->sched),
+                          KEEPALIVE_INTERVAL_S);
+
+    _anjay_mock_clock_advance(KEEPALIVE_INTERVAL);
+    expect_ping_and_reset(mocksocks[0], 0x69ED);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+    avs_unit_mocksock_assert_expects_met(mocksocks[0]);
+
+    // an Update due earlier than the keepalive makes it unnecessary
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_sched(
+            anjay->sched, &anjay->servers.active->sched_update_handle,
+            avs_time_duration_from_scalar(40, AVS_TIME_S),
+            unexpected_job, NULL));
+    _anjay_mock_clock_advance(KEEPALIVE_INTERVAL);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+    AVS_UNIT_ASSERT_NOT_NULL(
+            anjay->servers.active->udp_connection.keepalive_clb_handle);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_sched_del(
+            anjay->sched, &anjay->servers.active->sched_update_handle));
+
+    AVS_UNIT_ASSERT_SUCCESS(anjay_set_server_keepalive_interval(
+            anjay, 1, AVS_TIME_DURATION_ZERO));
+    AVS_UNIT_ASSERT_NULL(
+            anjay->servers.active->udp_connection.keepalive_clb_handle);
+
+    DM_TEST_FINISH;
+}
+
+AVS_UNIT_TEST(keepalive, not_applicable) {
+    DM_TEST_INIT_WITH_SSIDS(1);
+    AVS_UNIT_ASSERT_FAILED(anjay_set_server_keepalive_interval(
+            anjay, ANJAY_SSID_BOOTSTRAP, KEEPALIVE_INTERVAL));
+    AVS_UNIT_ASSERT_FAILED(anjay_set_server_keepalive_interval(
+            anjay, 1, avs_time_duration_from_scalar(-1, AVS_TIME_S)));
+
+    anjay->servers.active->udp_connection.queue_mode = true;
+    AVS_UNIT_ASSERT_SUCCESS(anjay_set_server_keepalive_interval(
+            anjay, ANJAY_SSID_ANY, KEEPALIVE_INTERVAL));
+    AVS_UNIT_ASSERT_NULL(
+            anjay->servers.active->udp_connection.keepalive_clb_handle);
+
+    DM_TEST_FINISH;
+}
+
+static void assert_reconnect_scheduled(anjay_t *anjay) {
+    const anjay_connection_ref_t ref = {
+        .server = anjay->servers.active,
+        .conn_type = ANJAY_CONNECTION_UDP
+    };
+    AVS_UNIT_ASSERT_FALSE(_anjay_connection_is_online(ref));
+
+    // reconnection is performed by the Update job, which is due immediately
+    avs_time_duration_t until_update;
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_sched_time_to_job(
+            anjay->sched, anjay->servers.active->sched_update_handle,
+            &until_update));
+    AVS_UNIT_ASSERT_EQUAL(until_update.seconds, 0);
+}
+
+AVS_UNIT_TEST(keepalive, send_failure_triggers_reconnect) {
+    DM_TEST_INIT_WITH_SSIDS(1);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_set_server_keepalive_interval(
+            anjay, ANJAY_SSID_ANY, KEEPALIVE_INTERVAL));
+
+    _anjay_mock_clock_advance(KEEPALIVE_INTERVAL);
+    avs_unit_mocksock_output_fail(mocksocks[0], -1);
+    avs_unit_mocksock_expect_errno(mocksocks[0], ETIMEDOUT);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+    assert_reconnect_scheduled(anjay);
+
+    DM_TEST_FINISH;
+}
+
+AVS_UNIT_TEST(keepalive, ping_timeout_triggers_reconnect) {
+    DM_TEST_INIT_WITH_SSIDS(1);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_set_server_keepalive_interval(
+            anjay, ANJAY_SSID_ANY, KEEPALIVE_INTERVAL));
+
+    // the ping is sent and retransmitted as any Confirmable message, and the
+    // connection is only considered dead after the last retransmission is
+    // left unanswered, too
+    static const char PING[] = "\x40\x00\x69\xED";
+    const avs_coap_tx_params_t tx_params =
+            (avs_coap_tx_params_t) ANJAY_COAP_DEFAULT_UDP_TX_PARAMS;
+    _anjay_mock_clock_advance(KEEPALIVE_INTERVAL);
+    for (unsigned i = 0; i <= tx_params.max_retransmit; ++i) {
+        avs_unit_mocksock_expect_output(mocksocks[0], PING, sizeof(PING) - 1);
+        avs_unit_mocksock_input_fail(mocksocks[0], -1);
+        // checked by both the CoAP context and the input buffer
+        avs_unit_mocksock_expect_errno(mocksocks[0], ETIMEDOUT);
+        avs_unit_mocksock_expect_errno(mocksocks[0], ETIMEDOUT);
+    }
+    AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+    avs_unit_mocksock_assert_expects_met(mocksocks[0]);
+    assert_reconnect_scheduled(anjay);
+
+    DM_TEST_FINISH;
+}
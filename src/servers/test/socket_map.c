@@ -0,0 +1,114 @@
+/*
+ * Copyright 2017 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <config.h>
+
+#include <avsystem/commons/unit/test.h>
+
+#define NUM_FAKE_SOCKETS 100
+
+// the map only ever compares socket pointers, so any distinct addresses will do
+static avs_net_abstract_socket_t *fake_socket(size_t index) {
+    static uint64_t storage[NUM_FAKE_SOCKETS];
+    return (avs_net_abstract_socket_t *) &storage[index];
+}
+
+static anjay_active_server_info_t *fake_server(size_t index) {
+    static anjay_active_server_info_t servers[NUM_FAKE_SOCKETS];
+    return &servers[index];
+}
+
+static void assert_mapped(const anjay_socket_map_t *map, size_t index) {
+    const anjay_connection_ref_t *ref =
+            _anjay_socket_map_find(map, fake_socket(index));
+    AVS_UNIT_ASSERT_NOT_NULL(ref);
+    AVS_UNIT_ASSERT_TRUE(ref->server == fake_server(index));
+    AVS_UNIT_ASSERT_EQUAL(ref->conn_type, ANJAY_CONNECTION_UDP);
+}
+
+static void insert(anjay_socket_map_t *map, size_t index) {
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_socket_map_insert(
+            map, fake_socket(index),
+            (anjay_connection_ref_t) {
+                .server = fake_server(index),
+                .conn_type = ANJAY_CONNECTION_UDP
+            }));
+}
+
+AVS_UNIT_TEST(socket_map, empty) {
+    anjay_socket_map_t map = { NULL, 0, 0 };
+    AVS_UNIT_ASSERT_NULL(_anjay_socket_map_find(&map, fake_socket(0)));
+    AVS_UNIT_ASSERT_NULL(_anjay_socket_map_find(&map, NULL));
+    _anjay_socket_map_remove(&map, fake_socket(0));
+    AVS_UNIT_ASSERT_EQUAL(map.size, 0);
+    _anjay_socket_map_cleanup(&map);
+}
+
+AVS_UNIT_TEST(socket_map, insert_overwrites) {
+    anjay_socket_map_t map = { NULL, 0, 0 };
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_socket_map_insert(
+            &map, fake_socket(0),
+            (anjay_connection_ref_t) {
+                .server = fake_server(1),
+                .conn_type = ANJAY_CONNECTION_UDP
+            }));
+    insert(&map, 0);
+    AVS_UNIT_ASSERT_EQUAL(map.size, 1);
+    assert_mapped(&map, 0);
+    _anjay_socket_map_cleanup(&map);
+}
+
+AVS_UNIT_TEST(socket_map, grow_and_remove) {
+    anjay_socket_map_t map = { NULL, 0, 0 };
+    for (size_t i = 0; i < NUM_FAKE_SOCKETS; ++i) {
+        insert(&map, i);
+        AVS_UNIT_ASSERT_EQUAL(map.size, i + 1);
+        AVS_UNIT_ASSERT_TRUE(2 * map.size <= map.capacity);
+    }
+    for (size_t i = 0; i < NUM_FAKE_SOCKETS; ++i) {
+        assert_mapped(&map, i);
+    }
+
+    // remove every third entry; all the others must still be reachable
+    for (size_t i = 0; i < NUM_FAKE_SOCKETS; i += 3) {
+        _anjay_socket_map_remove(&map, fake_socket(i));
+    }
+    for (size_t i = 0; i < NUM_FAKE_SOCKETS; ++i) {
+        if (i % 3) {
+            assert_mapped(&map, i);
+        } else {
+            AVS_UNIT_ASSERT_NULL(_anjay_socket_map_find(&map, fake_socket(i)));
+        }
+    }
+    AVS_UNIT_ASSERT_EQUAL(map.size,
+                          NUM_FAKE_SOCKETS - (NUM_FAKE_SOCKETS + 2) / 3);
+
+    // removing a missing entry is a no-op
+    size_t size_before = map.size;
+    _anjay_socket_map_remove(&map, fake_socket(0));
+    AVS_UNIT_ASSERT_EQUAL(map.size, size_before);
+
+    for (size_t i = 0; i < NUM_FAKE_SOCKETS; ++i) {
+        if (i % 3) {
+            _anjay_socket_map_remove(&map, fake_socket(i));
+        }
+    }
+    AVS_UNIT_ASSERT_EQUAL(map.size, 0);
+    for (size_t i = 0; i < map.capacity; ++i) {
+        AVS_UNIT_ASSERT_NULL(map.entries[i].socket);
+    }
+    _anjay_socket_map_cleanup(&map);
+}
@@ -130,6 +130,24 @@ AVS_UNIT_TEST(parse_headers, parse_attribute) {
     TEST_PARSE_ATTRIBUTE_FAIL("st", "moo");
     TEST_PARSE_ATTRIBUTE_FAIL("st", "");
 
+#ifdef WITH_EVAL_PERIOD_ATTRS
+    TEST_PARSE_ATTRIBUTE_SUCCESS("epmin", "12", custom.data.min_eval_period,
+                                 custom.has_min_eval_period, 12);
+    TEST_PARSE_ATTRIBUTE_SUCCESS("epmin", NULL, custom.data.min_eval_period,
+                                 custom.has_min_eval_period, -1);
+    TEST_PARSE_ATTRIBUTE_FAIL("epmin", "-12");
+    TEST_PARSE_ATTRIBUTE_FAIL("epmin", "quack");
+    TEST_PARSE_ATTRIBUTE_FAIL("epmin", "");
+
+    TEST_PARSE_ATTRIBUTE_SUCCESS("epmax", "34", custom.data.max_eval_period,
+                                 custom.has_max_eval_period, 34);
+    TEST_PARSE_ATTRIBUTE_SUCCESS("epmax", NULL, custom.data.max_eval_period,
+                                 custom.has_max_eval_period, -1);
+    TEST_PARSE_ATTRIBUTE_FAIL("epmax", "34.5");
+    TEST_PARSE_ATTRIBUTE_FAIL("epmax", "oink");
+    TEST_PARSE_ATTRIBUTE_FAIL("epmax", "");
+#endif // WITH_EVAL_PERIOD_ATTRS
+
     TEST_PARSE_ATTRIBUTE_FAIL("unknown", "wa-pa-pa-pa-pa-pa-pow");
     TEST_PARSE_ATTRIBUTE_FAIL("unknown", NULL);
     TEST_PARSE_ATTRIBUTE_FAIL("unknown", "");
@@ -142,6 +160,10 @@ AVS_UNIT_TEST(parse_headers, parse_attribute) {
     do { \
         AVS_UNIT_ASSERT_EQUAL(actual.custom.data.con, \
                               expected.custom.data.con); \
+        AVS_UNIT_ASSERT_EQUAL(actual.custom.data.min_eval_period, \
+                              expected.custom.data.min_eval_period); \
+        AVS_UNIT_ASSERT_EQUAL(actual.custom.data.max_eval_period, \
+                              expected.custom.data.max_eval_period); \
         AVS_UNIT_ASSERT_EQUAL(actual.standard.common.min_period, \
                               expected.standard.common.min_period); \
         AVS_UNIT_ASSERT_EQUAL(actual.standard.common.max_period, \
@@ -162,6 +184,10 @@ AVS_UNIT_TEST(parse_headers, parse_attribute) {
         AVS_UNIT_ASSERT_EQUAL(actual.has_less_than, expected.has_less_than); \
         AVS_UNIT_ASSERT_EQUAL(actual.has_step, expected.has_step); \
         AVS_UNIT_ASSERT_EQUAL(actual.custom.has_con, expected.custom.has_con); \
+        AVS_UNIT_ASSERT_EQUAL(actual.custom.has_min_eval_period, \
+                              expected.custom.has_min_eval_period); \
+        AVS_UNIT_ASSERT_EQUAL(actual.custom.has_max_eval_period, \
+                              expected.custom.has_max_eval_period); \
         ASSERT_ATTRIBUTE_VALUES_EQUAL(actual.values, expected.values); \
     } while (0)
 
@@ -606,6 +632,81 @@ AVS_UNIT_TEST(queue_mode, behaviour) {
     DM_TEST_FINISH;
 }
 
+static int dummy_update_job(anjay_t *anjay, void *arg) {
+    (void) anjay; (void) arg;
+    return 0;
+}
+
+static time_t update_delay_s(anjay_t *anjay,
+                             anjay_active_server_info_t *server) {
+    avs_time_duration_t delay;
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_sched_time_to_job(
+            anjay->sched, server->sched_update_handle, &delay));
+    return delay.seconds;
+}
+
+AVS_UNIT_TEST(queue_mode, wakeups_aligned_across_servers) {
+    DM_TEST_INIT_GENERIC((DM_TEST_DEFAULT_OBJECTS), (1, 2),
+                         (.queue_mode_wakeup_slack = { 5, 0 }));
+    anjay_active_server_info_t *server1 =
+            _anjay_servers_find_active(&anjay->servers, 1);
+    anjay_active_server_info_t *server2 =
+            _anjay_servers_find_active(&anjay->servers, 2);
+    AVS_UNIT_ASSERT_NOT_NULL(server1);
+    AVS_UNIT_ASSERT_NOT_NULL(server2);
+    server1->udp_connection.queue_mode = true;
+    server2->udp_connection.queue_mode = true;
+
+    _anjay_sched_del(anjay->sched, &server1->sched_update_handle);
+    _anjay_sched_del(anjay->sched, &server2->sched_update_handle);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_sched(
+            anjay->sched, &server1->sched_update_handle,
+            avs_time_duration_from_scalar(60, AVS_TIME_S), dummy_update_job,
+            NULL));
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_sched(
+            anjay->sched, &server2->sched_update_handle,
+            avs_time_duration_from_scalar(3, AVS_TIME_S), dummy_update_job,
+            NULL));
+    AVS_UNIT_ASSERT_EQUAL(anjay_get_num_queue_mode_wakeups(anjay), 0);
+
+    ////// WAKE-UP FOR SERVER 1 //////
+    // Update of server 2, due within the slack, is brought along; the one of
+    // server 1 itself is too far in the future
+    const anjay_connection_ref_t ref1 = {
+        .server = server1,
+        .conn_type = ANJAY_CONNECTION_UDP
+    };
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_bind_server_stream(anjay, ref1));
+    AVS_UNIT_ASSERT_EQUAL(anjay_get_num_queue_mode_wakeups(anjay), 1);
+    AVS_UNIT_ASSERT_EQUAL(update_delay_s(anjay, server2), 0);
+    AVS_UNIT_ASSERT_EQUAL(update_delay_s(anjay, server1), 60);
+    _anjay_release_server_stream(anjay);
+    AVS_UNIT_ASSERT_NOT_NULL(
+            server1->udp_connection.queue_mode_close_socket_clb_handle);
+
+    ////// SERVER 2 HANDLED WITHIN THE SAME WAKE-UP //////
+    const anjay_connection_ref_t ref2 = {
+        .server = server2,
+        .conn_type = ANJAY_CONNECTION_UDP
+    };
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_bind_server_stream(anjay, ref2));
+    AVS_UNIT_ASSERT_EQUAL(anjay_get_num_queue_mode_wakeups(anjay), 1);
+    _anjay_release_server_stream(anjay);
+
+    ////// BOTH SUSPENDED - NEXT ACTIVITY IS A SEPARATE WAKE-UP //////
+    _anjay_sched_del(
+            anjay->sched,
+            &server1->udp_connection.queue_mode_close_socket_clb_handle);
+    _anjay_sched_del(
+            anjay->sched,
+            &server2->udp_connection.queue_mode_close_socket_clb_handle);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_bind_server_stream(anjay, ref1));
+    AVS_UNIT_ASSERT_EQUAL(anjay_get_num_queue_mode_wakeups(anjay), 2);
+    _anjay_release_server_stream(anjay);
+
+    DM_TEST_FINISH;
+}
+
 AVS_UNIT_TEST(queue_mode, change) {
     DM_TEST_INIT_WITH_OBJECTS(&OBJ, &FAKE_SECURITY2, &FAKE_SERVER);
     ////// WRITE NEW BINDING //////
@@ -720,3 +821,50 @@ AVS_UNIT_TEST(queue_mode, change) {
 
     DM_TEST_FINISH;
 }
+
+AVS_UNIT_TEST(anjay_serve, many_servers) {
+    DM_TEST_INIT_WITH_SSIDS(1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+                            16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28,
+                            29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40, 41,
+                            42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 52, 53, 54,
+                            55, 56, 57, 58, 59, 60, 61, 62, 63, 64);
+    AVS_UNIT_ASSERT_EQUAL(AVS_ARRAY_SIZE(mocksocks), 64);
+    for (size_t i = 0; i < AVS_ARRAY_SIZE(mocksocks); ++i) {
+        anjay_connection_ref_t ref =
+                _anjay_servers_find_by_socket(anjay, mocksocks[i]);
+        AVS_UNIT_ASSERT_NOT_NULL(ref.server);
+        AVS_UNIT_ASSERT_EQUAL(ref.server->ssid, ssids[i]);
+        AVS_UNIT_ASSERT_EQUAL(ref.conn_type, ANJAY_CONNECTION_UDP);
+    }
+
+    static const size_t SERVED[] = { 0, 17, 42, 63 };
+    for (size_t i = 0; i < AVS_ARRAY_SIZE(SERVED); ++i) {
+        const size_t index = SERVED[i];
+        char request[] = "\x40\x03\xFA\x00" // CoAP header
+                         "\xB2" "42" // OID
+                         "\x02" "77" // IID
+                         "\x47" "pmin=69";
+        char response[] = "\x60\x44\xFA\x00";
+        request[3] = response[3] = (char) index;
+        avs_unit_mocksock_input(mocksocks[index], request, sizeof(request) - 1);
+        _anjay_mock_dm_expect_instance_present(anjay, &OBJ, 77, 1);
+        _anjay_mock_dm_expect_instance_read_default_attrs(
+                anjay, &OBJ, 77, ssids[index], 0,
+                &ANJAY_DM_INTERNAL_ATTRS_EMPTY);
+        _anjay_mock_dm_expect_instance_write_default_attrs(
+                anjay, &OBJ, 77, ssids[index],
+                &(const anjay_dm_internal_attrs_t) {
+                    _ANJAY_DM_CUSTOM_ATTRS_INITIALIZER
+                    .standard = {
+                        .min_period = 69,
+                        .max_period = ANJAY_ATTRIB_PERIOD_NONE
+                    }
+                }, 0);
+        avs_unit_mocksock_expect_output(mocksocks[index], response,
+                                        sizeof(response) - 1);
+        AVS_UNIT_ASSERT_SUCCESS(anjay_serve(anjay, mocksocks[index]));
+    }
+
+    AVS_UNIT_ASSERT_NULL(_anjay_servers_find_by_socket(anjay, NULL).server);
+    DM_TEST_FINISH;
+}
@@ -21,6 +21,8 @@
 #include <avsystem/commons/unit/mocksock.h>
 #include <avsystem/commons/unit/test.h>
 
+#include <anjay_modules/dm/modules.h>
+
 #include <anjay_test/dm.h>
 
 #include "../anjay_core.h"
@@ -342,6 +344,205 @@ AVS_UNIT_TEST(dm_read, no_object) {
     DM_TEST_FINISH;
 }
 
+static const anjay_dm_object_def_t *const OBJ_WITH_READ_CACHE =
+        &(const anjay_dm_object_def_t) {
+            .oid = 42,
+            .supported_rids = ANJAY_DM_SUPPORTED_RIDS(0, 1, 2, 3, 4, 5, 6),
+            .handlers = {
+                ANJAY_MOCK_DM_HANDLERS,
+                .instance_reset = _anjay_mock_dm_instance_reset
+            },
+            .read_cache_ttl = { 10, 0 }
+        };
+
+static void serve_cached_read_rid(anjay_t *anjay,
+                                  avs_net_abstract_socket_t *mocksock,
+                                  anjay_rid_t rid,
+                                  uint8_t msg_id,
+                                  const anjay_mock_dm_data_t *handler_data,
+                                  const char *response) {
+    assert(rid < 10);
+    const char request[] = {
+        '\x40', '\x01', '\xFA', (char) msg_id, // CoAP header
+        '\xB2', '4', '2', // OID
+        '\x02', '6', '9', // IID
+        '\x01', (char) ('0' + rid) // RID
+    };
+    avs_unit_mocksock_input(mocksock, request, sizeof(request));
+    _anjay_mock_dm_expect_instance_present(anjay, &OBJ_WITH_READ_CACHE, 69, 1);
+    _anjay_mock_dm_expect_resource_present(anjay, &OBJ_WITH_READ_CACHE, 69, rid,
+                                           1);
+    if (handler_data) {
+        _anjay_mock_dm_expect_resource_read(anjay, &OBJ_WITH_READ_CACHE, 69,
+                                            rid, 0, handler_data);
+    }
+    const char response_header[] = {
+        '\x60', '\x45', '\xFA', (char) msg_id, // CoAP header
+        '\xC0', // Content-Format
+        '\xFF'
+    };
+    char expected[64];
+    memcpy(expected, response_header, sizeof(response_header));
+    memcpy(expected + sizeof(response_header), response, strlen(response));
+    avs_unit_mocksock_expect_output(mocksock, expected,
+                                    sizeof(response_header) + strlen(response));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_serve(anjay, mocksock));
+}
+
+static void serve_cached_read(anjay_t *anjay,
+                              avs_net_abstract_socket_t *mocksock,
+                              uint8_t msg_id,
+                              const anjay_mock_dm_data_t *handler_data,
+                              const char *response) {
+    serve_cached_read_rid(anjay, mocksock, 4, msg_id, handler_data, response);
+}
+
+AVS_UNIT_TEST(dm_read, cached_resource) {
+    DM_TEST_INIT_WITH_OBJECTS(&OBJ_WITH_READ_CACHE, &FAKE_SECURITY,
+                              &FAKE_SERVER);
+    serve_cached_read(anjay, mocksocks[0], 0x01, ANJAY_MOCK_DM_INT(0, 514),
+                      "514");
+    // handler not called within the TTL
+    _anjay_mock_clock_advance(avs_time_duration_from_scalar(9, AVS_TIME_S));
+    serve_cached_read(anjay, mocksocks[0], 0x02, NULL, "514");
+
+    // reported change invalidates the cached value immediately
+    AVS_UNIT_ASSERT_SUCCESS(anjay_notify_changed(anjay, 42, 69, 4));
+    serve_cached_read(anjay, mocksocks[0], 0x03, ANJAY_MOCK_DM_INT(0, 515),
+                      "515");
+    AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+    serve_cached_read(anjay, mocksocks[0], 0x04, NULL, "515");
+
+    // cached value expires after the TTL
+    _anjay_mock_clock_advance(avs_time_duration_from_scalar(10, AVS_TIME_S));
+    serve_cached_read(anjay, mocksocks[0], 0x05, ANJAY_MOCK_DM_INT(0, 516),
+                      "516");
+
+    // errors are not cached
+    _anjay_mock_clock_advance(avs_time_duration_from_scalar(10, AVS_TIME_S));
+    static const char REQUEST[] =
+            "\x40\x01\xFA\x06" // CoAP header
+            "\xB2" "42" // OID
+            "\x02" "69" // IID
+            "\x01" "4"; // RID
+    avs_unit_mocksock_input(mocksocks[0], REQUEST, sizeof(REQUEST) - 1);
+    _anjay_mock_dm_expect_instance_present(anjay, &OBJ_WITH_READ_CACHE, 69, 1);
+    _anjay_mock_dm_expect_resource_present(anjay, &OBJ_WITH_READ_CACHE, 69, 4,
+                                           1);
+    _anjay_mock_dm_expect_resource_read(anjay, &OBJ_WITH_READ_CACHE, 69, 4,
+                                        ANJAY_ERR_INTERNAL, ANJAY_MOCK_DM_NONE);
+    DM_TEST_EXPECT_RESPONSE(mocksocks[0], "\x60\xA0\xFA\x06");
+    AVS_UNIT_ASSERT_FAILED(anjay_serve(anjay, mocksocks[0]));
+    serve_cached_read(anjay, mocksocks[0], 0x07, ANJAY_MOCK_DM_INT(0, 517),
+                      "517");
+    DM_TEST_FINISH;
+}
+
+AVS_UNIT_TEST(dm_read, cache_pruned_of_expired_entries) {
+    DM_TEST_INIT_WITH_OBJECTS(&OBJ_WITH_READ_CACHE, &FAKE_SECURITY,
+                              &FAKE_SERVER);
+    serve_cached_read_rid(anjay, mocksocks[0], 4, 0x01,
+                          ANJAY_MOCK_DM_INT(0, 514), "514");
+    _anjay_mock_clock_advance(avs_time_duration_from_scalar(5, AVS_TIME_S));
+    serve_cached_read_rid(anjay, mocksocks[0], 5, 0x02,
+                          ANJAY_MOCK_DM_INT(0, 42), "42");
+    AVS_UNIT_ASSERT_EQUAL(AVS_LIST_SIZE(anjay->dm.read_cache), 2);
+
+    // /42/69/4 is never read again, but its expired value is dropped anyway
+    _anjay_mock_clock_advance(avs_time_duration_from_scalar(6, AVS_TIME_S));
+    serve_cached_read_rid(anjay, mocksocks[0], 5, 0x03, NULL, "42");
+    AVS_UNIT_ASSERT_EQUAL(AVS_LIST_SIZE(anjay->dm.read_cache), 1);
+    DM_TEST_FINISH;
+}
+
+AVS_UNIT_TEST(dm_read, cached_array_invalidated_by_write) {
+    DM_TEST_INIT_WITH_OBJECTS(&OBJ_WITH_READ_CACHE, &FAKE_SECURITY,
+                              &FAKE_SERVER);
+#define READ_REQUEST(MsgId) \
+        "\x40\x01\xFA" MsgId /* CoAP header */ \
+        "\xB2" "42" /* OID */ \
+        "\x02" "69" /* IID */ \
+        "\x01" "4" /* RID */
+#define READ_RESPONSE(MsgId) \
+        "\x60\x45\xFA" MsgId /* CoAP header */ \
+        "\xC2\x2d\x16" /* Content-Format */ \
+        "\xFF" \
+        "\x88\x04\x09" \
+        "\x42\x04\x03\x09" \
+        "\x43\x07" "Hi!"
+    static const char FIRST_READ_REQUEST[] = READ_REQUEST("\x3E");
+    avs_unit_mocksock_input(mocksocks[0], FIRST_READ_REQUEST,
+                            sizeof(FIRST_READ_REQUEST) - 1);
+    _anjay_mock_dm_expect_instance_present(anjay, &OBJ_WITH_READ_CACHE, 69, 1);
+    _anjay_mock_dm_expect_resource_present(anjay, &OBJ_WITH_READ_CACHE, 69, 4,
+                                           1);
+    _anjay_mock_dm_expect_resource_read(anjay, &OBJ_WITH_READ_CACHE, 69, 4, 0,
+            ANJAY_MOCK_DM_ARRAY(0,
+                ANJAY_MOCK_DM_ARRAY_ENTRY(4, ANJAY_MOCK_DM_INT(0, 777)),
+                ANJAY_MOCK_DM_ARRAY_ENTRY(7, ANJAY_MOCK_DM_STRING(0, "Hi!"))));
+    DM_TEST_EXPECT_RESPONSE(mocksocks[0], READ_RESPONSE("\x3E"));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_serve(anjay, mocksocks[0]));
+
+    // served from the cache in the same shape
+    static const char SECOND_READ_REQUEST[] = READ_REQUEST("\x3F");
+    avs_unit_mocksock_input(mocksocks[0], SECOND_READ_REQUEST,
+                            sizeof(SECOND_READ_REQUEST) - 1);
+    _anjay_mock_dm_expect_instance_present(anjay, &OBJ_WITH_READ_CACHE, 69, 1);
+    _anjay_mock_dm_expect_resource_present(anjay, &OBJ_WITH_READ_CACHE, 69, 4,
+                                           1);
+    DM_TEST_EXPECT_RESPONSE(mocksocks[0], READ_RESPONSE("\x3F"));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_serve(anjay, mocksocks[0]));
+#undef READ_RESPONSE
+#undef READ_REQUEST
+
+    static const char WRITE_REQUEST[] =
+            "\x40\x03\xFA\x40" // CoAP header
+            "\xB2" "42" // OID
+            "\x02" "69" // IID
+            "\x01" "4" // RID
+            "\x10" // Content-Format
+            "\xFF"
+            "Hello";
+    avs_unit_mocksock_input(mocksocks[0], WRITE_REQUEST,
+                            sizeof(WRITE_REQUEST) - 1);
+    _anjay_mock_dm_expect_instance_present(anjay, &OBJ_WITH_READ_CACHE, 69, 1);
+    _anjay_mock_dm_expect_resource_write(anjay, &OBJ_WITH_READ_CACHE, 69, 4,
+                                         ANJAY_MOCK_DM_STRING(0, "Hello"), 0);
+    DM_TEST_EXPECT_RESPONSE(mocksocks[0], "\x60\x44\xFA\x40");
+    AVS_UNIT_ASSERT_SUCCESS(anjay_serve(anjay, mocksocks[0]));
+
+    serve_cached_read(anjay, mocksocks[0], 0x41,
+                      ANJAY_MOCK_DM_STRING(0, "Hello"), "Hello");
+    DM_TEST_FINISH;
+}
+
+AVS_UNIT_TEST(dm_read, cached_instance_invalidated_by_replace) {
+    DM_TEST_INIT_WITH_OBJECTS(&OBJ_WITH_READ_CACHE, &FAKE_SECURITY,
+                              &FAKE_SERVER);
+    serve_cached_read(anjay, mocksocks[0], 0x01, ANJAY_MOCK_DM_INT(0, 514),
+                      "514");
+
+    // /42/69/4 is not written, but is reset by the Replace
+    static const char REQUEST[] =
+            "\x40\x03\xFA\x02" // CoAP header
+            "\xB2" "42" // OID
+            "\x02" "69" // IID
+            "\x12\x2d\x16" // Content-Format
+            "\xFF"
+            "\xc1\x00\x0d";
+    avs_unit_mocksock_input(mocksocks[0], REQUEST, sizeof(REQUEST) - 1);
+    _anjay_mock_dm_expect_instance_present(anjay, &OBJ_WITH_READ_CACHE, 69, 1);
+    _anjay_mock_dm_expect_instance_reset(anjay, &OBJ_WITH_READ_CACHE, 69, 0);
+    _anjay_mock_dm_expect_resource_write(anjay, &OBJ_WITH_READ_CACHE, 69, 0,
+                                         ANJAY_MOCK_DM_INT(0, 13), 0);
+    DM_TEST_EXPECT_RESPONSE(mocksocks[0], "\x60\x44\xFA\x02");
+    AVS_UNIT_ASSERT_SUCCESS(anjay_serve(anjay, mocksocks[0]));
+
+    serve_cached_read(anjay, mocksocks[0], 0x03, ANJAY_MOCK_DM_INT(0, 0),
+                      "0");
+    DM_TEST_FINISH;
+}
+
 AVS_UNIT_TEST(dm_read_accept, force_tlv) {
     DM_TEST_INIT;
     static const char REQUEST[] =
@@ -1841,6 +2042,190 @@ AVS_UNIT_TEST(dm_delete, failure) {
     DM_TEST_FINISH;
 }
 
+typedef struct {
+    avs_net_abstract_socket_t *mocksock;
+    int calls;
+} notify_order_ctx_t;
+
+static int notify_order_clb(anjay_t *anjay,
+                            anjay_notify_queue_t queue,
+                            void *ctx_) {
+    (void) anjay;
+    notify_order_ctx_t *ctx = (notify_order_ctx_t *) ctx_;
+    // the response must have been sent before any notification is processed
+    avs_unit_mocksock_assert_expects_met(ctx->mocksock);
+    AVS_UNIT_ASSERT_NOT_NULL(queue);
+    AVS_UNIT_ASSERT_EQUAL(queue->oid, 42);
+    ++ctx->calls;
+    return 0;
+}
+
+static const anjay_dm_module_t NOTIFY_ORDER_MODULE = {
+    .notify_callback = notify_order_clb
+};
+
+AVS_UNIT_TEST(dm_notify_after_response, write) {
+    DM_TEST_INIT;
+    notify_order_ctx_t ctx = {
+        .mocksock = mocksocks[0]
+    };
+    AVS_UNIT_ASSERT_SUCCESS(
+            _anjay_dm_module_install(anjay, &NOTIFY_ORDER_MODULE, &ctx));
+    static const char REQUEST[] =
+            "\x40\x03\xFA\x3E" // CoAP header
+            "\xB2" "42" // OID
+            "\x03" "514" // IID
+            "\x01" "4" // RID
+            "\x10" // Content-Format
+            "\xFF"
+            "Hello";
+    avs_unit_mocksock_input(mocksocks[0], REQUEST, sizeof(REQUEST) - 1);
+    _anjay_mock_dm_expect_instance_present(anjay, &OBJ, 514, 1);
+    _anjay_mock_dm_expect_resource_write(anjay, &OBJ, 514, 4,
+                                         ANJAY_MOCK_DM_STRING(0, "Hello"), 0);
+    DM_TEST_EXPECT_RESPONSE(mocksocks[0], "\x60\x44\xFA\x3E");
+    AVS_UNIT_ASSERT_SUCCESS(anjay_serve(anjay, mocksocks[0]));
+    AVS_UNIT_ASSERT_EQUAL(ctx.calls, 1);
+    AVS_UNIT_ASSERT_NULL(anjay->request_notify_queue);
+    DM_TEST_FINISH;
+}
+
+AVS_UNIT_TEST(dm_notify_after_response, delete) {
+    DM_TEST_INIT;
+    notify_order_ctx_t ctx = {
+        .mocksock = mocksocks[0]
+    };
+    AVS_UNIT_ASSERT_SUCCESS(
+            _anjay_dm_module_install(anjay, &NOTIFY_ORDER_MODULE, &ctx));
+    static const char REQUEST[] =
+            "\x40\x04\xFA\x3E" // CoAP header
+            "\xB2" "42" // OID
+            "\x02" "34"; // IID
+    avs_unit_mocksock_input(mocksocks[0], REQUEST, sizeof(REQUEST) - 1);
+    _anjay_mock_dm_expect_instance_present(anjay, &OBJ, 34, 1);
+    _anjay_mock_dm_expect_instance_remove(anjay, &OBJ, 34, 0);
+    DM_TEST_EXPECT_RESPONSE(mocksocks[0], "\x60\x42\xfa\x3e");
+    AVS_UNIT_ASSERT_SUCCESS(anjay_serve(anjay, mocksocks[0]));
+    AVS_UNIT_ASSERT_EQUAL(ctx.calls, 1);
+    DM_TEST_FINISH;
+}
+
+AVS_UNIT_TEST(dm_notify_after_response, failed_delete_does_not_notify) {
+    DM_TEST_INIT;
+    notify_order_ctx_t ctx = {
+        .mocksock = mocksocks[0]
+    };
+    AVS_UNIT_ASSERT_SUCCESS(
+            _anjay_dm_module_install(anjay, &NOTIFY_ORDER_MODULE, &ctx));
+    static const char REQUEST[] =
+            "\x40\x04\xFA\x3E" // CoAP header
+            "\xB2" "42" // OID
+            "\x02" "84"; // IID
+    avs_unit_mocksock_input(mocksocks[0], REQUEST, sizeof(REQUEST) - 1);
+    _anjay_mock_dm_expect_instance_present(anjay, &OBJ, 84, 1);
+    _anjay_mock_dm_expect_instance_remove(anjay, &OBJ, 84, ANJAY_ERR_INTERNAL);
+    DM_TEST_EXPECT_RESPONSE(mocksocks[0], "\x60\xa0\xfa\x3e");
+    AVS_UNIT_ASSERT_FAILED(anjay_serve(anjay, mocksocks[0]));
+    AVS_UNIT_ASSERT_EQUAL(ctx.calls, 0);
+    DM_TEST_FINISH;
+}
+
+typedef struct {
+    int calls;
+    anjay_oid_t oids[4];
+    size_t num_oids;
+} notify_interest_ctx_t;
+
+static int notify_interest_clb(anjay_t *anjay,
+                               anjay_notify_queue_t queue,
+                               void *ctx_) {
+    (void) anjay;
+    notify_interest_ctx_t *ctx = (notify_interest_ctx_t *) ctx_;
+    ++ctx->calls;
+    ctx->num_oids = 0;
+    AVS_LIST(anjay_notify_queue_object_entry_t) it;
+    AVS_LIST_FOREACH(it, queue) {
+        AVS_UNIT_ASSERT_TRUE(ctx->num_oids < AVS_ARRAY_SIZE(ctx->oids));
+        ctx->oids[ctx->num_oids++] = it->oid;
+    }
+    return 0;
+}
+
+static const anjay_oid_t INTERESTING_OIDS[] = { 42, 44 };
+
+static const anjay_dm_module_t OID_INTEREST_MODULE = {
+    .notify_callback = notify_interest_clb,
+    .notify_interest = {
+        .oids = INTERESTING_OIDS,
+        .num_oids = AVS_ARRAY_SIZE(INTERESTING_OIDS)
+    }
+};
+
+static const anjay_dm_module_t INSTANCE_SET_INTEREST_MODULE = {
+    .notify_callback = notify_interest_clb,
+    .notify_interest = {
+        .instance_set_changes_only = true
+    }
+};
+
+AVS_UNIT_TEST(dm_notify_interest, oids) {
+    DM_TEST_INIT;
+    notify_interest_ctx_t ctx = { 0 };
+    AVS_UNIT_ASSERT_SUCCESS(
+            _anjay_dm_module_install(anjay, &OID_INTEREST_MODULE, &ctx));
+
+    anjay_notify_queue_t queue = NULL;
+    AVS_UNIT_ASSERT_SUCCESS(
+            _anjay_notify_queue_resource_change(&queue, 43, 1, 2));
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_notify_perform(anjay, queue));
+    AVS_UNIT_ASSERT_EQUAL(ctx.calls, 0);
+
+    AVS_UNIT_ASSERT_SUCCESS(
+            _anjay_notify_queue_resource_change(&queue, 44, 1, 2));
+    AVS_UNIT_ASSERT_SUCCESS(
+            _anjay_notify_queue_instance_created(&queue, 45, 1));
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_notify_perform(anjay, queue));
+    AVS_UNIT_ASSERT_EQUAL(ctx.calls, 1);
+    AVS_UNIT_ASSERT_EQUAL(ctx.num_oids, 1);
+    AVS_UNIT_ASSERT_EQUAL(ctx.oids[0], 44);
+
+    AVS_UNIT_ASSERT_SUCCESS(
+            _anjay_notify_queue_resource_change(&queue, 42, 1, 2));
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_notify_perform(anjay, queue));
+    AVS_UNIT_ASSERT_EQUAL(ctx.calls, 2);
+    AVS_UNIT_ASSERT_EQUAL(ctx.num_oids, 2);
+    AVS_UNIT_ASSERT_EQUAL(ctx.oids[0], 42);
+    AVS_UNIT_ASSERT_EQUAL(ctx.oids[1], 44);
+
+    _anjay_notify_clear_queue(&queue);
+    DM_TEST_FINISH;
+}
+
+AVS_UNIT_TEST(dm_notify_interest, instance_set_changes_only) {
+    DM_TEST_INIT;
+    notify_interest_ctx_t ctx = { 0 };
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_dm_module_install(
+            anjay, &INSTANCE_SET_INTEREST_MODULE, &ctx));
+
+    anjay_notify_queue_t queue = NULL;
+    AVS_UNIT_ASSERT_SUCCESS(
+            _anjay_notify_queue_resource_change(&queue, 42, 1, 2));
+    AVS_UNIT_ASSERT_SUCCESS(
+            _anjay_notify_queue_resource_change(&queue, 43, 1, 2));
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_notify_perform(anjay, queue));
+    AVS_UNIT_ASSERT_EQUAL(ctx.calls, 0);
+
+    AVS_UNIT_ASSERT_SUCCESS(
+            _anjay_notify_queue_instance_removed(&queue, 43, 1));
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_notify_perform(anjay, queue));
+    AVS_UNIT_ASSERT_EQUAL(ctx.calls, 1);
+    AVS_UNIT_ASSERT_EQUAL(ctx.num_oids, 1);
+    AVS_UNIT_ASSERT_EQUAL(ctx.oids[0], 43);
+
+    _anjay_notify_clear_queue(&queue);
+    DM_TEST_FINISH;
+}
+
 static int succeed(void) {
     return 0;
 }
@@ -2523,3 +2908,41 @@ AVS_UNIT_TEST(dm_res_read, no_space) {
 
     DM_TEST_FINISH;
 }
+
+AVS_UNIT_TEST(dm_register_objects, sorted_and_atomic) {
+    DM_TEST_INIT_WITH_OBJECTS(&FAKE_SECURITY, &FAKE_SERVER,
+                              &OBJ_WITH_RES_OPS);
+
+    const anjay_dm_object_def_t *const *const duplicated[] = {
+        &OBJ, &OBJ_WITH_RESET, &OBJ
+    };
+    AVS_UNIT_ASSERT_FAILED(anjay_register_objects(
+            anjay, duplicated, AVS_ARRAY_SIZE(duplicated)));
+
+    const anjay_dm_object_def_t *const *const already_registered[] = {
+        &OBJ, &OBJ_WITH_RES_OPS
+    };
+    AVS_UNIT_ASSERT_FAILED(anjay_register_objects(
+            anjay, already_registered, AVS_ARRAY_SIZE(already_registered)));
+    AVS_UNIT_ASSERT_EQUAL(AVS_LIST_SIZE(anjay->dm.objects), 3);
+
+    const anjay_dm_object_def_t *const *const objs[] = {
+        &OBJ_NOATTRS,
+        (const anjay_dm_object_def_t *const *) &EXECUTE_OBJ,
+        &OBJ,
+        &OBJ_WITH_RESET
+    };
+    AVS_UNIT_ASSERT_SUCCESS(anjay_register_objects(anjay, objs,
+                                                   AVS_ARRAY_SIZE(objs)));
+
+    static const anjay_oid_t EXPECTED_OIDS[] = { 0, 1, 25, 42, 93, 128, 667 };
+    AVS_UNIT_ASSERT_EQUAL(AVS_LIST_SIZE(anjay->dm.objects),
+                          AVS_ARRAY_SIZE(EXPECTED_OIDS));
+    size_t i = 0;
+    AVS_LIST(const anjay_dm_object_def_t *const *) it;
+    AVS_LIST_FOREACH(it, anjay->dm.objects) {
+        AVS_UNIT_ASSERT_EQUAL((**it)->oid, EXPECTED_OIDS[i++]);
+    }
+
+    DM_TEST_FINISH;
+}
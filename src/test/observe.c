@@ -22,6 +22,8 @@
 
 #include <avsystem/commons/unit/test.h>
 
+#include <anjay/stats.h>
+
 #include <anjay_test/dm.h>
 #include <anjay_test/mock_clock.h>
 
@@ -338,15 +340,17 @@ AVS_UNIT_TEST(observe, cancel_deregister) {
 }
 
 static inline void
-remove_server(AVS_LIST(anjay_active_server_info_t) *server_ptr) {
-    _anjay_connection_internal_clean_socket(&(*server_ptr)->udp_connection);
+remove_server(anjay_t *anjay,
+              AVS_LIST(anjay_active_server_info_t) *server_ptr) {
+    _anjay_connection_internal_clean_socket(anjay,
+                                            &(*server_ptr)->udp_connection);
     AVS_LIST_DELETE(server_ptr);
 }
 
 AVS_UNIT_TEST(observe, gc) {
     SUCCESS_TEST(14, 69, 514, 666, 777);
 
-    remove_server(&anjay->servers.active);
+    remove_server(anjay, &anjay->servers.active);
 
     _anjay_observe_gc(anjay);
     assert_observe_size(anjay, 4);
@@ -355,7 +359,7 @@ AVS_UNIT_TEST(observe, gc) {
     ASSERT_SUCCESS_TEST_RESULT(666);
     ASSERT_SUCCESS_TEST_RESULT(777);
 
-    remove_server(AVS_LIST_NTH_PTR(&anjay->servers.active, 3));
+    remove_server(anjay, AVS_LIST_NTH_PTR(&anjay->servers.active, 3));
 
     _anjay_observe_gc(anjay);
     assert_observe_size(anjay, 3);
@@ -363,7 +367,7 @@ AVS_UNIT_TEST(observe, gc) {
     ASSERT_SUCCESS_TEST_RESULT(514);
     ASSERT_SUCCESS_TEST_RESULT(666);
 
-    remove_server(AVS_LIST_NTH_PTR(&anjay->servers.active, 1));
+    remove_server(anjay, AVS_LIST_NTH_PTR(&anjay->servers.active, 1));
 
     _anjay_observe_gc(anjay);
     assert_observe_size(anjay, 2);
@@ -501,6 +505,223 @@ AVS_UNIT_TEST(notify, max_period) {
     notify_max_period_test("\x70\x00\x69\xEE", 4, 0); // Reset
 }
 
+static const anjay_dm_object_def_t *const OBJ_ALL_CHANGES_NOTIFIED =
+        &(const anjay_dm_object_def_t) {
+            .oid = 42,
+            .supported_rids = ANJAY_DM_SUPPORTED_RIDS(0, 1, 2, 3, 4, 5, 6),
+            .handlers = {
+                ANJAY_MOCK_DM_HANDLERS
+            },
+            .all_changes_notified = true
+        };
+
+AVS_UNIT_TEST(notify, max_period_reuses_value_if_all_changes_notified) {
+    static const anjay_dm_internal_res_attrs_t ATTRS = {
+        .standard = {
+            .common = {
+                .min_period = 1,
+                .max_period = 10
+            },
+            .greater_than = ANJAY_ATTRIB_VALUE_NONE,
+            .less_than = ANJAY_ATTRIB_VALUE_NONE,
+            .step = ANJAY_ATTRIB_VALUE_NONE
+        }
+    };
+
+    ////// INITIALIZATION //////
+    DM_TEST_INIT_GENERIC((&OBJ_ALL_CHANGES_NOTIFIED, &FAKE_SECURITY,
+                          &FAKE_SERVER),
+                         (14), ());
+    expect_read_res_attrs(anjay, &OBJ_ALL_CHANGES_NOTIFIED, 14, 69, 4, &ATTRS);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_observe_put_entry(
+            anjay, &(const anjay_observe_key_t) {
+                { 14, ANJAY_CONNECTION_UDP }, 42, 69, 4, AVS_COAP_FORMAT_NONE
+            }, &(const anjay_msg_details_t) {
+                .msg_type = AVS_COAP_MSG_ACKNOWLEDGEMENT,
+                .msg_code = AVS_COAP_CODE_CONTENT,
+                .format = ANJAY_COAP_FORMAT_PLAINTEXT,
+                .observe_serial = true
+            }, &NULL_IDENTITY, 514.0, "514", 3));
+    assert_observe_size(anjay, 1);
+
+    ////// PMAX EXPIRED, NO CHANGE REPORTED: VALUE NOT READ //////
+    _anjay_mock_clock_advance(avs_time_duration_from_scalar(10, AVS_TIME_S));
+    expect_read_notif_storing(anjay, &FAKE_SERVER, 14, true);
+    expect_read_res_attrs(anjay, &OBJ_ALL_CHANGES_NOTIFIED, 14, 69, 4, &ATTRS);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+    expect_read_notif_storing(anjay, &FAKE_SERVER, 14, true);
+    static const char NOTIFY_RESPONSE[] =
+            "\x50\x45\x69\xED" // CoAP header
+            "\x63\xF9\x00\x00" // Observe option
+            "\x60" // Content-Format
+            "\xFF" "514";
+    avs_unit_mocksock_expect_output(mocksocks[0], NOTIFY_RESPONSE,
+                                    sizeof(NOTIFY_RESPONSE) - 1);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+    assert_observe(anjay, 14, 42, 69, 4, AVS_COAP_FORMAT_NONE,
+                   &(const anjay_msg_details_t) {
+                       .msg_type = AVS_COAP_MSG_NON_CONFIRMABLE,
+                       .msg_code = AVS_COAP_CODE_CONTENT,
+                       .format = ANJAY_COAP_FORMAT_PLAINTEXT,
+                       .observe_serial = true
+                   }, "514", 3);
+
+    ////// CHANGE REPORTED: VALUE READ AGAIN //////
+    _anjay_mock_clock_advance(avs_time_duration_from_scalar(5, AVS_TIME_S));
+    expect_read_res_attrs(anjay, &OBJ_ALL_CHANGES_NOTIFIED, 14, 69, 4, &ATTRS);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_notify_changed(anjay, 42, 69, 4));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+    expect_read_notif_storing(anjay, &FAKE_SERVER, 14, true);
+    expect_read_res_attrs(anjay, &OBJ_ALL_CHANGES_NOTIFIED, 14, 69, 4, &ATTRS);
+    expect_read_res(anjay, &OBJ_ALL_CHANGES_NOTIFIED, 69, 4,
+                    ANJAY_MOCK_DM_STRING(0, "Hello"));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+    expect_read_notif_storing(anjay, &FAKE_SERVER, 14, true);
+    static const char CHANGED_NOTIFY_RESPONSE[] =
+            "\x50\x45\x69\xEE" // CoAP header
+            "\x63\xFB\x80\x00" // Observe option
+            "\x60" // Content-Format
+            "\xFF" "Hello";
+    avs_unit_mocksock_expect_output(mocksocks[0], CHANGED_NOTIFY_RESPONSE,
+                                    sizeof(CHANGED_NOTIFY_RESPONSE) - 1);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+    assert_observe_size(anjay, 1);
+
+    DM_TEST_FINISH;
+}
+
+AVS_UNIT_TEST(notify, max_period_rereads_value_written_by_observer) {
+    static const anjay_dm_internal_res_attrs_t ATTRS = {
+        .standard = {
+            .common = {
+                .min_period = 1,
+                .max_period = 10
+            },
+            .greater_than = ANJAY_ATTRIB_VALUE_NONE,
+            .less_than = ANJAY_ATTRIB_VALUE_NONE,
+            .step = ANJAY_ATTRIB_VALUE_NONE
+        }
+    };
+
+    ////// INITIALIZATION //////
+    DM_TEST_INIT_GENERIC((&OBJ_ALL_CHANGES_NOTIFIED, &FAKE_SECURITY,
+                          &FAKE_SERVER),
+                         (14), ());
+    expect_read_res_attrs(anjay, &OBJ_ALL_CHANGES_NOTIFIED, 14, 69, 4, &ATTRS);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_observe_put_entry(
+            anjay, &(const anjay_observe_key_t) {
+                { 14, ANJAY_CONNECTION_UDP }, 42, 69, 4, AVS_COAP_FORMAT_NONE
+            }, &(const anjay_msg_details_t) {
+                .msg_type = AVS_COAP_MSG_ACKNOWLEDGEMENT,
+                .msg_code = AVS_COAP_CODE_CONTENT,
+                .format = ANJAY_COAP_FORMAT_PLAINTEXT,
+                .observe_serial = true
+            }, &NULL_IDENTITY, 514.0, "514", 3));
+    assert_observe_size(anjay, 1);
+
+    ////// THE OBSERVING SERVER WRITES THE RESOURCE: NOT NOTIFIED //////
+    _anjay_mock_clock_advance(avs_time_duration_from_scalar(5, AVS_TIME_S));
+    anjay->current_connection.server = anjay->servers.active;
+    anjay->current_connection.conn_type = ANJAY_CONNECTION_UDP;
+    anjay_notify_queue_t queue = NULL;
+    AVS_UNIT_ASSERT_SUCCESS(
+            _anjay_notify_queue_resource_change(&queue, 42, 69, 4));
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_notify_flush(anjay, &queue));
+    memset(&anjay->current_connection, 0, sizeof(anjay->current_connection));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+    _anjay_mock_dm_expect_clean();
+
+    ////// PMAX EXPIRED: THE WRITTEN VALUE IS READ INSTEAD OF REUSED //////
+    _anjay_mock_clock_advance(avs_time_duration_from_scalar(5, AVS_TIME_S));
+    expect_read_notif_storing(anjay, &FAKE_SERVER, 14, true);
+    expect_read_res_attrs(anjay, &OBJ_ALL_CHANGES_NOTIFIED, 14, 69, 4, &ATTRS);
+    expect_read_res(anjay, &OBJ_ALL_CHANGES_NOTIFIED, 69, 4,
+                    ANJAY_MOCK_DM_STRING(0, "Hello"));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+    expect_read_notif_storing(anjay, &FAKE_SERVER, 14, true);
+    static const char NOTIFY_RESPONSE[] =
+            "\x50\x45\x69\xED" // CoAP header
+            "\x63\xF9\x00\x00" // Observe option
+            "\x60" // Content-Format
+            "\xFF" "Hello";
+    avs_unit_mocksock_expect_output(mocksocks[0], NOTIFY_RESPONSE,
+                                    sizeof(NOTIFY_RESPONSE) - 1);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+    assert_observe_size(anjay, 1);
+
+    DM_TEST_FINISH;
+}
+
+AVS_UNIT_TEST(notify, max_period_rereads_value_after_instance_set_change) {
+    static const anjay_dm_internal_res_attrs_t ATTRS = {
+        .standard = {
+            .common = {
+                .min_period = 1,
+                .max_period = 10
+            },
+            .greater_than = ANJAY_ATTRIB_VALUE_NONE,
+            .less_than = ANJAY_ATTRIB_VALUE_NONE,
+            .step = ANJAY_ATTRIB_VALUE_NONE
+        }
+    };
+
+    ////// INITIALIZATION //////
+    DM_TEST_INIT_GENERIC((&OBJ_ALL_CHANGES_NOTIFIED, &FAKE_SECURITY,
+                          &FAKE_SERVER),
+                         (14), ());
+    expect_read_res_attrs(anjay, &OBJ_ALL_CHANGES_NOTIFIED, 14, 69, 4, &ATTRS);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_observe_put_entry(
+            anjay, &(const anjay_observe_key_t) {
+                { 14, ANJAY_CONNECTION_UDP }, 42, 69, 4, AVS_COAP_FORMAT_NONE
+            }, &(const anjay_msg_details_t) {
+                .msg_type = AVS_COAP_MSG_ACKNOWLEDGEMENT,
+                .msg_code = AVS_COAP_CODE_CONTENT,
+                .format = ANJAY_COAP_FORMAT_PLAINTEXT,
+                .observe_serial = true
+            }, &NULL_IDENTITY, 514.0, "514", 3));
+    assert_observe_size(anjay, 1);
+
+    ////// UNKNOWN INSTANCE SET CHANGE: VALUE READ AGAIN //////
+    _anjay_mock_clock_advance(avs_time_duration_from_scalar(5, AVS_TIME_S));
+    expect_read_res_attrs(anjay, &OBJ_ALL_CHANGES_NOTIFIED, 14, 69, 4, &ATTRS);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_notify_instances_changed(anjay, 42));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+    _anjay_mock_dm_expect_clean();
+    expect_read_notif_storing(anjay, &FAKE_SERVER, 14, true);
+    expect_read_res_attrs(anjay, &OBJ_ALL_CHANGES_NOTIFIED, 14, 69, 4, &ATTRS);
+    expect_read_res(anjay, &OBJ_ALL_CHANGES_NOTIFIED, 69, 4,
+                    ANJAY_MOCK_DM_STRING(0, "Hello"));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+    expect_read_notif_storing(anjay, &FAKE_SERVER, 14, true);
+    static const char NOTIFY_RESPONSE[] =
+            "\x50\x45\x69\xED" // CoAP header
+            "\x63\xF6\x80\x00" // Observe option
+            "\x60" // Content-Format
+            "\xFF" "Hello";
+    avs_unit_mocksock_expect_output(mocksocks[0], NOTIFY_RESPONSE,
+                                    sizeof(NOTIFY_RESPONSE) - 1);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+    assert_observe_size(anjay, 1);
+
+    ////// PMAX EXPIRED, NO CHANGE REPORTED SINCE: NEW VALUE REUSED //////
+    _anjay_mock_clock_advance(avs_time_duration_from_scalar(10, AVS_TIME_S));
+    expect_read_notif_storing(anjay, &FAKE_SERVER, 14, true);
+    expect_read_res_attrs(anjay, &OBJ_ALL_CHANGES_NOTIFIED, 14, 69, 4, &ATTRS);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+    expect_read_notif_storing(anjay, &FAKE_SERVER, 14, true);
+    static const char PMAX_NOTIFY_RESPONSE[] =
+            "\x50\x45\x69\xEE" // CoAP header
+            "\x63\xFB\x80\x00" // Observe option
+            "\x60" // Content-Format
+            "\xFF" "Hello";
+    avs_unit_mocksock_expect_output(mocksocks[0], PMAX_NOTIFY_RESPONSE,
+                                    sizeof(PMAX_NOTIFY_RESPONSE) - 1);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+    assert_observe_size(anjay, 1);
+
+    DM_TEST_FINISH;
+}
+
 AVS_UNIT_TEST(notify, min_period) {
     static const anjay_dm_internal_res_attrs_t ATTRS = {
         .standard = {
@@ -568,6 +789,267 @@ AVS_UNIT_TEST(notify, min_period) {
     DM_TEST_FINISH;
 }
 
+AVS_UNIT_TEST(notify, queue_mode_slack_only_for_pulled_forward_triggers) {
+    static const anjay_dm_internal_res_attrs_t ATTRS = {
+        .standard = {
+            .common = {
+                .min_period = 1,
+                .max_period = 10
+            },
+            .greater_than = ANJAY_ATTRIB_VALUE_NONE,
+            .less_than = ANJAY_ATTRIB_VALUE_NONE,
+            .step = ANJAY_ATTRIB_VALUE_NONE
+        }
+    };
+
+    ////// INITIALIZATION //////
+    DM_TEST_INIT_GENERIC((&OBJ, &FAKE_SECURITY, &FAKE_SERVER), (14),
+                         (.queue_mode_wakeup_slack = { 5, 0 }));
+    anjay->servers.active->udp_connection.queue_mode = true;
+    expect_read_res_attrs(anjay, &OBJ, 14, 69, 4, &ATTRS);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_observe_put_entry(
+            anjay, &(const anjay_observe_key_t) {
+                { 14, ANJAY_CONNECTION_UDP }, 42, 69, 4, AVS_COAP_FORMAT_NONE
+            }, &(const anjay_msg_details_t) {
+                .msg_type = AVS_COAP_MSG_ACKNOWLEDGEMENT,
+                .msg_code = AVS_COAP_CODE_CONTENT,
+                .format = ANJAY_COAP_FORMAT_PLAINTEXT,
+                .observe_serial = true
+            }, &NULL_IDENTITY, 514.0, "514", 3));
+    _anjay_mock_dm_expect_clean();
+    assert_observe_size(anjay, 1);
+
+    ////// CHANGE TRIGGER - PMAX WITHIN SLACK, BUT NOT EXPIRED //////
+    _anjay_mock_clock_advance(avs_time_duration_from_scalar(7, AVS_TIME_S));
+    expect_read_res_attrs(anjay, &OBJ, 14, 69, 4, &ATTRS);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_notify_changed(anjay, 42, 69, 4));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+    expect_read_notif_storing(anjay, &FAKE_SERVER, 14, true);
+    expect_read_res_attrs(anjay, &OBJ, 14, 69, 4, &ATTRS);
+    expect_read_res(anjay, &OBJ, 69, 4, ANJAY_MOCK_DM_STRING(0, "514"));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+    // value did not change, so nothing shall be sent
+    AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+
+    ////// QUEUE MODE WAKE-UP - PMAX TRIGGER PULLED FORWARD //////
+    expect_read_res_attrs(anjay, &OBJ, 14, 69, 4, &ATTRS);
+    const anjay_connection_ref_t ref = {
+        .server = anjay->servers.active,
+        .conn_type = ANJAY_CONNECTION_UDP
+    };
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_bind_server_stream(anjay, ref));
+    _anjay_release_server_stream(anjay);
+    AVS_UNIT_ASSERT_EQUAL(anjay_get_num_queue_mode_wakeups(anjay), 1);
+
+    // pmax would expire within the slack, so the unchanged value is sent now
+    expect_read_notif_storing(anjay, &FAKE_SERVER, 14, true);
+    expect_read_res_attrs(anjay, &OBJ, 14, 69, 4, &ATTRS);
+    expect_read_res(anjay, &OBJ, 69, 4, ANJAY_MOCK_DM_STRING(0, "514"));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+    expect_read_notif_storing(anjay, &FAKE_SERVER, 14, true);
+    static const char NOTIFY_RESPONSE[] =
+            "\x50\x45\x69\xED" // CoAP header
+            "\x63\xF7\x80\x00" // Observe option
+            "\x60" // Content-Format
+            "\xFF" "514";
+    avs_unit_mocksock_expect_output(mocksocks[0], NOTIFY_RESPONSE,
+                                    sizeof(NOTIFY_RESPONSE) - 1);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+    assert_observe_size(anjay, 1);
+
+    DM_TEST_FINISH;
+}
+
+#ifdef WITH_EVAL_PERIOD_ATTRS
+static time_t time_to_next_job_s(anjay_t *anjay) {
+    avs_time_duration_t delay;
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_sched_time_to_next(anjay->sched, &delay));
+    return delay.seconds;
+}
+
+AVS_UNIT_TEST(notify, eval_periods) {
+    static const anjay_dm_internal_res_attrs_t ATTRS = {
+        .custom = {
+            .data = {
+                .min_eval_period = 10,
+                .max_eval_period = 60
+            }
+        },
+        .standard = {
+            .common = {
+                .min_period = 0,
+                .max_period = 365 * 24 * 60 * 60 // a year
+            },
+            .greater_than = ANJAY_ATTRIB_VALUE_NONE,
+            .less_than = ANJAY_ATTRIB_VALUE_NONE,
+            .step = ANJAY_ATTRIB_VALUE_NONE
+        }
+    };
+
+    ////// INITIALIZATION //////
+    DM_TEST_INIT_WITH_SSIDS(14);
+    expect_read_res_attrs(anjay, &OBJ, 14, 69, 4, &ATTRS);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_observe_put_entry(
+            anjay, &(const anjay_observe_key_t) {
+                { 14, ANJAY_CONNECTION_UDP }, 42, 69, 4, AVS_COAP_FORMAT_NONE
+            }, &(const anjay_msg_details_t) {
+                .msg_type = AVS_COAP_MSG_ACKNOWLEDGEMENT,
+                .msg_code = AVS_COAP_CODE_CONTENT,
+                .format = ANJAY_COAP_FORMAT_PLAINTEXT,
+                .observe_serial = true
+            }, &NULL_IDENTITY, 514.0, "514", 3));
+    _anjay_mock_dm_expect_clean();
+    assert_observe_size(anjay, 1);
+    AVS_UNIT_ASSERT_EQUAL(time_to_next_job_s(anjay), 60);
+
+    ////// EPMIN NOT REACHED: CHANGES DO NOT CAUSE READS //////
+    _anjay_mock_clock_advance(avs_time_duration_from_scalar(5, AVS_TIME_S));
+    for (int i = 0; i < 3; ++i) {
+        expect_read_res_attrs(anjay, &OBJ, 14, 69, 4, &ATTRS);
+        AVS_UNIT_ASSERT_SUCCESS(anjay_notify_changed(anjay, 42, 69, 4));
+        AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+        AVS_UNIT_ASSERT_EQUAL(time_to_next_job_s(anjay), 5);
+    }
+
+    ////// EPMIN REACHED //////
+    _anjay_mock_clock_advance(avs_time_duration_from_scalar(5, AVS_TIME_S));
+    expect_read_notif_storing(anjay, &FAKE_SERVER, 14, true);
+    expect_read_res_attrs(anjay, &OBJ, 14, 69, 4, &ATTRS);
+    expect_read_res(anjay, &OBJ, 69, 4, ANJAY_MOCK_DM_STRING(0, "Hi!"));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+    expect_read_notif_storing(anjay, &FAKE_SERVER, 14, true);
+    static const char NOTIFY_RESPONSE[] =
+            "\x50\x45\x69\xED" // CoAP header
+            "\x63\xF9\x00\x00" // Observe option
+            "\x60" // Content-Format
+            "\xFF" "Hi!";
+    avs_unit_mocksock_expect_output(mocksocks[0], NOTIFY_RESPONSE,
+                                    sizeof(NOTIFY_RESPONSE) - 1);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+    assert_observe_size(anjay, 1);
+
+    ////// EPMIN COUNTED FROM THE LAST READ //////
+    _anjay_mock_clock_advance(avs_time_duration_from_scalar(5, AVS_TIME_S));
+    expect_read_res_attrs(anjay, &OBJ, 14, 69, 4, &ATTRS);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_notify_changed(anjay, 42, 69, 4));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+    AVS_UNIT_ASSERT_EQUAL(time_to_next_job_s(anjay), 5);
+
+    _anjay_mock_clock_advance(avs_time_duration_from_scalar(5, AVS_TIME_S));
+    expect_read_notif_storing(anjay, &FAKE_SERVER, 14, true);
+    expect_read_res_attrs(anjay, &OBJ, 14, 69, 4, &ATTRS);
+    expect_read_res(anjay, &OBJ, 69, 4, ANJAY_MOCK_DM_STRING(0, "Hi!"));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+    // nothing to flush
+    AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+    assert_observe_size(anjay, 1);
+
+    ////// EPMAX: VALUE SAMPLED WITHOUT ANY CHANGE REPORTED //////
+    AVS_UNIT_ASSERT_EQUAL(time_to_next_job_s(anjay), 60);
+    _anjay_mock_clock_advance(avs_time_duration_from_scalar(60, AVS_TIME_S));
+    expect_read_notif_storing(anjay, &FAKE_SERVER, 14, true);
+    expect_read_res_attrs(anjay, &OBJ, 14, 69, 4, &ATTRS);
+    expect_read_res(anjay, &OBJ, 69, 4, ANJAY_MOCK_DM_STRING(0, "Hi!"));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+    assert_observe_size(anjay, 1);
+    AVS_UNIT_ASSERT_EQUAL(time_to_next_job_s(anjay), 60);
+
+    DM_TEST_FINISH;
+}
+#endif // WITH_EVAL_PERIOD_ATTRS
+
+/**
+ * Lets "pmin" pass and runs the notification triggers, expecting that the
+ * observed /42/IID/4 Resource is read, with its value unchanged, exactly for
+ * the @p count Instances listed in @p iids , and not for any other one.
+ */
+static void
+expect_unchanged_value_reads(anjay_t *anjay,
+                             const anjay_iid_t *iids,
+                             size_t count,
+                             const anjay_dm_internal_res_attrs_t *attrs) {
+    _anjay_mock_clock_advance(avs_time_duration_from_scalar(
+            attrs->standard.common.min_period, AVS_TIME_S));
+    for (size_t i = 0; i < count; ++i) {
+        expect_read_notif_storing(anjay, &FAKE_SERVER, 14, true);
+        expect_read_res_attrs(anjay, &OBJ, 14, iids[i], 4, attrs);
+        expect_read_res(anjay, &OBJ, iids[i], 4,
+                        ANJAY_MOCK_DM_STRING(0, "514"));
+    }
+    AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+    _anjay_mock_dm_expect_clean();
+}
+
+AVS_UNIT_TEST(notify, instance_set_changes) {
+    static const anjay_dm_internal_res_attrs_t ATTRS = {
+        .standard = {
+            .common = {
+                .min_period = 10,
+                .max_period = 365 * 24 * 60 * 60 // a year
+            },
+            .greater_than = ANJAY_ATTRIB_VALUE_NONE,
+            .less_than = ANJAY_ATTRIB_VALUE_NONE,
+            .step = ANJAY_ATTRIB_VALUE_NONE
+        }
+    };
+    static const anjay_iid_t OBSERVED_IIDS[] = { 69, 514, 777 };
+
+    ////// INITIALIZATION //////
+    DM_TEST_INIT_WITH_SSIDS(14);
+    for (size_t i = 0; i < AVS_ARRAY_SIZE(OBSERVED_IIDS); ++i) {
+        expect_read_res_attrs(anjay, &OBJ, 14, OBSERVED_IIDS[i], 4, &ATTRS);
+        AVS_UNIT_ASSERT_SUCCESS(_anjay_observe_put_entry(
+                anjay, &(const anjay_observe_key_t) {
+                    { 14, ANJAY_CONNECTION_UDP }, 42, OBSERVED_IIDS[i], 4,
+                    AVS_COAP_FORMAT_NONE
+                }, &(const anjay_msg_details_t) {
+                    .msg_type = AVS_COAP_MSG_ACKNOWLEDGEMENT,
+                    .msg_code = AVS_COAP_CODE_CONTENT,
+                    .format = ANJAY_COAP_FORMAT_PLAINTEXT,
+                    .observe_serial = true
+                }, &NULL_IDENTITY, 514.0, "514", 3));
+    }
+    _anjay_mock_dm_expect_clean();
+    assert_observe_size(anjay, 3);
+
+    ////// UNOBSERVED OBJECT: NOTHING HAPPENS //////
+    AVS_UNIT_ASSERT_SUCCESS(anjay_notify_instances_changed(anjay, 128));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+    _anjay_mock_dm_expect_clean();
+
+    ////// UNKNOWN CHANGE: EVERYTHING NOTIFIED, EVERY TIME //////
+    for (int i = 0; i < 2; ++i) {
+        for (size_t j = 0; j < AVS_ARRAY_SIZE(OBSERVED_IIDS); ++j) {
+            expect_read_res_attrs(anjay, &OBJ, 14, OBSERVED_IIDS[j], 4,
+                                  &ATTRS);
+        }
+        AVS_UNIT_ASSERT_SUCCESS(anjay_notify_instances_changed(anjay, 42));
+        AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+        _anjay_mock_dm_expect_clean();
+        expect_unchanged_value_reads(anjay, OBSERVED_IIDS,
+                                     AVS_ARRAY_SIZE(OBSERVED_IIDS), &ATTRS);
+    }
+
+    ////// UNOBSERVED INSTANCE CREATED: NO OBSERVATION IS TOUCHED //////
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_notify_instance_created(anjay, 42, 1000));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+    _anjay_mock_dm_expect_clean();
+    expect_unchanged_value_reads(anjay, NULL, 0, &ATTRS);
+
+    ////// OBSERVED INSTANCE CREATED: ONLY IT IS NOTIFIED //////
+    expect_read_res_attrs(anjay, &OBJ, 14, 514, 4, &ATTRS);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_notify_instance_created(anjay, 42, 514));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+    _anjay_mock_dm_expect_clean();
+    expect_unchanged_value_reads(anjay, &(const anjay_iid_t) { 514 }, 1,
+                                 &ATTRS);
+
+    assert_observe_size(anjay, 3);
+
+    DM_TEST_FINISH;
+}
+
 AVS_UNIT_TEST(notify, confirmable) {
     ////// INITIALIZATION //////
     DM_TEST_INIT_GENERIC((DM_TEST_DEFAULT_OBJECTS), (14),
@@ -615,6 +1097,99 @@ AVS_UNIT_TEST(notify, confirmable) {
     DM_TEST_FINISH;
 }
 
+AVS_UNIT_TEST(notify, confirmable_with_concurrent_request) {
+    ////// INITIALIZATION //////
+    DM_TEST_INIT_GENERIC((DM_TEST_DEFAULT_OBJECTS), (14),
+                         (.confirmable_notifications = true));
+    DM_TEST_EXPECT_READ_NULL_ATTRS(14, 69, 4);
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_observe_put_entry(
+            anjay, &(const anjay_observe_key_t) {
+                { 14, ANJAY_CONNECTION_UDP }, 42, 69, 4, AVS_COAP_FORMAT_NONE
+            }, &(const anjay_msg_details_t) {
+                .msg_type = AVS_COAP_MSG_ACKNOWLEDGEMENT,
+                .msg_code = AVS_COAP_CODE_CONTENT,
+                .format = ANJAY_COAP_FORMAT_PLAINTEXT,
+                .observe_serial = true
+            }, &(avs_coap_msg_identity_t) {}, 514.0, "514", 3));
+    assert_observe_size(anjay, 1);
+
+    ////// EMPTY SCHEDULER RUN //////
+    _anjay_mock_clock_advance(avs_time_duration_from_scalar(5, AVS_TIME_S));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+    assert_observe_size(anjay, 1);
+
+    ////// CONFIRMABLE NOTIFICATION //////
+    _anjay_mock_clock_advance(avs_time_duration_from_scalar(5, AVS_TIME_S));
+    DM_TEST_EXPECT_READ_NULL_ATTRS(14, 69, 4);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_notify_changed(anjay, 42, 69, 4));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+    expect_read_notif_storing(anjay, &FAKE_SERVER, 14, true);
+    DM_TEST_EXPECT_READ_NULL_ATTRS(14, 69, 4);
+    expect_read_res(anjay, &OBJ, 69, 4, ANJAY_MOCK_DM_INT(0, 42));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+    expect_read_notif_storing(anjay, &FAKE_SERVER, 14, true);
+    static const char NOTIFY_RESPONSE[] =
+            "\x40\x45\x69\xED" // CoAP header
+            "\x63\xF9\x00\x00" // Observe option
+            "\x60" // Content-Format
+            "\xFF" "42";
+    avs_unit_mocksock_expect_output(mocksocks[0], NOTIFY_RESPONSE,
+                                    sizeof(NOTIFY_RESPONSE) - 1);
+
+    ////// REQUEST ARRIVING BEFORE THE ACK //////
+    static const char REQUEST[] =
+            "\x40\x01\xFA\x3E" // CoAP header
+            "\xB4" "1234"; // OID
+    avs_unit_mocksock_input(mocksocks[0], REQUEST, sizeof(REQUEST) - 1);
+    static const char NOTIFY_ACK[] =
+            "\x60\x00\x69\xED";
+    avs_unit_mocksock_input(mocksocks[0], NOTIFY_ACK, sizeof(NOTIFY_ACK) - 1);
+    DM_TEST_EXPECT_READ_NULL_ATTRS(14, 69, 4);
+
+    // the request is handled after the notification exchange, instead of
+    // being rejected with 5.03 Service Unavailable
+    DM_TEST_EXPECT_RESPONSE(mocksocks[0], "\x60\x84\xFA\x3E");
+    AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+    avs_unit_mocksock_assert_expects_met(mocksocks[0]);
+    AVS_UNIT_ASSERT_EQUAL(anjay_get_num_deferred_requests(anjay), 1);
+    AVS_UNIT_ASSERT_EQUAL(anjay_get_num_dropped_deferred_requests(anjay), 0);
+
+    ////// ANOTHER CONFIRMABLE NOTIFICATION //////
+    _anjay_mock_clock_advance(avs_time_duration_from_scalar(10, AVS_TIME_S));
+    DM_TEST_EXPECT_READ_NULL_ATTRS(14, 69, 4);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_notify_changed(anjay, 42, 69, 4));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+    expect_read_notif_storing(anjay, &FAKE_SERVER, 14, true);
+    DM_TEST_EXPECT_READ_NULL_ATTRS(14, 69, 4);
+    expect_read_res(anjay, &OBJ, 69, 4, ANJAY_MOCK_DM_INT(0, 43));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+    expect_read_notif_storing(anjay, &FAKE_SERVER, 14, true);
+    static const char SECOND_NOTIFY_RESPONSE[] =
+            "\x40\x45\x69\xEE" // CoAP header
+            "\x63\xFE\x00\x00" // Observe option
+            "\x60" // Content-Format
+            "\xFF" "43";
+    avs_unit_mocksock_expect_output(mocksocks[0], SECOND_NOTIFY_RESPONSE,
+                                    sizeof(SECOND_NOTIFY_RESPONSE) - 1);
+
+    ////// RETRANSMISSION OF THE SERVED REQUEST BEFORE THE ACK //////
+    avs_unit_mocksock_input(mocksocks[0], REQUEST, sizeof(REQUEST) - 1);
+    static const char SECOND_NOTIFY_ACK[] =
+            "\x60\x00\x69\xEE";
+    avs_unit_mocksock_input(mocksocks[0], SECOND_NOTIFY_ACK,
+                            sizeof(SECOND_NOTIFY_ACK) - 1);
+    DM_TEST_EXPECT_READ_NULL_ATTRS(14, 69, 4);
+
+    // the request has already been served, so it is neither deferred nor
+    // handled again
+    AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+    avs_unit_mocksock_assert_expects_met(mocksocks[0]);
+    AVS_UNIT_ASSERT_EQUAL(anjay_get_num_deferred_requests(anjay), 1);
+    AVS_UNIT_ASSERT_EQUAL(anjay_get_num_dropped_deferred_requests(anjay), 0);
+
+    DM_TEST_FINISH;
+}
+
 AVS_UNIT_TEST(notify, extremes) {
     static const anjay_dm_internal_res_attrs_t ATTRS = {
         .standard = {
@@ -1436,6 +2011,159 @@ AVS_UNIT_TEST(notify, notify_changed) {
     destroy_test_env(anjay);
 }
 
+AVS_UNIT_TEST(notify, read_shared_by_three_servers) {
+    SUCCESS_TEST(14, 34, 56);
+
+    DM_TEST_EXPECT_READ_NULL_ATTRS(14, 69, 4);
+    DM_TEST_EXPECT_READ_NULL_ATTRS(34, 69, 4);
+    DM_TEST_EXPECT_READ_NULL_ATTRS(56, 69, 4);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_notify_changed(anjay, 42, 69, 4));
+    AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+
+    _anjay_mock_clock_advance(avs_time_duration_from_scalar(1, AVS_TIME_S));
+
+    // only one read, performed for SSID 14
+    expect_read_notif_storing(anjay, &FAKE_SERVER, 14, true);
+    DM_TEST_EXPECT_READ_NULL_ATTRS(14, 69, 4);
+    _anjay_mock_dm_expect_instance_present(anjay, &OBJ, 69, 1);
+    _anjay_mock_dm_expect_resource_present(anjay, &OBJ, 69, 4, 1);
+    _anjay_mock_dm_expect_resource_read(anjay, &OBJ, 69, 4, 0,
+                                        ANJAY_MOCK_DM_STRING(0, "Rin"));
+
+    // the value is reused for SSIDs 34 and 56
+    expect_read_notif_storing(anjay, &FAKE_SERVER, 34, true);
+    DM_TEST_EXPECT_READ_NULL_ATTRS(34, 69, 4);
+    expect_read_notif_storing(anjay, &FAKE_SERVER, 56, true);
+    DM_TEST_EXPECT_READ_NULL_ATTRS(56, 69, 4);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+    _anjay_mock_dm_expect_clean();
+
+    // each server still gets its own notification
+    static const char NOTIFY_RESPONSE1[] =
+            "\x50\x45\x69\xED" // CoAP header
+            "\x63\xF4\x80\x00" // Observe option
+            "\x60" // Content-Format
+            "\xFF" "Rin";
+    static const char NOTIFY_RESPONSE2[] =
+            "\x50\x45\x69\xEE" // CoAP header
+            "\x63\xF4\x80\x00" // Observe option
+            "\x60" // Content-Format
+            "\xFF" "Rin";
+    static const char NOTIFY_RESPONSE3[] =
+            "\x50\x45\x69\xEF" // CoAP header
+            "\x63\xF4\x80\x00" // Observe option
+            "\x60" // Content-Format
+            "\xFF" "Rin";
+    expect_read_notif_storing(anjay, &FAKE_SERVER, 14, true);
+    avs_unit_mocksock_expect_output(mocksocks[0], NOTIFY_RESPONSE1,
+                                    sizeof(NOTIFY_RESPONSE1) - 1);
+    DM_TEST_EXPECT_READ_NULL_ATTRS(14, 69, 4);
+    expect_read_notif_storing(anjay, &FAKE_SERVER, 34, true);
+    avs_unit_mocksock_expect_output(mocksocks[1], NOTIFY_RESPONSE2,
+                                    sizeof(NOTIFY_RESPONSE2) - 1);
+    DM_TEST_EXPECT_READ_NULL_ATTRS(34, 69, 4);
+    expect_read_notif_storing(anjay, &FAKE_SERVER, 56, true);
+    avs_unit_mocksock_expect_output(mocksocks[2], NOTIFY_RESPONSE3,
+                                    sizeof(NOTIFY_RESPONSE3) - 1);
+    DM_TEST_EXPECT_READ_NULL_ATTRS(56, 69, 4);
+    AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
+
+    DM_TEST_FINISH;
+}
+
+#ifdef WITH_ACCESS_CONTROL
+static const anjay_dm_object_def_t *const FAKE_ACCESS_CONTROL =
+        &(const anjay_dm_object_def_t) {
+            .oid = ANJAY_DM_OID_ACCESS_CONTROL,
+            .supported_rids = ANJAY_DM_SUPPORTED_RIDS(
+                    ANJAY_DM_RID_ACCESS_CONTROL_OID,
+                    ANJAY_DM_RID_ACCESS_CONTROL_OIID,
+                    ANJAY_DM_RID_ACCESS_CONTROL_ACL,
+                    ANJAY_DM_RID_ACCESS_CONTROL_OWNER),
+            .handlers = {
+                ANJAY_MOCK_DM_HANDLERS
+            }
+        };
+
+static void expect_access_control_res_read(anjay_t *anjay,
+                                           anjay_rid_t rid,
+                                           const anjay_mock_dm_data_t *data) {
+    _anjay_mock_dm_expect_resource_present(anjay, &FAKE_ACCESS_CONTROL, 0,
+                                           rid, 1);
+    _anjay_mock_dm_expect_resource_read(anjay, &FAKE_ACCESS_CONTROL, 0, rid,
+                                        0, data);
+}
+
+// Expects a lookup of the READ permission to /42/69 in the only Access Control
+// Object Instance, /2/0, owned by SSID 14
+static void expect_access_control_check(anjay_t *anjay,
+                                        const anjay_mock_dm_data_t *acl,
+                                        bool acl_found) {
+    _anjay_mock_dm_expect_instance_it(anjay, &FAKE_ACCESS_CONTROL, 0, 0, 0);
+    expect_access_control_res_read(anjay, ANJAY_DM_RID_ACCESS_CONTROL_OID,
+                                   ANJAY_MOCK_DM_INT(0, 42));
+    expect_access_control_res_read(anjay, ANJAY_DM_RID_ACCESS_CONTROL_OIID,
+                                   ANJAY_MOCK_DM_INT(0, 69));
+    expect_access_control_res_read(anjay, ANJAY_DM_RID_ACCESS_CONTROL_OWNER,
+                                   ANJAY_MOCK_DM_INT(0, 14));
+    expect_access_control_res_read(anjay, ANJAY_DM_RID_ACCESS_CONTROL_ACL,
+                                   acl);
+    if (!acl_found) {
+        _anjay_mock_dm_expect_instance_it(anjay, &FAKE_ACCESS_CONTROL, 1, 0,
+                                          ANJAY_IID_INVALID);
+    }
+}
+
+AVS_UNIT_TEST(notify, read_shared_only_with_same_access_control_verdict) {
+    DM_TEST_INIT_GENERIC((&OBJ, &FAKE_SECURITY, &FAKE_SERVER,
+                          &FAKE_ACCESS_CONTROL), (14, 34), ());
+    const anjay_observe_entry_t entry14 = {
+        .key = {
+            { 14, ANJAY_CONNECTION_UDP }, 42, 69, 4, AVS_COAP_FORMAT_NONE
+        }
+    };
+    const anjay_observe_entry_t entry34 = {
+        .key = {
+            { 34, ANJAY_CONNECTION_UDP }, 42, 69, 4, AVS_COAP_FORMAT_NONE
+        }
+    };
+
+    // default ACL entry only - both servers are allowed to read
+    expect_access_control_check(
+            anjay,
+            ANJAY_MOCK_DM_ARRAY(0,
+                ANJAY_MOCK_DM_ARRAY_ENTRY(0, ANJAY_MOCK_DM_INT(
+                        0, ANJAY_ACCESS_MASK_READ))),
+            false);
+    expect_access_control_check(
+            anjay,
+            ANJAY_MOCK_DM_ARRAY(0,
+                ANJAY_MOCK_DM_ARRAY_ENTRY(0, ANJAY_MOCK_DM_INT(
+                        0, ANJAY_ACCESS_MASK_READ))),
+            false);
+    AVS_UNIT_ASSERT_TRUE(read_result_shareable(anjay, &entry14, &entry34));
+    _anjay_mock_dm_expect_clean();
+
+    // only SSID 14 is allowed to read
+    expect_access_control_check(
+            anjay,
+            ANJAY_MOCK_DM_ARRAY(0,
+                ANJAY_MOCK_DM_ARRAY_ENTRY(14, ANJAY_MOCK_DM_INT(
+                        0, ANJAY_ACCESS_MASK_READ))),
+            true);
+    expect_access_control_check(
+            anjay,
+            ANJAY_MOCK_DM_ARRAY(0,
+                ANJAY_MOCK_DM_ARRAY_ENTRY(14, ANJAY_MOCK_DM_INT(
+                        0, ANJAY_ACCESS_MASK_READ))),
+            false);
+    AVS_UNIT_ASSERT_FALSE(read_result_shareable(anjay, &entry14, &entry34));
+    _anjay_mock_dm_expect_clean();
+
+    DM_TEST_FINISH;
+}
+#endif // WITH_ACCESS_CONTROL
+
 AVS_UNIT_TEST(notify, storing_when_inactive) {
     SUCCESS_TEST(14, 34);
 
@@ -1463,12 +2191,9 @@ AVS_UNIT_TEST(notify, storing_when_inactive) {
     _anjay_mock_dm_expect_resource_read(anjay, &OBJ, 69, 4, 0,
                                         ANJAY_MOCK_DM_STRING(0, "Rin"));
 
+    // the value read for SSID 14 is reused for SSID 34
     expect_read_notif_storing(anjay, &FAKE_SERVER, 34, true);
     DM_TEST_EXPECT_READ_NULL_ATTRS(34, 69, 4);
-    _anjay_mock_dm_expect_instance_present(anjay, &OBJ, 69, 1);
-    _anjay_mock_dm_expect_resource_present(anjay, &OBJ, 69, 4, 1);
-    _anjay_mock_dm_expect_resource_read(anjay, &OBJ, 69, 4, 0,
-                                        ANJAY_MOCK_DM_STRING(0, "Len"));
     AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
 
     expect_read_notif_storing(anjay, &FAKE_SERVER, 34, true);
@@ -1476,7 +2201,7 @@ AVS_UNIT_TEST(notify, storing_when_inactive) {
             "\x50\x45\x69\xED" // CoAP header
             "\x63\xF4\x80\x00" // Observe option
             "\x60" // Content-Format
-            "\xFF" "Len";
+            "\xFF" "Rin";
     avs_unit_mocksock_expect_output(mocksocks[1], NOTIFY_RESPONSE,
                                     sizeof(NOTIFY_RESPONSE) - 1);
     DM_TEST_EXPECT_READ_NULL_ATTRS(34, 69, 4);
@@ -1497,12 +2222,9 @@ AVS_UNIT_TEST(notify, storing_when_inactive) {
     _anjay_mock_dm_expect_resource_read(anjay, &OBJ, 69, 4, 0,
                                         ANJAY_MOCK_DM_STRING(0, "Miku"));
 
+    // the value read for SSID 14 is reused for SSID 34
     expect_read_notif_storing(anjay, &FAKE_SERVER, 34, true);
     DM_TEST_EXPECT_READ_NULL_ATTRS(34, 69, 4);
-    _anjay_mock_dm_expect_instance_present(anjay, &OBJ, 69, 1);
-    _anjay_mock_dm_expect_resource_present(anjay, &OBJ, 69, 4, 1);
-    _anjay_mock_dm_expect_resource_read(anjay, &OBJ, 69, 4, 0,
-                                        ANJAY_MOCK_DM_STRING(0, "Luka"));
     AVS_UNIT_ASSERT_SUCCESS(anjay_sched_run(anjay));
 
     expect_read_notif_storing(anjay, &FAKE_SERVER, 34, true);
@@ -1510,7 +2232,7 @@ AVS_UNIT_TEST(notify, storing_when_inactive) {
             "\x50\x45\x69\xEE" // CoAP header
             "\x63\xF5\x00\x00" // Observe option
             "\x60" // Content-Format
-            "\xFF" "Luka";
+            "\xFF" "Miku";
     avs_unit_mocksock_expect_output(mocksocks[1], NOTIFY_RESPONSE2,
                                     sizeof(NOTIFY_RESPONSE2) - 1);
     DM_TEST_EXPECT_READ_NULL_ATTRS(34, 69, 4);
@@ -115,6 +115,49 @@ AVS_UNIT_TEST(sched, sched_del) {
     teardown_test(&env);
 }
 
+AVS_UNIT_TEST(sched, pull_forward) {
+    sched_test_env_t env = setup_test();
+
+    int near_counter = 0;
+    int far_counter = 0;
+    anjay_sched_handle_t near_task = NULL;
+    anjay_sched_handle_t far_task = NULL;
+    AVS_UNIT_ASSERT_SUCCESS(
+            _anjay_sched(env.sched, &near_task,
+                         avs_time_duration_from_scalar(5, AVS_TIME_S),
+                         increment_task, &near_counter));
+    AVS_UNIT_ASSERT_SUCCESS(
+            _anjay_sched(env.sched, &far_task,
+                         avs_time_duration_from_scalar(60, AVS_TIME_S),
+                         increment_task, &far_counter));
+
+    const avs_time_duration_t slack =
+            avs_time_duration_from_scalar(10, AVS_TIME_S);
+    AVS_UNIT_ASSERT_EQUAL(
+            _anjay_sched_pull_forward(env.sched, &near_task, slack), 0);
+    AVS_UNIT_ASSERT_EQUAL(
+            _anjay_sched_pull_forward(env.sched, &far_task, slack), 1);
+    AVS_UNIT_ASSERT_NOT_NULL(near_task);
+    AVS_UNIT_ASSERT_NOT_NULL(far_task);
+
+    avs_time_duration_t delay;
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_sched_time_to_job(env.sched, near_task,
+                                                     &delay));
+    AVS_UNIT_ASSERT_TRUE(avs_time_duration_equal(delay,
+                                                 AVS_TIME_DURATION_ZERO));
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_sched_time_to_job(env.sched, far_task,
+                                                     &delay));
+    AVS_UNIT_ASSERT_TRUE(avs_time_duration_less(slack, delay));
+
+    AVS_UNIT_ASSERT_EQUAL(1, _anjay_sched_run(env.sched));
+    AVS_UNIT_ASSERT_EQUAL(1, near_counter);
+    AVS_UNIT_ASSERT_EQUAL(0, far_counter);
+    AVS_UNIT_ASSERT_NULL(near_task);
+    AVS_UNIT_ASSERT_NOT_NULL(far_task);
+
+    teardown_test(&env);
+}
+
 static void assert_executes_after_delay(sched_test_env_t *env,
                                         avs_time_duration_t delay) {
     avs_time_duration_t epsilon = avs_time_duration_from_scalar(1, AVS_TIME_MS);
@@ -299,3 +342,178 @@ AVS_UNIT_TEST(sched, retryable_job_handle_nullification) {
     AVS_UNIT_ASSERT_NULL(global.task);
     teardown_test(&env);
 }
+
+#define BACKLOG_SIZE 10000
+
+static void schedule_backlog(sched_test_env_t *env,
+                             anjay_sched_clb_t clb,
+                             int *counter) {
+    for (int i = 0; i < BACKLOG_SIZE; ++i) {
+        AVS_UNIT_ASSERT_SUCCESS(_anjay_sched_now(env->sched, NULL, clb,
+                                                 counter));
+    }
+}
+
+AVS_UNIT_TEST(sched, run_bounded_job_limit) {
+    sched_test_env_t env = setup_test();
+
+    int counter = 0;
+    schedule_backlog(&env, increment_task, &counter);
+
+    bool work_remaining = false;
+    for (int i = 1; i < BACKLOG_SIZE / 1000; ++i) {
+        AVS_UNIT_ASSERT_EQUAL(1000, _anjay_sched_run_bounded(
+                env.sched, 1000, AVS_TIME_DURATION_INVALID, &work_remaining));
+        AVS_UNIT_ASSERT_EQUAL(i * 1000, counter);
+        AVS_UNIT_ASSERT_TRUE(work_remaining);
+    }
+    AVS_UNIT_ASSERT_EQUAL(1000, _anjay_sched_run_bounded(
+            env.sched, 1000, AVS_TIME_DURATION_INVALID, &work_remaining));
+    AVS_UNIT_ASSERT_EQUAL(BACKLOG_SIZE, counter);
+    AVS_UNIT_ASSERT_FALSE(work_remaining);
+
+    AVS_UNIT_ASSERT_EQUAL(0, _anjay_sched_run_bounded(
+            env.sched, 1000, AVS_TIME_DURATION_INVALID, &work_remaining));
+    AVS_UNIT_ASSERT_FALSE(work_remaining);
+
+    teardown_test(&env);
+}
+
+static int increment_and_advance_clock_task(anjay_t *anjay,
+                                            void *counter_) {
+    _anjay_mock_clock_advance(avs_time_duration_from_scalar(1, AVS_TIME_MS));
+    return increment_task(anjay, counter_);
+}
+
+AVS_UNIT_TEST(sched, run_bounded_time_limit) {
+    sched_test_env_t env = setup_test();
+
+    int counter = 0;
+    schedule_backlog(&env, increment_and_advance_clock_task, &counter);
+
+    const avs_time_duration_t budget =
+            avs_time_duration_from_scalar(100, AVS_TIME_MS);
+    bool work_remaining = false;
+    AVS_UNIT_ASSERT_EQUAL(100, _anjay_sched_run_bounded(env.sched, 0, budget,
+                                                        &work_remaining));
+    AVS_UNIT_ASSERT_EQUAL(100, counter);
+    AVS_UNIT_ASSERT_TRUE(work_remaining);
+
+    // the remaining backlog drains in budget-sized chunks
+    int runs = 1;
+    while (work_remaining) {
+        AVS_UNIT_ASSERT_EQUAL(100, _anjay_sched_run_bounded(
+                env.sched, 0, budget, &work_remaining));
+        ++runs;
+    }
+    AVS_UNIT_ASSERT_EQUAL(BACKLOG_SIZE / 100, runs);
+    AVS_UNIT_ASSERT_EQUAL(BACKLOG_SIZE, counter);
+
+    teardown_test(&env);
+}
+
+AVS_UNIT_TEST(sched, run_bounded_always_makes_progress) {
+    sched_test_env_t env = setup_test();
+
+    int counter = 0;
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_sched_now(
+            env.sched, NULL, increment_and_advance_clock_task, &counter));
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_sched_now(
+            env.sched, NULL, increment_and_advance_clock_task, &counter));
+
+    bool work_remaining = false;
+    AVS_UNIT_ASSERT_EQUAL(1, _anjay_sched_run_bounded(
+            env.sched, 0, AVS_TIME_DURATION_ZERO, &work_remaining));
+    AVS_UNIT_ASSERT_EQUAL(1, counter);
+    AVS_UNIT_ASSERT_TRUE(work_remaining);
+
+    AVS_UNIT_ASSERT_EQUAL(1, _anjay_sched_run(env.sched));
+    AVS_UNIT_ASSERT_EQUAL(2, counter);
+
+    teardown_test(&env);
+}
+
+static avs_time_duration_t run_next_retry(sched_test_env_t *env) {
+    avs_time_duration_t time_to_next;
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_sched_time_to_next(env->sched,
+                                                      &time_to_next));
+    _anjay_mock_clock_advance(time_to_next);
+    AVS_UNIT_ASSERT_EQUAL(1, _anjay_sched_run(env->sched));
+    return time_to_next;
+}
+
+static void assert_duration_between(avs_time_duration_t value,
+                                    avs_time_duration_t low,
+                                    avs_time_duration_t high) {
+    avs_time_duration_t epsilon = avs_time_duration_from_scalar(1, AVS_TIME_MS);
+    AVS_UNIT_ASSERT_TRUE(avs_time_duration_less(
+            avs_time_duration_diff(low, epsilon), value));
+    AVS_UNIT_ASSERT_FALSE(avs_time_duration_less(high, value));
+}
+
+AVS_UNIT_TEST(sched, retryable_proportional_jitter) {
+    sched_test_env_t env = setup_test();
+
+    const anjay_sched_retryable_backoff_t backoff = {
+        .delay = avs_time_duration_from_scalar(1, AVS_TIME_S),
+        .max_delay = avs_time_duration_from_scalar(20, AVS_TIME_S),
+        .multiplier = 3.0,
+        .jitter_fraction = 0.5,
+        .jitter = ANJAY_BACKOFF_JITTER_PROPORTIONAL
+    };
+
+    int counter = 0;
+    anjay_sched_handle_t task = NULL;
+    AVS_UNIT_ASSERT_SUCCESS(
+            _anjay_sched_retryable(env.sched, &task, AVS_TIME_DURATION_ZERO,
+                                   backoff, increment_and_fail_task, &counter));
+    AVS_UNIT_ASSERT_EQUAL(1, _anjay_sched_run(env.sched));
+
+    // nominal delays: 1, 3, 9, then capped at 20 seconds
+    static const int64_t NOMINAL_MS[] = { 1000, 3000, 9000, 20000, 20000 };
+    bool all_nominal = true;
+    for (size_t i = 0; i < AVS_ARRAY_SIZE(NOMINAL_MS); ++i) {
+        avs_time_duration_t nominal =
+                avs_time_duration_from_scalar(NOMINAL_MS[i], AVS_TIME_MS);
+        avs_time_duration_t delay = run_next_retry(&env);
+        assert_duration_between(delay, avs_time_duration_div(nominal, 2),
+                                nominal);
+        all_nominal = all_nominal && avs_time_duration_equal(delay, nominal);
+    }
+    AVS_UNIT_ASSERT_FALSE(all_nominal);
+    AVS_UNIT_ASSERT_EQUAL(counter, 1 + (int) AVS_ARRAY_SIZE(NOMINAL_MS));
+
+    teardown_test(&env);
+}
+
+AVS_UNIT_TEST(sched, retryable_decorrelated_jitter) {
+    sched_test_env_t env = setup_test();
+
+    const anjay_sched_retryable_backoff_t backoff = {
+        .delay = avs_time_duration_from_scalar(1, AVS_TIME_S),
+        .max_delay = avs_time_duration_from_scalar(30, AVS_TIME_S),
+        .multiplier = 3.0,
+        .jitter = ANJAY_BACKOFF_JITTER_DECORRELATED,
+        .min_delay = avs_time_duration_from_scalar(1, AVS_TIME_S)
+    };
+
+    int counter = 0;
+    anjay_sched_handle_t task = NULL;
+    AVS_UNIT_ASSERT_SUCCESS(
+            _anjay_sched_retryable(env.sched, &task, AVS_TIME_DURATION_ZERO,
+                                   backoff, increment_and_fail_task, &counter));
+    AVS_UNIT_ASSERT_EQUAL(1, _anjay_sched_run(env.sched));
+
+    avs_time_duration_t previous = backoff.delay;
+    for (int i = 0; i < 20; ++i) {
+        avs_time_duration_t high = avs_time_duration_mul(previous, 3);
+        if (avs_time_duration_less(backoff.max_delay, high)) {
+            high = backoff.max_delay;
+        }
+        avs_time_duration_t delay = run_next_retry(&env);
+        assert_duration_between(delay, backoff.min_delay, high);
+        previous = delay;
+    }
+
+    teardown_test(&env);
+}
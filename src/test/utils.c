@@ -408,3 +408,29 @@ AVS_UNIT_TEST(binding_mode_from_str, unsupported_binding_mode) {
     AVS_UNIT_ASSERT_EQUAL(ANJAY_BINDING_NONE,
                           anjay_binding_mode_from_str("☃"));
 }
+
+AVS_UNIT_TEST(traffic_stats, rtt_samples) {
+    anjay_traffic_stats_t stats;
+    memset(&stats, 0, sizeof(stats));
+
+    _anjay_traffic_stats_add_rtt_sample(&stats,
+                                        avs_time_duration_from_scalar(
+                                                800, AVS_TIME_MS));
+    AVS_UNIT_ASSERT_EQUAL(stats.num_rtt_samples, 1);
+    AVS_UNIT_ASSERT_TRUE(avs_time_duration_equal(
+            stats.last_rtt, avs_time_duration_from_scalar(800, AVS_TIME_MS)));
+    AVS_UNIT_ASSERT_TRUE(avs_time_duration_equal(
+            stats.smoothed_rtt,
+            avs_time_duration_from_scalar(800, AVS_TIME_MS)));
+
+    _anjay_traffic_stats_add_rtt_sample(&stats,
+                                        avs_time_duration_from_scalar(
+                                                1600, AVS_TIME_MS));
+    AVS_UNIT_ASSERT_EQUAL(stats.num_rtt_samples, 2);
+    AVS_UNIT_ASSERT_TRUE(avs_time_duration_equal(
+            stats.last_rtt, avs_time_duration_from_scalar(1600, AVS_TIME_MS)));
+    // 7/8 * 800ms + 1/8 * 1600ms
+    AVS_UNIT_ASSERT_TRUE(avs_time_duration_equal(
+            stats.smoothed_rtt,
+            avs_time_duration_from_scalar(900, AVS_TIME_MS)));
+}
@@ -490,6 +490,21 @@ fail:
     return NULL;
 }
 
+void _anjay_traffic_stats_add_rtt_sample(anjay_traffic_stats_t *stats,
+                                         avs_time_duration_t rtt) {
+    if (!stats->num_rtt_samples) {
+        stats->smoothed_rtt = rtt;
+    } else {
+        // SRTT = 7/8 * SRTT + 1/8 * R
+        stats->smoothed_rtt = avs_time_duration_div(
+                avs_time_duration_add(
+                        avs_time_duration_mul(stats->smoothed_rtt, 7), rtt),
+                8);
+    }
+    stats->last_rtt = rtt;
+    ++stats->num_rtt_samples;
+}
+
 #ifdef ANJAY_TEST
 #include "test/utils.c"
 #endif // ANJAY_TEST
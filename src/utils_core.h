@@ -22,6 +22,7 @@
 #include <anjay_modules/raw_buffer.h>
 
 #include <anjay/dm.h>
+#include <anjay/stats.h>
 
 #include <stdbool.h>
 #include <stddef.h>
@@ -109,6 +110,13 @@ static inline size_t _anjay_max_power_of_2_not_greater_than(size_t bound) {
     return (exponent >= 0) ? ((size_t) 1 << exponent) : 0;
 }
 
+/**
+ * Records @p rtt as the most recent round-trip time sample in @p stats and
+ * updates the smoothed RTT estimate, as described in RFC 6298.
+ */
+void _anjay_traffic_stats_add_rtt_sample(anjay_traffic_stats_t *stats,
+                                         avs_time_duration_t rtt);
+
 VISIBILITY_PRIVATE_HEADER_END
 
 #endif // ANJAY_UTILS_H
@@ -0,0 +1,882 @@
+/*
+ * Copyright 2017 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Startup and first-registration benchmark.
+ *
+ * Measures the time and number of heap allocations spent in each phase of
+ * bringing up an Anjay client: creating the Anjay object, installing modules,
+ * registering Objects, restoring persisted state, connecting and finally
+ * completing Register with every configured server. The servers are simulated
+ * by a thread answering on loopback UDP sockets, so that the measured path
+ * includes the real socket and CoAP code.
+ */
+
+#define _GNU_SOURCE
+
+#include <arpa/inet.h>
+#include <getopt.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <avsystem/commons/list.h>
+#include <avsystem/commons/log.h>
+#include <avsystem/commons/net.h>
+#include <avsystem/commons/stream/stream_inbuf.h>
+#include <avsystem/commons/stream/stream_outbuf.h>
+
+#include <anjay/anjay.h>
+#include <anjay/attr_storage.h>
+#include <anjay/security.h>
+#include <anjay/server.h>
+
+#define BENCH_OID_BASE 1000
+#define REGISTER_TIMEOUT_MS 10000
+
+/**************************** allocation counting ****************************/
+
+static uint64_t ALLOC_COUNT;
+
+#ifdef __GLIBC__
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t nmemb, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void __libc_free(void *ptr);
+
+void *malloc(size_t size) {
+    __atomic_add_fetch(&ALLOC_COUNT, 1, __ATOMIC_RELAXED);
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t nmemb, size_t size) {
+    __atomic_add_fetch(&ALLOC_COUNT, 1, __ATOMIC_RELAXED);
+    return __libc_calloc(nmemb, size);
+}
+
+void *realloc(void *ptr, size_t size) {
+    __atomic_add_fetch(&ALLOC_COUNT, 1, __ATOMIC_RELAXED);
+    return __libc_realloc(ptr, size);
+}
+
+void free(void *ptr) {
+    __libc_free(ptr);
+}
+#endif // __GLIBC__
+
+static uint64_t alloc_count(void) {
+    return __atomic_load_n(&ALLOC_COUNT, __ATOMIC_RELAXED);
+}
+
+/********************************** timing ***********************************/
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000 + (uint64_t) ts.tv_nsec;
+}
+
+typedef enum {
+    PHASE_ANJAY_NEW,
+    PHASE_MODULES,
+    PHASE_REGISTER_OBJECTS,
+    PHASE_RESTORE,
+    PHASE_CONNECT,
+    PHASE_REGISTER,
+    PHASE_COUNT_
+} phase_t;
+
+static const char *const PHASE_NAMES[] = {
+    [PHASE_ANJAY_NEW] = "anjay_new",
+    [PHASE_MODULES] = "module installation",
+    [PHASE_REGISTER_OBJECTS] = "object registration",
+    [PHASE_RESTORE] = "persistence restore",
+    [PHASE_CONNECT] = "connect + build Register",
+    [PHASE_REGISTER] = "Register exchange"
+};
+
+typedef struct {
+    uint64_t ns_total;
+    uint64_t ns_min;
+    uint64_t ns_max;
+    uint64_t allocs_total;
+} phase_stats_t;
+
+typedef struct {
+    uint64_t ns;
+    uint64_t allocs;
+} checkpoint_t;
+
+static checkpoint_t checkpoint(void) {
+    return (checkpoint_t) {
+        .ns = now_ns(),
+        .allocs = alloc_count()
+    };
+}
+
+static void record_phase(phase_stats_t *stats,
+                         const checkpoint_t *begin,
+                         const checkpoint_t *end) {
+    uint64_t ns = end->ns - begin->ns;
+    stats->ns_total += ns;
+    if (!stats->ns_min || ns < stats->ns_min) {
+        stats->ns_min = ns;
+    }
+    if (ns > stats->ns_max) {
+        stats->ns_max = ns;
+    }
+    stats->allocs_total += end->allocs - begin->allocs;
+}
+
+/************************** simulated LwM2M servers **************************/
+
+#define COAP_TYPE_CON 0
+#define COAP_TYPE_ACK 2
+
+#define COAP_CODE(Class, Detail) ((uint8_t) (((Class) << 5) | (Detail)))
+#define COAP_CODE_POST COAP_CODE(0, 2)
+#define COAP_CODE_DELETE COAP_CODE(0, 4)
+#define COAP_CODE_CREATED COAP_CODE(2, 1)
+#define COAP_CODE_DELETED COAP_CODE(2, 2)
+#define COAP_CODE_CHANGED COAP_CODE(2, 4)
+#define COAP_CODE_CONTINUE COAP_CODE(2, 31)
+
+#define COAP_OPT_LOCATION_PATH 8
+#define COAP_OPT_BLOCK1 27
+
+typedef struct {
+    size_t num_servers;
+    int *fds;
+    uint16_t *ports;
+    pthread_t thread;
+    bool stop;
+
+    /* reset by the main thread before every iteration */
+    size_t registered;
+    uint64_t first_packet_ns;
+    uint64_t first_packet_allocs;
+} responder_t;
+
+static int read_option_ext(const uint8_t **ptr,
+                           const uint8_t *end,
+                           unsigned nibble,
+                           uint32_t *out) {
+    if (nibble < 13) {
+        *out = nibble;
+    } else if (nibble == 13 && *ptr < end) {
+        *out = 13u + *(*ptr)++;
+    } else if (nibble == 14 && *ptr + 1 < end) {
+        *out = 269u + (uint32_t) (((*ptr)[0] << 8) | (*ptr)[1]);
+        *ptr += 2;
+    } else {
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * Finds the Block1 option in a CoAP message. Returns 1 and fills @p out_value
+ * if present, 0 if absent and -1 if the message is malformed.
+ */
+static int find_block1(const uint8_t *msg,
+                       size_t msg_size,
+                       const uint8_t **out_value,
+                       size_t *out_length) {
+    const uint8_t *ptr = msg + 4 + (msg[0] & 0x0F);
+    const uint8_t *end = msg + msg_size;
+    uint32_t number = 0;
+    while (ptr < end && *ptr != 0xFF) {
+        uint32_t delta;
+        uint32_t length;
+        uint8_t header = *ptr++;
+        if (read_option_ext(&ptr, end, header >> 4, &delta)
+                || read_option_ext(&ptr, end, header & 0x0F, &length)
+                || (size_t) (end - ptr) < length) {
+            return -1;
+        }
+        number += delta;
+        if (number == COAP_OPT_BLOCK1) {
+            *out_value = ptr;
+            *out_length = length;
+            return 1;
+        }
+        ptr += length;
+    }
+    return 0;
+}
+
+static size_t write_option(uint8_t *out,
+                           uint32_t delta,
+                           const uint8_t *value,
+                           size_t length) {
+    /* only deltas and lengths below 269 are ever needed here */
+    size_t size = 1;
+    uint8_t delta_nibble = (uint8_t) (delta < 13 ? delta : 13);
+    uint8_t length_nibble = (uint8_t) (length < 13 ? length : 13);
+    out[0] = (uint8_t) ((delta_nibble << 4) | length_nibble);
+    if (delta >= 13) {
+        out[size++] = (uint8_t) (delta - 13);
+    }
+    if (length >= 13) {
+        out[size++] = (uint8_t) (length - 13);
+    }
+    memcpy(out + size, value, length);
+    return size + length;
+}
+
+static void handle_request(responder_t *responder,
+                           int fd,
+                           const uint8_t *msg,
+                           size_t msg_size,
+                           const struct sockaddr_storage *addr,
+                           socklen_t addr_len) {
+    size_t token_length = msg[0] & 0x0F;
+    if (msg_size < 4 + token_length
+            || ((msg[0] >> 4) & 0x03) != COAP_TYPE_CON) {
+        return;
+    }
+
+    uint8_t response[64];
+    size_t size = 4 + token_length;
+    response[0] = (uint8_t) (0x40 | (COAP_TYPE_ACK << 4) | token_length);
+    memcpy(&response[2], &msg[2], 2 + token_length);
+
+    bool registered = false;
+    if (msg[1] == COAP_CODE_POST) {
+        const uint8_t *block1;
+        size_t block1_length;
+        int result = find_block1(msg, msg_size, &block1, &block1_length);
+        if (result < 0) {
+            return;
+        }
+        if (result > 0 && block1_length > 0 && block1_length <= 3
+                && (block1[block1_length - 1] & 0x08)) {
+            response[1] = COAP_CODE_CONTINUE;
+            size += write_option(&response[size], COAP_OPT_BLOCK1,
+                                 block1, block1_length);
+        } else {
+            char location[16];
+            int location_length = snprintf(location, sizeof(location), "%d",
+                                           fd);
+            response[1] = COAP_CODE_CREATED;
+            size += write_option(&response[size], COAP_OPT_LOCATION_PATH,
+                                 (const uint8_t *) "rd", 2);
+            size += write_option(&response[size], 0,
+                                 (const uint8_t *) location,
+                                 (size_t) location_length);
+            registered = true;
+        }
+    } else if (msg[1] == COAP_CODE_DELETE) {
+        response[1] = COAP_CODE_DELETED;
+    } else {
+        response[1] = COAP_CODE_CHANGED;
+    }
+
+    sendto(fd, response, size, 0, (const struct sockaddr *) addr, addr_len);
+    if (registered) {
+        __atomic_add_fetch(&responder->registered, 1, __ATOMIC_RELEASE);
+    }
+}
+
+static void *responder_thread(void *responder_) {
+    responder_t *responder = (responder_t *) responder_;
+    struct pollfd pollfds[responder->num_servers];
+    for (size_t i = 0; i < responder->num_servers; ++i) {
+        pollfds[i].fd = responder->fds[i];
+        pollfds[i].events = POLLIN;
+    }
+
+    while (!__atomic_load_n(&responder->stop, __ATOMIC_ACQUIRE)) {
+        if (poll(pollfds, responder->num_servers, 100) <= 0) {
+            continue;
+        }
+        for (size_t i = 0; i < responder->num_servers; ++i) {
+            if (!(pollfds[i].revents & POLLIN)) {
+                continue;
+            }
+            uint8_t msg[4096];
+            struct sockaddr_storage addr;
+            socklen_t addr_len = sizeof(addr);
+            ssize_t received = recvfrom(pollfds[i].fd, msg, sizeof(msg), 0,
+                                        (struct sockaddr *) &addr, &addr_len);
+            if (received < 4) {
+                continue;
+            }
+            uint64_t expected = 0;
+            uint64_t timestamp = now_ns();
+            if (__atomic_compare_exchange_n(&responder->first_packet_ns,
+                                            &expected, timestamp, false,
+                                            __ATOMIC_ACQ_REL,
+                                            __ATOMIC_ACQUIRE)) {
+                __atomic_store_n(&responder->first_packet_allocs,
+                                 alloc_count(), __ATOMIC_RELEASE);
+            }
+            handle_request(responder, pollfds[i].fd, msg, (size_t) received,
+                           &addr, addr_len);
+        }
+    }
+    return NULL;
+}
+
+static int responder_start(responder_t *responder, size_t num_servers) {
+    memset(responder, 0, sizeof(*responder));
+    responder->num_servers = num_servers;
+    responder->fds = (int *) calloc(num_servers, sizeof(int));
+    responder->ports = (uint16_t *) calloc(num_servers, sizeof(uint16_t));
+    if (!responder->fds || !responder->ports) {
+        return -1;
+    }
+    for (size_t i = 0; i < num_servers; ++i) {
+        struct sockaddr_in addr;
+        socklen_t addr_len = sizeof(addr);
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if ((responder->fds[i] = socket(AF_INET, SOCK_DGRAM, 0)) < 0
+                || bind(responder->fds[i], (struct sockaddr *) &addr,
+                        sizeof(addr))
+                || getsockname(responder->fds[i], (struct sockaddr *) &addr,
+                               &addr_len)) {
+            perror("cannot create server socket");
+            return -1;
+        }
+        responder->ports[i] = ntohs(addr.sin_port);
+    }
+    if (pthread_create(&responder->thread, NULL, responder_thread,
+                       responder)) {
+        fprintf(stderr, "cannot start responder thread\n");
+        return -1;
+    }
+    return 0;
+}
+
+static void responder_stop(responder_t *responder) {
+    __atomic_store_n(&responder->stop, true, __ATOMIC_RELEASE);
+    pthread_join(responder->thread, NULL);
+    for (size_t i = 0; i < responder->num_servers; ++i) {
+        close(responder->fds[i]);
+    }
+    free(responder->fds);
+    free(responder->ports);
+}
+
+static void responder_reset(responder_t *responder) {
+    __atomic_store_n(&responder->registered, 0, __ATOMIC_RELEASE);
+    __atomic_store_n(&responder->first_packet_allocs, 0, __ATOMIC_RELEASE);
+    __atomic_store_n(&responder->first_packet_ns, 0, __ATOMIC_RELEASE);
+}
+
+/***************************** benchmark objects *****************************/
+
+typedef struct {
+    const anjay_dm_object_def_t *def;
+    anjay_dm_object_def_t storage;
+    uint16_t num_instances;
+} bench_object_t;
+
+static const uint16_t BENCH_RIDS[] = { 0, 1, 2 };
+
+static const bench_object_t *get_bench_object(
+        const anjay_dm_object_def_t *const *obj_ptr) {
+    return (const bench_object_t *) ((const char *) obj_ptr
+                                     - offsetof(bench_object_t, def));
+}
+
+static int bench_instance_it(anjay_t *anjay,
+                             const anjay_dm_object_def_t *const *obj_ptr,
+                             anjay_iid_t *out,
+                             void **cookie) {
+    (void) anjay;
+    uintptr_t index = (uintptr_t) *cookie;
+    if (index < get_bench_object(obj_ptr)->num_instances) {
+        *out = (anjay_iid_t) index;
+        *cookie = (void *) (index + 1);
+    } else {
+        *out = ANJAY_IID_INVALID;
+    }
+    return 0;
+}
+
+static int bench_instance_present(anjay_t *anjay,
+                                  const anjay_dm_object_def_t *const *obj_ptr,
+                                  anjay_iid_t iid) {
+    (void) anjay;
+    return iid < get_bench_object(obj_ptr)->num_instances;
+}
+
+static int bench_resource_read(anjay_t *anjay,
+                               const anjay_dm_object_def_t *const *obj_ptr,
+                               anjay_iid_t iid,
+                               anjay_rid_t rid,
+                               anjay_output_ctx_t *ctx) {
+    (void) anjay;
+    (void) obj_ptr;
+    return anjay_ret_i32(ctx, (int32_t) (iid + rid));
+}
+
+static bench_object_t *create_bench_objects(size_t num_objects,
+                                            uint16_t num_instances) {
+    bench_object_t *objects =
+            (bench_object_t *) calloc(num_objects, sizeof(bench_object_t));
+    if (!objects) {
+        return NULL;
+    }
+    for (size_t i = 0; i < num_objects; ++i) {
+        objects[i].storage.oid = (anjay_oid_t) (BENCH_OID_BASE + i);
+        objects[i].storage.supported_rids.count =
+                sizeof(BENCH_RIDS) / sizeof(BENCH_RIDS[0]);
+        objects[i].storage.supported_rids.rids = BENCH_RIDS;
+        objects[i].storage.handlers.instance_it = bench_instance_it;
+        objects[i].storage.handlers.instance_present = bench_instance_present;
+        objects[i].storage.handlers.resource_present =
+                anjay_dm_resource_present_TRUE;
+        objects[i].storage.handlers.resource_read = bench_resource_read;
+        objects[i].def = &objects[i].storage;
+        objects[i].num_instances = num_instances;
+    }
+    return objects;
+}
+
+/******************************** benchmark *********************************/
+
+typedef struct {
+    size_t num_objects;
+    uint16_t num_instances;
+    size_t num_servers;
+    size_t iterations;
+} bench_config_t;
+
+typedef struct {
+    uint8_t *data;
+    size_t size;
+} snapshot_t;
+
+typedef struct {
+    const bench_config_t *config;
+    responder_t responder;
+    bench_object_t *objects;
+    /* Security, Server, bench Objects - in this order */
+    const anjay_dm_object_def_t *const **def_ptrs;
+    snapshot_t security_snapshot;
+    snapshot_t server_snapshot;
+    snapshot_t attr_storage_snapshot;
+    phase_stats_t stats[PHASE_COUNT_];
+} bench_t;
+
+static const anjay_configuration_t ANJAY_CONFIG = {
+    .endpoint_name = "urn:dev:os:anjay-startup-benchmark",
+    .in_buffer_size = 4000,
+    .out_buffer_size = 1024
+};
+
+typedef int persist_object_t(const anjay_dm_object_def_t *const *obj,
+                             avs_stream_abstract_t *out_stream);
+
+static int take_snapshot(snapshot_t *out,
+                         size_t capacity,
+                         persist_object_t *persist_object,
+                         const anjay_dm_object_def_t *const *obj,
+                         anjay_t *anjay) {
+    if (!(out->data = (uint8_t *) malloc(capacity))) {
+        return -1;
+    }
+    avs_stream_outbuf_t outbuf = AVS_STREAM_OUTBUF_STATIC_INITIALIZER;
+    avs_stream_outbuf_set_buffer(&outbuf, out->data, capacity);
+    int result = persist_object
+            ? persist_object(obj, (avs_stream_abstract_t *) &outbuf)
+            : anjay_attr_storage_persist(anjay,
+                                         (avs_stream_abstract_t *) &outbuf);
+    out->size = avs_stream_outbuf_offset(&outbuf);
+    return result;
+}
+
+static int fill_security_object(const bench_t *bench,
+                                const anjay_dm_object_def_t *const *obj) {
+    for (size_t i = 0; i < bench->config->num_servers; ++i) {
+        char uri[64];
+        snprintf(uri, sizeof(uri), "coap://127.0.0.1:%u",
+                 (unsigned) bench->responder.ports[i]);
+        const anjay_security_instance_t instance = {
+            .ssid = (anjay_ssid_t) (i + 1),
+            .server_uri = uri,
+            .security_mode = ANJAY_UDP_SECURITY_NOSEC,
+            .client_holdoff_s = -1,
+            .bootstrap_timeout_s = -1
+        };
+        anjay_iid_t iid = (anjay_iid_t) i;
+        if (anjay_security_object_add_instance(obj, &instance, &iid)) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static int fill_server_object(const bench_t *bench,
+                              const anjay_dm_object_def_t *const *obj) {
+    for (size_t i = 0; i < bench->config->num_servers; ++i) {
+        const anjay_server_instance_t instance = {
+            .ssid = (anjay_ssid_t) (i + 1),
+            .lifetime = 86400,
+            .default_min_period = -1,
+            .default_max_period = -1,
+            .disable_timeout = -1,
+            .binding = ANJAY_BINDING_U,
+            .notification_storing = false
+        };
+        anjay_iid_t iid = (anjay_iid_t) i;
+        if (anjay_server_object_add_instance(obj, &instance, &iid)) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static int fill_attr_storage(const bench_t *bench, anjay_t *anjay) {
+    const anjay_dm_attributes_t attrs = {
+        .min_period = 1,
+        .max_period = 3600
+    };
+    for (size_t i = 0; i < bench->config->num_objects; ++i) {
+        for (uint16_t iid = 0; iid < bench->config->num_instances; ++iid) {
+            if (anjay_attr_storage_set_instance_attrs(
+                    anjay, 1, (anjay_oid_t) (BENCH_OID_BASE + i), iid,
+                    &attrs)) {
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+/**
+ * Builds the persisted state that every iteration restores: Security and
+ * Server Instances pointing at the simulated servers, and Instance-level
+ * attributes for every benchmark Object Instance.
+ */
+static int prepare_snapshots(bench_t *bench) {
+    const bench_config_t *config = bench->config;
+    const size_t num_objects = config->num_objects + 2;
+    const size_t objects_capacity =
+            1024 + config->num_objects * config->num_instances * 64;
+    const size_t servers_capacity = 1024 + config->num_servers * 256;
+
+    const anjay_dm_object_def_t **security = anjay_security_object_create();
+    const anjay_dm_object_def_t **server = anjay_server_object_create();
+    anjay_t *anjay = anjay_new(&ANJAY_CONFIG);
+    int result = -1;
+    if (!security || !server || !anjay
+            || fill_security_object(bench, security)
+            || fill_server_object(bench, server)
+            || anjay_attr_storage_install(anjay)
+            || anjay_register_objects(anjay, bench->def_ptrs + 2,
+                                      num_objects - 2)
+            || fill_attr_storage(bench, anjay)
+            || take_snapshot(&bench->security_snapshot, servers_capacity,
+                             anjay_security_object_persist, security, NULL)
+            || take_snapshot(&bench->server_snapshot, servers_capacity,
+                             anjay_server_object_persist, server, NULL)
+            || take_snapshot(&bench->attr_storage_snapshot, objects_capacity,
+                             NULL, NULL, anjay)) {
+        fprintf(stderr, "cannot prepare persisted state\n");
+    } else {
+        result = 0;
+    }
+    if (anjay) {
+        anjay_delete(anjay);
+    }
+    if (security) {
+        anjay_security_object_delete(security);
+    }
+    if (server) {
+        anjay_server_object_delete(server);
+    }
+    return result;
+}
+
+typedef int restore_object_t(const anjay_dm_object_def_t *const *obj,
+                             avs_stream_abstract_t *in_stream);
+
+static int restore_snapshot(const snapshot_t *snapshot,
+                            restore_object_t *restore_object,
+                            const anjay_dm_object_def_t *const *obj,
+                            anjay_t *anjay) {
+    avs_stream_inbuf_t inbuf = AVS_STREAM_INBUF_STATIC_INITIALIZER;
+    avs_stream_inbuf_set_buffer(&inbuf, snapshot->data, snapshot->size);
+    return restore_object
+            ? restore_object(obj, (avs_stream_abstract_t *) &inbuf)
+            : anjay_attr_storage_restore(anjay,
+                                         (avs_stream_abstract_t *) &inbuf);
+}
+
+static void serve_sockets(anjay_t *anjay, int timeout_ms) {
+    struct pollfd pollfds[64];
+    avs_net_abstract_socket_t *sockets[64];
+    nfds_t count = 0;
+    AVS_LIST(avs_net_abstract_socket_t *const) socket;
+    AVS_LIST_FOREACH(socket, anjay_get_sockets(anjay)) {
+        if (count == sizeof(pollfds) / sizeof(pollfds[0])) {
+            break;
+        }
+        sockets[count] = *socket;
+        pollfds[count].fd = *(const int *) avs_net_socket_get_system(*socket);
+        pollfds[count].events = POLLIN;
+        ++count;
+    }
+    if (poll(pollfds, count, timeout_ms) > 0) {
+        for (nfds_t i = 0; i < count; ++i) {
+            if (pollfds[i].revents & POLLIN) {
+                anjay_serve(anjay, sockets[i]);
+            }
+        }
+    }
+}
+
+static int run_iteration(bench_t *bench) {
+    const size_t num_objects = bench->config->num_objects + 2;
+    const anjay_dm_object_def_t **security = NULL;
+    const anjay_dm_object_def_t **server = NULL;
+    anjay_t *anjay = NULL;
+    int result = -1;
+    checkpoint_t marks[PHASE_COUNT_ + 1];
+
+    responder_reset(&bench->responder);
+
+    marks[PHASE_ANJAY_NEW] = checkpoint();
+    if (!(anjay = anjay_new(&ANJAY_CONFIG))) {
+        fprintf(stderr, "could not create Anjay object\n");
+        goto finish;
+    }
+
+    marks[PHASE_MODULES] = checkpoint();
+    if (anjay_attr_storage_install(anjay)
+            || !(security = anjay_security_object_create())
+            || !(server = anjay_server_object_create())) {
+        fprintf(stderr, "could not install modules\n");
+        goto finish;
+    }
+
+    marks[PHASE_REGISTER_OBJECTS] = checkpoint();
+    bench->def_ptrs[0] = security;
+    bench->def_ptrs[1] = server;
+    if (anjay_register_objects(anjay, bench->def_ptrs, num_objects)) {
+        fprintf(stderr, "could not register Objects\n");
+        goto finish;
+    }
+
+    marks[PHASE_RESTORE] = checkpoint();
+    if (restore_snapshot(&bench->security_snapshot,
+                         anjay_security_object_restore, security, NULL)
+            || restore_snapshot(&bench->server_snapshot,
+                                anjay_server_object_restore, server, NULL)
+            || restore_snapshot(&bench->attr_storage_snapshot,
+                                NULL, NULL, anjay)) {
+        fprintf(stderr, "could not restore persisted state\n");
+        goto finish;
+    }
+
+    marks[PHASE_CONNECT] = checkpoint();
+    while (__atomic_load_n(&bench->responder.registered, __ATOMIC_ACQUIRE)
+            < bench->config->num_servers) {
+        if (now_ns() - marks[PHASE_CONNECT].ns
+                > (uint64_t) REGISTER_TIMEOUT_MS * 1000000) {
+            fprintf(stderr, "timed out waiting for registration\n");
+            goto finish;
+        }
+        if (anjay_sched_run(anjay) < 0) {
+            fprintf(stderr, "anjay_sched_run failed\n");
+            goto finish;
+        }
+        serve_sockets(anjay, anjay_sched_calculate_wait_time_ms(anjay, 1));
+    }
+    marks[PHASE_COUNT_] = checkpoint();
+    marks[PHASE_REGISTER] = (checkpoint_t) {
+        .ns = __atomic_load_n(&bench->responder.first_packet_ns,
+                              __ATOMIC_ACQUIRE),
+        .allocs = __atomic_load_n(&bench->responder.first_packet_allocs,
+                                  __ATOMIC_ACQUIRE)
+    };
+
+    for (int phase = 0; phase < PHASE_COUNT_; ++phase) {
+        record_phase(&bench->stats[phase], &marks[phase], &marks[phase + 1]);
+    }
+    result = 0;
+
+finish:
+    if (anjay) {
+        anjay_delete(anjay);
+    }
+    if (security) {
+        anjay_security_object_delete(security);
+    }
+    if (server) {
+        anjay_server_object_delete(server);
+    }
+    return result;
+}
+
+static void print_stats(const bench_t *bench) {
+    const double iterations = (double) bench->config->iterations;
+    printf("objects: %zu, instances per object: %u, servers: %zu, "
+           "iterations: %zu\n\n",
+           bench->config->num_objects,
+           (unsigned) bench->config->num_instances,
+           bench->config->num_servers, bench->config->iterations);
+    printf("%-26s %12s %12s %12s %14s\n",
+           "phase", "mean [ms]", "min [ms]", "max [ms]", "allocations");
+
+    phase_stats_t total = { 0, 0, 0, 0 };
+    for (int phase = 0; phase < PHASE_COUNT_; ++phase) {
+        const phase_stats_t *stats = &bench->stats[phase];
+        printf("%-26s %12.3f %12.3f %12.3f %14.1f\n",
+               PHASE_NAMES[phase],
+               (double) stats->ns_total / iterations / 1e6,
+               (double) stats->ns_min / 1e6,
+               (double) stats->ns_max / 1e6,
+               (double) stats->allocs_total / iterations);
+        total.ns_total += stats->ns_total;
+        total.allocs_total += stats->allocs_total;
+    }
+    printf("%-26s %12.3f %12s %12s %14.1f\n",
+           "total", (double) total.ns_total / iterations / 1e6, "", "",
+           (double) total.allocs_total / iterations);
+}
+
+static void print_usage(const char *argv0) {
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  -o, --objects N      number of benchmark Objects (default: 10)\n"
+            "  -i, --instances N    Instances per Object (default: 10)\n"
+            "  -s, --servers N      number of LwM2M servers (default: 1)\n"
+            "  -n, --iterations N   number of measured startups (default: 10)\n"
+            "  -h, --help           print this message\n",
+            argv0);
+}
+
+static int parse_size(const char *str, size_t max, size_t *out) {
+    char *endptr;
+    unsigned long long value = strtoull(str, &endptr, 10);
+    if (!*str || *endptr || value > max) {
+        return -1;
+    }
+    *out = (size_t) value;
+    return 0;
+}
+
+static int parse_args(int argc, char **argv, bench_config_t *config) {
+    static const struct option OPTIONS[] = {
+        { "objects", required_argument, NULL, 'o' },
+        { "instances", required_argument, NULL, 'i' },
+        { "servers", required_argument, NULL, 's' },
+        { "iterations", required_argument, NULL, 'n' },
+        { "help", no_argument, NULL, 'h' },
+        { NULL, 0, NULL, 0 }
+    };
+    size_t instances = config->num_instances;
+    int opt;
+    while ((opt = getopt_long(argc, argv, "o:i:s:n:h", OPTIONS, NULL)) != -1) {
+        int result = -1;
+        switch (opt) {
+        case 'o':
+            result = parse_size(optarg, UINT16_MAX - BENCH_OID_BASE,
+                                &config->num_objects);
+            break;
+        case 'i':
+            result = parse_size(optarg, ANJAY_IID_INVALID - 1, &instances);
+            break;
+        case 's':
+            result = parse_size(optarg, UINT16_MAX - 1, &config->num_servers);
+            break;
+        case 'n':
+            result = parse_size(optarg, SIZE_MAX, &config->iterations);
+            break;
+        default:
+            break;
+        }
+        if (result) {
+            print_usage(argv[0]);
+            return -1;
+        }
+    }
+    if (optind < argc || !config->num_servers || !config->iterations) {
+        print_usage(argv[0]);
+        return -1;
+    }
+    config->num_instances = (uint16_t) instances;
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    bench_config_t config = {
+        .num_objects = 10,
+        .num_instances = 10,
+        .num_servers = 1,
+        .iterations = 10
+    };
+    if (parse_args(argc, argv, &config)) {
+        return 1;
+    }
+    avs_log_set_default_level(AVS_LOG_QUIET);
+
+    bench_t bench;
+    memset(&bench, 0, sizeof(bench));
+    bench.config = &config;
+
+    int result = 1;
+    if (responder_start(&bench.responder, config.num_servers)) {
+        return 1;
+    }
+    if (!(bench.objects = create_bench_objects(config.num_objects,
+                                               config.num_instances))
+            || !(bench.def_ptrs = (const anjay_dm_object_def_t *const **)
+                         calloc(config.num_objects + 2,
+                                sizeof(*bench.def_ptrs)))) {
+        fprintf(stderr, "out of memory\n");
+        goto finish;
+    }
+    for (size_t i = 0; i < config.num_objects; ++i) {
+        bench.def_ptrs[i + 2] = &bench.objects[i].def;
+    }
+    if (prepare_snapshots(&bench)) {
+        goto finish;
+    }
+
+    for (size_t i = 0; i < config.iterations; ++i) {
+        if (run_iteration(&bench)) {
+            fprintf(stderr, "iteration %zu failed\n", i);
+            goto finish;
+        }
+    }
+    print_stats(&bench);
+    result = 0;
+
+finish:
+    responder_stop(&bench.responder);
+    free(bench.security_snapshot.data);
+    free(bench.server_snapshot.data);
+    free(bench.attr_storage_snapshot.data);
+    free(bench.def_ptrs);
+    free(bench.objects);
+    return result;
+}
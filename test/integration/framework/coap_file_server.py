@@ -62,6 +62,10 @@ class CoapFileServer:
         return '%s://127.0.0.1:%d%s' % (proto, self._server.get_listen_port(), path)
 
 
+    def send_reset(self, req):
+        self._server.send(Lwm2mReset.matching(req).fill_placeholders())
+
+
     def _recv_request(self):
         if isinstance(self._server, coap.DtlsServer):
             try:
@@ -0,0 +1,446 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+#
+# Copyright 2017 AVSystem <avsystem@avsystem.com>
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""
+Load generator for the demo client.
+
+Spawns one or more demo processes, each connected over loopback to its own
+stand-in LwM2M Server from the integration test framework, and issues a
+weighted mix of Read, Write, Observe and Execute requests at a fixed total
+rate. Requests are sent on schedule regardless of whether previous ones have
+been answered, so that slow responses show up in the latency figures instead
+of silently lowering the request rate.
+
+At the end, the following is reported for each operation type: latency
+percentiles, error responses, timeouts and retransmissions of our requests.
+Messages retransmitted by the clients (e.g. Confirmable Notifications whose
+ACKs got lost) are counted separately.
+
+Notification delivery lag is measured from the response to the earliest Write
+or Execute not yet followed by a Notification, to the arrival of that
+Notification. It is only meaningful if the Observed Resource is the one
+modified by them - which is the case for the default paths, referring to the
+Counter Resource of the demo Test Object. Note that the lag includes the
+Minimum Period, if set.
+
+Example:
+
+    ./loadgen.py --client ../../output/bin/demo --endpoints 4 --rate 200 \\
+            --duration 60 --mix read=6,write=2,observe=1,execute=1
+"""
+
+import argparse
+import binascii
+import collections
+import os
+import random
+import re
+import socket
+import subprocess
+import sys
+import threading
+import time
+
+sys.path.append(os.path.dirname(os.path.abspath(__file__)))
+
+from framework.lwm2m import coap
+from framework.lwm2m.messages import *
+from framework.lwm2m.server import Lwm2mServer
+from framework.test_suite import read_until_match
+
+# RFC 7252, 4.8. Transmission Parameters
+ACK_TIMEOUT_S = 2.0
+ACK_RANDOM_FACTOR = 1.5
+MAX_RETRANSMIT = 4
+
+OPERATIONS = ('read', 'write', 'observe', 'execute')
+MODIFYING_OPERATIONS = ('write', 'execute')
+
+# number of recently received message IDs remembered for duplicate detection
+RECENT_MSG_IDS = 256
+
+
+def parse_mix(text):
+    mix = {}
+    for item in text.split(','):
+        op, _, weight = item.partition('=')
+        op = op.strip()
+        if op not in OPERATIONS:
+            raise argparse.ArgumentTypeError('unknown operation: %s' % (op,))
+        mix[op] = float(weight) if weight else 1.0
+    if not any(weight > 0 for weight in mix.values()):
+        raise argparse.ArgumentTypeError('at least one weight must be positive')
+    return mix
+
+
+def percentile(sorted_values, fraction):
+    if not sorted_values:
+        return float('nan')
+    index = min(len(sorted_values) - 1, int(fraction * len(sorted_values)))
+    return sorted_values[index]
+
+
+class Stats:
+    def __init__(self):
+        self.sent = collections.Counter()
+        self.latencies_s = collections.defaultdict(list)
+        self.errors = collections.Counter()
+        self.timeouts = collections.Counter()
+        self.retransmissions = collections.Counter()
+        self.client_duplicates = 0
+        self.notifications = 0
+        self.notify_lags_s = []
+
+    def merge(self, other):
+        self.sent.update(other.sent)
+        for op, latencies in other.latencies_s.items():
+            self.latencies_s[op].extend(latencies)
+        self.errors.update(other.errors)
+        self.timeouts.update(other.timeouts)
+        self.retransmissions.update(other.retransmissions)
+        self.client_duplicates += other.client_duplicates
+        self.notifications += other.notifications
+        self.notify_lags_s.extend(other.notify_lags_s)
+
+    def report(self, duration_s, out=sys.stdout):
+        def ms(value):
+            return '%9.2f' % (value * 1000.0,)
+
+        out.write('%-8s %7s %9s %9s %9s %9s %9s %6s %8s %7s\n'
+                  % ('op', 'sent', 'p50 [ms]', 'p90 [ms]', 'p99 [ms]',
+                     'p99.9', 'max', 'errors', 'timeouts', 'retx'))
+        for op in OPERATIONS:
+            if not self.sent[op]:
+                continue
+            latencies = sorted(self.latencies_s[op])
+            out.write('%-8s %7d %s %s %s %s %s %6d %8d %7d\n'
+                      % (op, self.sent[op],
+                         ms(percentile(latencies, 0.5)),
+                         ms(percentile(latencies, 0.9)),
+                         ms(percentile(latencies, 0.99)),
+                         ms(percentile(latencies, 0.999)),
+                         ms(latencies[-1] if latencies else float('nan')),
+                         self.errors[op], self.timeouts[op],
+                         self.retransmissions[op]))
+
+        total_sent = sum(self.sent.values())
+        out.write('\nrequests: %d (%.1f/s)\n'
+                  % (total_sent, total_sent / duration_s if duration_s else 0.0))
+        out.write('client retransmissions: %d\n' % (self.client_duplicates,))
+        out.write('notifications: %d\n' % (self.notifications,))
+        if self.notify_lags_s:
+            lags = sorted(self.notify_lags_s)
+            out.write('notification lag [ms]: p50 %s, p90 %s, p99 %s, max %s\n'
+                      % tuple(ms(value).strip() for value in
+                              (percentile(lags, 0.5), percentile(lags, 0.9),
+                               percentile(lags, 0.99), lags[-1])))
+
+
+class PendingRequest:
+    def __init__(self, op, pkt, now):
+        self.op = op
+        self.pkt = pkt
+        self.first_sent = now
+        self.timeout_s = ACK_TIMEOUT_S * random.uniform(1.0, ACK_RANDOM_FACTOR)
+        self.next_retransmission = now + self.timeout_s
+        self.retransmissions = 0
+
+
+class Endpoint:
+    def __init__(self, args, index):
+        self.args = args
+        self.name = '%s-%d' % (args.endpoint_prefix, index)
+        self.stats = Stats()
+        self.pending = {}
+        self.recent_msg_ids = collections.OrderedDict()
+        self.observe_token = os.urandom(8)
+        self.unnotified_changes = []
+        self.counter = 0
+
+        if args.psk_identity is not None:
+            server = coap.DtlsServer(psk_identity=args.psk_identity.encode(),
+                                     psk_key=args.psk_key.encode())
+            protocol = 'coaps'
+        else:
+            server = coap.Server()
+            protocol = 'coap'
+        self.serv = Lwm2mServer(server)
+
+        demo_args = [args.client,
+                     '--endpoint-name', self.name,
+                     '--security-mode', server.security_mode(),
+                     '--server-uri', '%s://127.0.0.1:%d'
+                     % (protocol, self.serv.get_listen_port())]
+        if args.psk_identity is not None:
+            demo_args += [
+                '--identity', binascii.hexlify(args.psk_identity.encode()).decode(),
+                '--key', binascii.hexlify(args.psk_key.encode()).decode()]
+        demo_args += args.client_arg
+
+        log_path = os.path.join(args.logs_path, self.name + '.log')
+        self.log_write = open(log_path, 'wb')
+        self.log_read = open(log_path, 'rb', buffering=0)
+        self.process = subprocess.Popen(demo_args, stdin=subprocess.PIPE,
+                                        stdout=self.log_write,
+                                        stderr=self.log_write)
+        if read_until_match(self.log_read,
+                            regex=re.escape('*** ANJAY DEMO STARTUP FINISHED ***'),
+                            timeout_s=30) is None:
+            raise RuntimeError('%s: demo did not start in time' % (self.name,))
+
+    def send_request(self, op, pkt, now):
+        self.serv.send(pkt)
+        self.pending[pkt.msg_id] = PendingRequest(op, pkt, now)
+        self.stats.sent[op] += 1
+
+    def make_request(self, op):
+        if op == 'read':
+            return Lwm2mRead(self.args.read_path)
+        elif op == 'write':
+            self.counter += 1
+            return Lwm2mWrite(self.args.write_path, str(self.counter))
+        elif op == 'observe':
+            # re-sending an Observe with the same token refreshes the existing
+            # observation instead of creating a new one
+            return Lwm2mObserve(self.args.observe_path,
+                                token=self.observe_token)
+        else:
+            return Lwm2mExecute(self.args.execute_path)
+
+    def is_duplicate(self, msg_id):
+        if msg_id in self.recent_msg_ids:
+            return True
+        self.recent_msg_ids[msg_id] = None
+        if len(self.recent_msg_ids) > RECENT_MSG_IDS:
+            self.recent_msg_ids.popitem(last=False)
+        return False
+
+    def handle_response(self, pkt, now):
+        request = self.pending.pop(pkt.msg_id)
+        self.stats.latencies_s[request.op].append(now - request.first_sent)
+        if pkt.code.cls != 2:
+            self.stats.errors[request.op] += 1
+        elif request.op in MODIFYING_OPERATIONS:
+            self.unnotified_changes.append(now)
+
+    def handle_client_message(self, pkt, now):
+        if pkt.type == coap.Type.CONFIRMABLE and self.is_duplicate(pkt.msg_id):
+            self.stats.client_duplicates += 1
+            # our response might have been lost; responding again is harmless
+            # for everything the demo sends
+            duplicate = True
+        else:
+            duplicate = False
+
+        if isinstance(pkt, Lwm2mRegister):
+            self.serv.send(Lwm2mCreated.matching(pkt)(location='/rd/demo'))
+        elif isinstance(pkt, Lwm2mUpdate):
+            self.serv.send(Lwm2mChanged.matching(pkt)())
+        elif isinstance(pkt, Lwm2mDeregister):
+            self.serv.send(Lwm2mDeleted.matching(pkt)())
+        elif isinstance(pkt, Lwm2mNotify) and pkt.token == self.observe_token:
+            if pkt.type == coap.Type.CONFIRMABLE:
+                self.serv.send(Lwm2mEmpty.matching(pkt)())
+            if not duplicate:
+                self.stats.notifications += 1
+                if self.unnotified_changes:
+                    self.stats.notify_lags_s.append(now - self.unnotified_changes[0])
+                    self.unnotified_changes = []
+        elif pkt.type == coap.Type.CONFIRMABLE:
+            self.serv.send(Lwm2mReset(msg_id=pkt.msg_id))
+
+    def handle_incoming(self, timeout_s):
+        try:
+            pkt = self.serv.recv(timeout_s=max(timeout_s, 0.001))
+        except socket.timeout:
+            return
+        now = time.monotonic()
+        if (pkt.type in (coap.Type.ACKNOWLEDGEMENT, coap.Type.RESET)
+                and pkt.msg_id in self.pending):
+            self.handle_response(pkt, now)
+        elif pkt.type in (coap.Type.CONFIRMABLE, coap.Type.NON_CONFIRMABLE):
+            self.handle_client_message(pkt, now)
+
+    def handle_retransmissions(self, now):
+        for msg_id, request in list(self.pending.items()):
+            if now < request.next_retransmission:
+                continue
+            if request.retransmissions >= MAX_RETRANSMIT:
+                del self.pending[msg_id]
+                self.stats.timeouts[request.op] += 1
+                continue
+            self.serv.send(request.pkt)
+            request.retransmissions += 1
+            request.timeout_s *= 2
+            request.next_retransmission = now + request.timeout_s
+            self.stats.retransmissions[request.op] += 1
+
+    def wait_for_registration(self, timeout_s=30):
+        deadline = time.monotonic() + timeout_s
+        while time.monotonic() < deadline:
+            try:
+                pkt = self.serv.recv(timeout_s=deadline - time.monotonic())
+            except socket.timeout:
+                break
+            self.handle_client_message(pkt, time.monotonic())
+            if isinstance(pkt, Lwm2mRegister):
+                return
+        raise RuntimeError('%s: demo did not register in time' % (self.name,))
+
+    def call(self, pkt, timeout_s=10):
+        self.serv.send(pkt)
+        deadline = time.monotonic() + timeout_s
+        while time.monotonic() < deadline:
+            try:
+                res = self.serv.recv(timeout_s=deadline - time.monotonic())
+            except socket.timeout:
+                break
+            if res.type == coap.Type.ACKNOWLEDGEMENT and res.msg_id == pkt.msg_id:
+                return res
+            self.handle_client_message(res, time.monotonic())
+        raise RuntimeError('%s: no response to %s' % (self.name, pkt.summary()))
+
+    def run(self, rate_per_s, mix, start, duration_s):
+        ops = list(mix.keys())
+        weights = list(mix.values())
+        interval_s = 1.0 / rate_per_s
+        deadline = start + duration_s
+        # even with all endpoints starting at the same moment, do not send
+        # their requests in lockstep
+        next_send = start + random.uniform(0, interval_s)
+        drain_deadline = deadline + ACK_TIMEOUT_S * ACK_RANDOM_FACTOR * (2 ** (MAX_RETRANSMIT + 1))
+
+        while True:
+            now = time.monotonic()
+            if now >= drain_deadline or (now >= deadline and not self.pending):
+                break
+            while now >= next_send and next_send < deadline:
+                op = random.choices(ops, weights)[0]
+                self.send_request(op, self.make_request(op), now)
+                next_send += interval_s
+            self.handle_retransmissions(now)
+
+            wake_up = [drain_deadline]
+            if next_send < deadline:
+                wake_up.append(next_send)
+            wake_up.extend(request.next_retransmission
+                           for request in self.pending.values())
+            self.handle_incoming(min(wake_up) - now)
+
+        for request in self.pending.values():
+            self.stats.timeouts[request.op] += 1
+        self.pending.clear()
+
+    def shutdown(self, timeout_s=5):
+        try:
+            # Ctrl+D on the demo command line; the demo deregisters and quits
+            self.process.stdin.close()
+            deadline = time.monotonic() + timeout_s
+            while self.process.poll() is None and time.monotonic() < deadline:
+                self.handle_incoming(0.1)
+        except Exception:
+            pass
+        if self.process.poll() is None:
+            self.process.terminate()
+            try:
+                self.process.wait(timeout_s)
+            except subprocess.TimeoutExpired:
+                self.process.kill()
+                self.process.wait()
+        self.serv.close()
+        self.log_read.close()
+        self.log_write.close()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--client', '-c', required=True,
+                        help='Path to the demo executable.')
+    parser.add_argument('--client-arg', action='append', default=[],
+                        help='Additional argument to pass to each demo process. '
+                             'May be given multiple times.')
+    parser.add_argument('--endpoints', '-n', type=int, default=1,
+                        help='Number of demo processes to run.')
+    parser.add_argument('--endpoint-prefix', default='urn:dev:os:anjay-loadgen',
+                        help='Endpoint names are this prefix followed by an index.')
+    parser.add_argument('--rate', '-r', type=float, default=10.0,
+                        help='Total number of requests per second, split evenly '
+                             'between all endpoints.')
+    parser.add_argument('--duration', '-d', type=float, default=30.0,
+                        help='Duration of the measurement in seconds.')
+    parser.add_argument('--mix', '-m', type=parse_mix,
+                        default=parse_mix('read=6,write=2,observe=1,execute=1'),
+                        help='Comma-separated relative weights of operations, '
+                             'e.g. read=6,write=2,observe=1,execute=1.')
+    parser.add_argument('--create', default='/1337',
+                        help='Object to create an Instance of before the '
+                             'measurement. Pass an empty string to skip.')
+    parser.add_argument('--read-path', default='/1337/1/1')
+    parser.add_argument('--write-path', default='/1337/1/1',
+                        help='Resource to write increasing integers to.')
+    parser.add_argument('--observe-path', default='/1337/1/1')
+    parser.add_argument('--execute-path', default='/1337/1/2')
+    parser.add_argument('--psk-identity',
+                        help='Use DTLS in PSK mode with this identity.')
+    parser.add_argument('--psk-key', help='PSK to use with --psk-identity.')
+    parser.add_argument('--logs-path', default='loadgen-logs',
+                        help='Directory to store the demo output in.')
+    parser.add_argument('--seed', type=int, help='Seed for the operation mix.')
+    args = parser.parse_args()
+
+    if (args.psk_identity is None) != (args.psk_key is None):
+        parser.error('--psk-identity and --psk-key must be used together')
+    if args.endpoints < 1 or args.rate <= 0 or args.duration <= 0:
+        parser.error('--endpoints, --rate and --duration must be positive')
+    if args.seed is not None:
+        random.seed(args.seed)
+    os.makedirs(args.logs_path, exist_ok=True)
+
+    endpoints = []
+    try:
+        for index in range(args.endpoints):
+            endpoint = Endpoint(args, index)
+            endpoints.append(endpoint)
+            endpoint.wait_for_registration()
+            if args.create:
+                endpoint.call(Lwm2mCreate(args.create))
+            if args.mix.get('observe', 0) > 0:
+                endpoint.call(Lwm2mObserve(args.observe_path,
+                                           token=endpoint.observe_token))
+
+        start = time.monotonic() + 0.1
+        threads = [threading.Thread(target=endpoint.run,
+                                    args=(args.rate / args.endpoints,
+                                          args.mix, start, args.duration))
+                   for endpoint in endpoints]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+    finally:
+        for endpoint in endpoints:
+            endpoint.shutdown()
+
+    total = Stats()
+    for endpoint in endpoints:
+        total.merge(endpoint.stats)
+    total.report(args.duration)
+
+
+if __name__ == '__main__':
+    main()
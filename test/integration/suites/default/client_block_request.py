@@ -445,14 +445,14 @@ class UnexpectedServerRequestWhileBlockRequestInProgress(ClientBlockRequest.Test
         block_opt = block_req.get_options(coap.Option.BLOCK1)[0]
         block_res = Lwm2mContinue.matching(block_req)(options=[block_opt])
 
-        # send an unrelated request during a block-wise transfer
+        # send an unrelated request during a block-wise transfer; it should
+        # be handled after the transfer finishes
         req = Lwm2mRead('/3/0/0')
         self.serv.send(req)
-        res = self.serv.recv()
-        self.assertMsgEqual(Lwm2mErrorResponse.matching(req)(coap.Code.RES_SERVICE_UNAVAILABLE),
-                            res)
-        self.assertEqual(1, len(res.get_options(coap.Option.MAX_AGE)))
+        with self.assertRaises(socket.timeout, msg='unexpected message'):
+            print(self.serv.recv(timeout_s=1))
 
         # continue block-wise request
         self.serv.send(block_res)
         self.block_recv(seq_num_begin=(self.expected_num_blocks // 2 + 1))
+        self.assertMsgEqual(Lwm2mContent.matching(req)(), self.serv.recv())
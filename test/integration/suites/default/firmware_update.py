@@ -54,8 +54,11 @@ class FirmwareUpdate:
 
         def setUp(self):
             self.ANJAY_MARKER_FILE = generate_temp_filename(dir='/tmp', prefix='anjay-fw-updated-')
+            self.ANJAY_DOWNLOAD_STATE_FILE = generate_temp_filename(dir='/tmp', prefix='anjay-fw-download-state-')
             self.FIRMWARE_SCRIPT_CONTENT = (FIRMWARE_SCRIPT_TEMPLATE % self.ANJAY_MARKER_FILE).encode('ascii')
-            super().setUp(extra_cmdline_args=['--fw-updated-marker-path', self.ANJAY_MARKER_FILE])
+            self.demo_extra_args = ['--fw-updated-marker-path', self.ANJAY_MARKER_FILE,
+                                    '--fw-download-state-path', self.ANJAY_DOWNLOAD_STATE_FILE]
+            super().setUp(extra_cmdline_args=self.demo_extra_args)
 
         def tearDown(self):
             check_marker = getattr(self, 'check_marker', False)
@@ -73,11 +76,24 @@ class FirmwareUpdate:
                     # no deregistration here, demo already terminated
                     super().tearDown(auto_deregister=getattr(self, 'auto_deregister', True))
                 finally:
+                    if os.path.isfile(self.ANJAY_DOWNLOAD_STATE_FILE):
+                        os.unlink(self.ANJAY_DOWNLOAD_STATE_FILE)
                     if check_marker:
                         with open(self.ANJAY_MARKER_FILE, "rb") as f:
                             line = f.readline()[:-1]
                             self.assertEqual(line, b"updated")
 
+        def restart_demo(self):
+            # simulate power loss: no deregistration, no cleanup
+            self.demo_process.kill()
+            self.demo_process.wait()
+            self.demo_process.log_file.close()
+            self.demo_process.log_file_write.close()
+
+            self.serv.reset()
+            self._start_demo(self.make_demo_args(self.servers) + self.demo_extra_args)
+            self.assertDemoRegisters(self.serv)
+
         def read_update_result(self, timeout_s=1):
             req = Lwm2mRead('/5/0/5')
             self.serv.send(req)
@@ -100,6 +116,9 @@ class FirmwareUpdate:
             self.assertMsgEqual(Lwm2mChanged.matching(req)(),
                                 self.serv.recv(timeout_s=write_timeout_s))
 
+            self.wait_for_download(read_timeout_s=read_timeout_s, download_timeout_s=download_timeout_s)
+
+        def wait_for_download(self, read_timeout_s=1, download_timeout_s=10):
             # wait until client downloads the firmware
             deadline = time.time() + download_timeout_s
             while time.time() < deadline:
@@ -111,6 +130,12 @@ class FirmwareUpdate:
             self.fail('firmware still not downloaded')
 
     class TestWithHttpServer(Test):
+        # if True, the server supports persistent connections
+        HTTP_KEEP_ALIVE = False
+        # if True, the server closes the connection after each response without announcing it,
+        # as it would after its keep-alive timeout expired
+        HTTP_CLOSE_AFTER_RESPONSE = False
+
         def get_firmware_uri(self):
             return 'http://127.0.0.1:%d%s' % (self.http_server.server_address[1], FIRMWARE_PATH)
 
@@ -124,13 +149,7 @@ class FirmwareUpdate:
             test_case = self
 
             class FirmwareRequestHandler(http.server.BaseHTTPRequestHandler):
-                def do_GET(self):
-                    test_case.requests.append(self.path)
-
-                    self.send_response(http.HTTPStatus.OK)
-                    self.send_header('Content-type', 'text/plain')
-                    self.end_headers()
-
+                def wait_for_response_content(self):
                     # This condition variable makes it possible to defer sending the response.
                     # FirmwareUpdateStateChangeTest uses it to ensure demo has enough time
                     # to send the interim "Downloading" state notification.
@@ -139,19 +158,45 @@ class FirmwareUpdate:
                             test_case._response_cv.wait()
                         response_content = test_case._response_content
                         test_case._response_content = None
+                    return response_content
+
+                def do_GET(self):
+                    test_case.requests.append(self.path)
+                    test_case.connections.append(self.client_address)
+
+                    if test_case.HTTP_KEEP_ALIVE:
+                        # persistent connections require Content-Length to be known upfront
+                        response_content = self.wait_for_response_content()
+                        self.send_response(http.HTTPStatus.OK)
+                        self.send_header('Content-type', 'text/plain')
+                        self.send_header('Content-Length', str(len(response_content)))
+                        self.end_headers()
+                    else:
+                        self.send_response(http.HTTPStatus.OK)
+                        self.send_header('Content-type', 'text/plain')
+                        self.end_headers()
+                        response_content = self.wait_for_response_content()
 
                     self.wfile.write(response_content)
+                    if test_case.HTTP_CLOSE_AFTER_RESPONSE:
+                        self.close_connection = True
 
                 def log_request(code='-', size='-'):
                     # don't display logs on successful request
                     pass
 
+            if self.HTTP_KEEP_ALIVE:
+                FirmwareRequestHandler.protocol_version = 'HTTP/1.1'
+                # connections kept open by the client must not block other requests
+                return http.server.ThreadingHTTPServer(('', 0), FirmwareRequestHandler)
             return http.server.HTTPServer(('', 0), FirmwareRequestHandler)
 
         def setUp(self):
             super().setUp()
 
             self.requests = []
+            self.expected_requests = [FIRMWARE_PATH]
+            self.connections = []
             self._response_content = None
             self._response_cv = threading.Condition()
 
@@ -167,8 +212,8 @@ class FirmwareUpdate:
                 self.http_server.shutdown()
                 self.server_thread.join()
 
-            # there should be exactly one request
-            self.assertEqual(['/firmware'], self.requests)
+            # there should be exactly one request, unless the test expects otherwise
+            self.assertEqual(self.expected_requests, self.requests)
 
     class TestWithHttpsServer(TestWithHttpServer):
         def get_firmware_uri(self):
@@ -228,6 +273,46 @@ class FirmwareUpdate:
             finally:
                 self.server_thread.join()
 
+    class TestWithFlakyCoapServer(TestWithCoapServer):
+        """
+        Drops first attempts of some block requests and, while stall_at_block
+        is set, ignores all requests for that block and any further ones. The
+        first request for reset_at_block is answered with a Reset, as if the
+        server lost track of the transfer after the link dropped.
+        """
+        def setUp(self):
+            super().setUp()
+            self.stall_at_block = None
+            self.reset_at_block = None
+            self.file_server.should_ignore_request = self._should_ignore_request
+
+        def _should_ignore_request(self, req):
+            try:
+                seq_num = get_block2_seq_num(req)
+            except:
+                return False
+
+            if self.reset_at_block is not None and seq_num == self.reset_at_block:
+                self.reset_at_block = None
+                self.file_server.send_reset(req)
+                return True
+            if self.stall_at_block is not None and seq_num >= self.stall_at_block:
+                return True
+            num_attempts = len([x for x in self.file_server.requests if x == req])
+            return seq_num % 4 == 3 and num_attempts < 2
+
+        def wait_for_block_request(self, seq_num, timeout_s=30):
+            deadline = time.time() + timeout_s
+            while time.time() < deadline:
+                if any(get_block2_seq_num(req) == seq_num for req in list(self.file_server.requests)):
+                    return
+                time.sleep(0.1)
+            self.fail('block %d not requested' % (seq_num,))
+
+
+def get_block2_seq_num(req):
+    return req.get_options(coap.Option.BLOCK2)[0].seq_num()
+
 
 class FirmwareUpdatePackageTest(FirmwareUpdate.Test):
     def setUp(self):
@@ -452,6 +537,38 @@ class FirmwareUpdateHttpsTest(FirmwareUpdate.TestWithHttpsServer):
                             self.serv.recv(timeout_s=1))
 
 
+class FirmwareUpdateHttpsKeepAliveTest(FirmwareUpdate.TestWithHttpsServer):
+    HTTP_KEEP_ALIVE = True
+
+    def download_twice(self):
+        for _ in range(2):
+            self.provide_response()
+            self.write_firmware_and_wait_for_download(self.get_firmware_uri(), read_timeout_s=10,
+                                                      download_timeout_s=20)
+
+            # reset the state machine so that the same URI can be written again
+            req = Lwm2mWrite('/5/0/1', '')
+            self.serv.send(req)
+            self.assertMsgEqual(Lwm2mChanged.matching(req)(), self.serv.recv(timeout_s=1))
+            self.assertEqual(UPDATE_STATE_IDLE, self.read_state())
+
+        self.expected_requests = [FIRMWARE_PATH] * 2
+
+    def runTest(self):
+        self.download_twice()
+        # the second download reused the TLS connection of the first one
+        self.assertEqual(1, len(set(self.connections)))
+
+
+class FirmwareUpdateHttpsKeepAliveClosedByServerTest(FirmwareUpdateHttpsKeepAliveTest):
+    HTTP_CLOSE_AFTER_RESPONSE = True
+
+    def runTest(self):
+        self.download_twice()
+        # the second download failed on the closed connection and was retried on a new one
+        self.assertEqual(2, len(set(self.connections)))
+
+
 class FirmwareUpdateResetInIdleState(FirmwareUpdate.Test):
     def runTest(self):
         self.assertEqual(UPDATE_STATE_IDLE, self.read_state())
@@ -484,3 +601,86 @@ class FirmwareUpdateCoapUri(FirmwareUpdate.TestWithCoapServer):
     def runTest(self):
         self.file_server.set_resource('/firmware', make_firmware_package(self.FIRMWARE_SCRIPT_CONTENT))
         self.write_firmware_and_wait_for_download(self.file_server.get_resource_uri('/firmware'))
+
+
+class FirmwareUpdateCoapResumeAfterRestart(FirmwareUpdate.TestWithFlakyCoapServer):
+    def runTest(self):
+        # large enough to span multiple 1024-byte blocks
+        package = make_firmware_package(self.FIRMWARE_SCRIPT_CONTENT + b'#' * 8192 + b'\n')
+        self.file_server.set_resource('/firmware', package)
+
+        self.stall_at_block = 4
+        req = Lwm2mWrite('/5/0/1', self.file_server.get_resource_uri('/firmware'))
+        self.serv.send(req)
+        self.assertMsgEqual(Lwm2mChanged.matching(req)(), self.serv.recv(timeout_s=1))
+
+        # blocks 0-3 are downloaded and persisted at this point
+        self.wait_for_block_request(4)
+        self.restart_demo()
+
+        requests_before_restart = len(self.file_server.requests)
+        self.stall_at_block = None
+        self.wait_for_download(download_timeout_s=30)
+
+        # download resumed from where it was interrupted
+        resumed_requests = self.file_server.requests[requests_before_restart:]
+        self.assertNotEqual([], resumed_requests)
+        self.assertTrue(all(get_block2_seq_num(req) >= 4 for req in resumed_requests))
+
+
+class FirmwareUpdateCoapResumeAfterConnectionLoss(FirmwareUpdate.TestWithFlakyCoapServer):
+    def runTest(self):
+        package = make_firmware_package(self.FIRMWARE_SCRIPT_CONTENT + b'#' * 8192 + b'\n')
+        self.file_server.set_resource('/firmware', package)
+        firmware_uri = self.file_server.get_resource_uri('/firmware')
+
+        self.reset_at_block = 4
+        req = Lwm2mWrite('/5/0/1', firmware_uri)
+        self.serv.send(req)
+        self.assertMsgEqual(Lwm2mChanged.matching(req)(), self.serv.recv(timeout_s=1))
+
+        # blocks 0-3 are downloaded and persisted, then the transfer fails;
+        # the demo keeps running
+        deadline = time.time() + 30
+        while self.read_update_result() != UPDATE_RESULT_CONNECTION_LOST:
+            if time.time() > deadline:
+                self.fail('download not interrupted')
+            time.sleep(0.5)
+        self.assertEqual(UPDATE_STATE_IDLE, self.read_state())
+
+        # writing the same URI again resumes the download from the stored offset
+        requests_before_resume = len(self.file_server.requests)
+        self.write_firmware_and_wait_for_download(firmware_uri, download_timeout_s=30)
+
+        resumed_requests = self.file_server.requests[requests_before_resume:]
+        self.assertNotEqual([], resumed_requests)
+        self.assertEqual(4, get_block2_seq_num(resumed_requests[0]))
+        self.assertTrue(all(get_block2_seq_num(req) >= 4 for req in resumed_requests))
+
+
+class FirmwareUpdateCoapRestartOnETagMismatch(FirmwareUpdate.TestWithFlakyCoapServer):
+    def runTest(self):
+        package = make_firmware_package(self.FIRMWARE_SCRIPT_CONTENT + b'#' * 8192 + b'\n')
+        self.file_server.set_resource('/firmware', package)
+
+        self.stall_at_block = 4
+        req = Lwm2mWrite('/5/0/1', self.file_server.get_resource_uri('/firmware'))
+        self.serv.send(req)
+        self.assertMsgEqual(Lwm2mChanged.matching(req)(), self.serv.recv(timeout_s=1))
+
+        self.wait_for_block_request(4)
+
+        # package replaced while the client is down - new ETag
+        new_package = make_firmware_package(self.FIRMWARE_SCRIPT_CONTENT + b'@' * 8192 + b'\n')
+        self.file_server.set_resource('/firmware', new_package)
+        self.restart_demo()
+
+        requests_before_restart = len(self.file_server.requests)
+        self.stall_at_block = None
+        self.wait_for_download(download_timeout_s=30)
+
+        # client attempted to resume, noticed the ETag change and started over;
+        # CRC of the new package was verified, as the state is Downloaded
+        resumed_requests = self.file_server.requests[requests_before_restart:]
+        self.assertEqual(4, get_block2_seq_num(resumed_requests[0]))
+        self.assertIn(0, [get_block2_seq_num(req) for req in resumed_requests])
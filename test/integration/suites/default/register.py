@@ -130,10 +130,11 @@ class ConcurrentRequestWhileWaitingForResponse(Register.TestCase):
                           content=expected_content),
             pkt)
 
+        # the request should be handled after the Register exchange finishes
         req = Lwm2mRead('/3/0/0')
         self.serv.send(req)
-        self.assertMsgEqual(Lwm2mErrorResponse.matching(req)(code=coap.Code.RES_SERVICE_UNAVAILABLE,
-                                                             options=ANY),
-                            self.serv.recv())
+        with self.assertRaises(socket.timeout, msg='unexpected message'):
+            print(self.serv.recv(timeout_s=1))
 
         self.serv.send(Lwm2mCreated.matching(pkt)(location='/rd/demo'))
+        self.assertMsgEqual(Lwm2mContent.matching(req)(), self.serv.recv())
@@ -0,0 +1,55 @@
+# -*- coding: utf-8 -*-
+#
+# Copyright 2017 AVSystem <avsystem@avsystem.com>
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+from framework.lwm2m_test import *
+
+
+class ServerStatsRttSamplesTest(test_suite.Lwm2mSingleServerTest):
+    def rtt_samples(self):
+        return int(self.communicate('server-stats 1',
+                                    match_regex='RTT_SAMPLES==([0-9]+)\n').group(1))
+
+    def runTest(self):
+        self.serv.set_timeout(timeout_s=1)
+
+        # Register has been answered on first attempt
+        self.assertEqual(1, self.rtt_samples())
+
+        # Update answered on first attempt - another sample
+        self.communicate('send-update')
+        pkt = self.serv.recv()
+        self.assertMsgEqual(Lwm2mUpdate(self.DEFAULT_REGISTER_ENDPOINT,
+                                        query=[],
+                                        content=b''),
+                            pkt)
+        self.serv.send(Lwm2mChanged.matching(pkt)())
+        self.assertEqual(2, self.rtt_samples())
+
+        # Update answered only after a retransmission - RTT is ambiguous, so
+        # no sample is taken
+        self.communicate('send-update')
+        pkt = self.serv.recv()
+        self.assertMsgEqual(Lwm2mUpdate(self.DEFAULT_REGISTER_ENDPOINT,
+                                        query=[],
+                                        content=b''),
+                            pkt)
+        pkt = self.serv.recv(timeout_s=5)
+        self.assertMsgEqual(Lwm2mUpdate(self.DEFAULT_REGISTER_ENDPOINT,
+                                        query=[],
+                                        content=b''),
+                            pkt)
+        self.serv.send(Lwm2mChanged.matching(pkt)())
+        self.assertEqual(2, self.rtt_samples())
@@ -290,6 +290,35 @@ class ConcurrentRequestWhileWaitingForResponse(test_suite.Lwm2mSingleServerTest)
                                         content=b''),
                             pkt)
 
+        # the request should be handled after the Update exchange finishes
+        req = Lwm2mRead('/3/0/0')
+        self.serv.send(req)
+        with self.assertRaises(socket.timeout, msg='unexpected message'):
+            print(self.serv.recv(timeout_s=1))
+
+        self.serv.send(Lwm2mChanged.matching(pkt)())
+        self.assertMsgEqual(Lwm2mContent.matching(req)(), self.serv.recv())
+
+
+class ConcurrentRequestsOverflowWhileWaitingForResponse(test_suite.Lwm2mSingleServerTest):
+    MAX_DEFERRED_REQUESTS = 4
+
+    def runTest(self):
+        self.communicate('send-update')
+
+        pkt = self.serv.recv()
+        self.assertMsgEqual(Lwm2mUpdate(self.DEFAULT_REGISTER_ENDPOINT,
+                                        query=[],
+                                        content=b''),
+                            pkt)
+
+        deferred_reqs = []
+        for _ in range(self.MAX_DEFERRED_REQUESTS):
+            req = Lwm2mRead('/3/0/0')
+            self.serv.send(req)
+            deferred_reqs.append(req)
+
+        # requests that do not fit in the queue are still rejected
         req = Lwm2mRead('/3/0/0')
         self.serv.send(req)
         self.assertMsgEqual(Lwm2mErrorResponse.matching(req)(code=coap.Code.RES_SERVICE_UNAVAILABLE,
@@ -297,6 +326,8 @@ class ConcurrentRequestWhileWaitingForResponse(test_suite.Lwm2mSingleServerTest)
                             self.serv.recv())
 
         self.serv.send(Lwm2mChanged.matching(pkt)())
+        for req in deferred_reqs:
+            self.assertMsgEqual(Lwm2mContent.matching(req)(), self.serv.recv())
 
 
 class UpdateAfterLifetimeChange(test_suite.Lwm2mSingleServerTest):
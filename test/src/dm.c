@@ -28,6 +28,7 @@
 #define ANJAY_SERVERS_INTERNALS
 #include "../../src/servers/connection_info.h"
 #include "../../src/servers/servers_internal.h"
+#include "../../src/servers/socket_map.h"
 #undef ANJAY_SERVERS_INTERNALS
 
 anjay_t *_anjay_test_dm_init(const anjay_configuration_t *config) {
@@ -57,6 +58,12 @@ avs_net_abstract_socket_t *_anjay_test_dm_install_socket(anjay_t *anjay,
     avs_unit_mocksock_expect_connect(socket, "", "");
     AVS_UNIT_ASSERT_SUCCESS(avs_net_socket_connect(socket, "", ""));
     anjay->servers.active->udp_connection.conn_priv_data_.socket = socket;
+    AVS_UNIT_ASSERT_SUCCESS(_anjay_socket_map_insert(
+            &anjay->server_sockets, socket,
+            (anjay_connection_ref_t) {
+                .server = anjay->servers.active,
+                .conn_type = ANJAY_CONNECTION_UDP
+            }));
     anjay->servers.active->registration_info.expire_time.since_monotonic_epoch.seconds = INT64_MAX;
     return _anjay_connection_internal_get_socket(
             &anjay->servers.active->udp_connection);
@@ -98,6 +98,8 @@ void _anjay_mock_dm_assert_common_attributes_equal(
         const anjay_dm_internal_attrs_t *a,
         const anjay_dm_internal_attrs_t *b) {
     AVS_UNIT_ASSERT_FIELD_EQUAL(a, b, custom.data.con);
+    AVS_UNIT_ASSERT_FIELD_EQUAL(a, b, custom.data.min_eval_period);
+    AVS_UNIT_ASSERT_FIELD_EQUAL(a, b, custom.data.max_eval_period);
     AVS_UNIT_ASSERT_FIELD_EQUAL(a, b, standard.min_period);
     AVS_UNIT_ASSERT_FIELD_EQUAL(a, b, standard.max_period);
 }